@@ -0,0 +1,158 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dali/pipeline/util/spsc_ring.h"
+
+namespace dali {
+
+namespace {
+
+using Batch = std::vector<std::unique_ptr<int>>;
+
+/**
+ * @brief Mutex and condition variable based queue, as previously used by DataReader
+ */
+class LockedBatchQueue {
+ public:
+  explicit LockedBatchQueue(int depth) : depth_(depth), slots_(depth) {}
+
+  bool AcquireWrite() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    producer_.wait(lock, [&]() { return stopped_ || !Full(); });
+    return !stopped_;
+  }
+
+  Batch &WriteSlot() { return slots_[producer_idx_]; }
+
+  void CommitWrite() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Advance(producer_idx_, producer_cycle_);
+    }
+    consumer_.notify_all();
+  }
+
+  bool AcquireRead() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    consumer_.wait(lock, [&]() { return stopped_ || !Empty(); });
+    return !Empty();
+  }
+
+  Batch &ReadSlot() { return slots_[consumer_idx_]; }
+
+  void ReleaseRead() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Advance(consumer_idx_, consumer_cycle_);
+    }
+    producer_.notify_one();
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    producer_.notify_all();
+    consumer_.notify_all();
+  }
+
+ private:
+  void Advance(int &index, bool &cycle) {
+    index = (index + 1) % depth_;
+    if (index == 0) cycle = !cycle;
+  }
+
+  bool Empty() const {
+    return producer_idx_ == consumer_idx_ && producer_cycle_ == consumer_cycle_;
+  }
+
+  bool Full() const {
+    return producer_idx_ == consumer_idx_ && producer_cycle_ != consumer_cycle_;
+  }
+
+  int depth_;
+  std::vector<Batch> slots_;
+  int producer_idx_ = 0, consumer_idx_ = 0;
+  bool producer_cycle_ = false, consumer_cycle_ = false;
+  bool stopped_ = false;
+  std::mutex mutex_;
+  std::condition_variable producer_, consumer_;
+};
+
+template <typename Queue>
+void RunHandoff(benchmark::State &st, Queue &queue, int batch_size) {
+  std::thread producer([&]() {
+    while (queue.AcquireWrite()) {
+      auto &batch = queue.WriteSlot();
+      batch.resize(batch_size);
+      for (auto &sample : batch) {
+        if (!sample)
+          sample.reset(new int(0));
+      }
+      queue.CommitWrite();
+    }
+  });
+
+  for (auto _ : st) {
+    queue.AcquireRead();
+    auto &batch = queue.ReadSlot();
+    benchmark::DoNotOptimize(batch.data());
+    queue.ReleaseRead();
+  }
+
+  queue.Stop();
+  producer.join();
+  st.counters["batches/s"] = benchmark::Counter(st.iterations(), benchmark::Counter::kIsRate);
+}
+
+void HandoffArgs(benchmark::internal::Benchmark *b) {
+  for (int depth : {1, 2, 4}) {
+    for (int batch_size : {1, 32}) {
+      b->Args({depth, batch_size});
+    }
+  }
+}
+
+}  // namespace
+
+static void BM_BatchHandoffLocked(benchmark::State &st) {
+  LockedBatchQueue queue(st.range(0));
+  RunHandoff(st, queue, st.range(1));
+}
+
+BENCHMARK(BM_BatchHandoffLocked)->Apply(HandoffArgs)->UseRealTime();
+
+static void BM_BatchHandoffSPSCPark(benchmark::State &st) {
+  SPSCRing<Batch> queue(st.range(0), 0);
+  RunHandoff(st, queue, st.range(1));
+}
+
+BENCHMARK(BM_BatchHandoffSPSCPark)->Apply(HandoffArgs)->UseRealTime();
+
+static void BM_BatchHandoffSPSCSpin(benchmark::State &st) {
+  SPSCRing<Batch> queue(st.range(0), 1000);
+  RunHandoff(st, queue, st.range(1));
+}
+
+BENCHMARK(BM_BatchHandoffSPSCSpin)->Apply(HandoffArgs)->UseRealTime();
+
+}  // namespace dali
@@ -0,0 +1,149 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "dali/pipeline/operators/op_spec.h"
+#include "dali/pipeline/operators/reader/parser/caffe_parser.h"
+#include "dali/pipeline/operators/reader/parser/caffe2_parser.h"
+#include "dali/pipeline/workspace/host_workspace.h"
+#include "dali/pipeline/workspace/sample_workspace.h"
+
+namespace dali {
+
+namespace {
+
+std::string MakeImage(int image_size) {
+  std::string image(image_size, '\0');
+  for (int i = 0; i < image_size; i++)
+    image[i] = static_cast<char>(i * 7 + (i >> 9));
+  return image;
+}
+
+/// An encoded image with a label, as written by Caffe's convert_imageset
+std::string MakeDatum(int image_size) {
+  caffe::Datum datum;
+  datum.set_data(MakeImage(image_size));
+  datum.set_label(417);
+  datum.set_encoded(true);
+  return datum.SerializeAsString();
+}
+
+/// An encoded image, a single label and a bounding box, as in the Caffe2 image datasets
+std::string MakeTensorProtos(int image_size) {
+  caffe2::TensorProtos protos;
+  auto *image = protos.add_protos();
+  image->set_data_type(caffe2::TensorProto::STRING);
+  image->add_dims(1);
+  image->add_string_data(MakeImage(image_size));
+  auto *label = protos.add_protos();
+  label->set_data_type(caffe2::TensorProto::INT32);
+  label->add_dims(1);
+  label->add_int32_data(417);
+  auto *bbox = protos.add_protos();
+  bbox->set_data_type(caffe2::TensorProto::INT32);
+  bbox->add_dims(4);
+  for (int v : {10, 20, 100, 200})
+    bbox->add_int32_data(v);
+  return protos.SerializeAsString();
+}
+
+const std::string &ImageBytes(const caffe::Datum &datum) {
+  return datum.data();
+}
+
+const std::string &ImageBytes(const caffe2::TensorProtos &protos) {
+  return protos.protos(0).string_data(0);
+}
+
+/**
+ * @brief Parsing of a serialized record by `parser`, or with a new message for each
+ *        sample and the image copied out of it, as the Caffe and Caffe2 parsers used to do
+ *
+ * Args: image size in bytes, mode (0 - a new message per sample, 1 - the parser)
+ */
+template <typename Message, typename ParserType>
+void ParserBench(benchmark::State& st, const OpSpec &spec,  // NOLINT
+                 const std::string &record, int num_outputs) {
+  const int mode = st.range(1);
+  Tensor<CPUBackend> data;
+  data.set_pinned(false);
+  data.Resize({static_cast<Index>(record.size())});
+  std::memcpy(data.mutable_data<uint8_t>(), record.data(), record.size());
+
+  ParserType parser(spec);
+  parser.PrepareThreads(1);
+
+  HostWorkspace host_ws;
+  SampleWorkspace ws;
+  host_ws.GetSample(&ws, 0, 0);
+  for (int i = 0; i < num_outputs; i++) {
+    auto output = std::make_shared<Tensor<CPUBackend>>();
+    output->set_pinned(false);
+    ws.AddOutput(output);
+  }
+
+  for (auto _ : st) {
+    if (mode == 0) {
+      Message message;
+      DALI_ENFORCE(message.ParseFromArray(data.raw_data(), data.size()));
+      auto &image = ImageBytes(message);
+      auto &image_out = ws.Output<CPUBackend>(0);
+      image_out.Resize({static_cast<Index>(image.size())});
+      std::memcpy(image_out.mutable_data<uint8_t>(), image.data(), image.size());
+    } else {
+      parser.Parse(data, &ws);
+    }
+    benchmark::DoNotOptimize(ws.Output<CPUBackend>(0).raw_data());
+  }
+  st.SetBytesProcessed(st.iterations() * record.size());
+}
+
+void CaffeParserBench(benchmark::State& st) {  // NOLINT
+  ParserBench<caffe::Datum, CaffeParser>(st, OpSpec("CaffeReader"),
+                                         MakeDatum(st.range(0)), 2);
+}
+
+void Caffe2ParserBench(benchmark::State& st) {  // NOLINT
+  auto spec = OpSpec("Caffe2Reader")
+      .AddArg("additional_inputs", 0)
+      .AddArg("label_type", static_cast<int>(SINGLE_LABEL))
+      .AddArg("num_labels", 1);
+  ParserBench<caffe2::TensorProtos, Caffe2Parser>(st, spec, MakeTensorProtos(st.range(0)), 3);
+}
+
+void ParserArgs(benchmark::internal::Benchmark *b) {
+  for (int image_size : {16 << 10, 128 << 10, 1 << 20}) {
+    for (int mode = 0; mode < 2; mode++) {
+      b->Args({image_size, mode});
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(CaffeParserBench)
+->Apply(ParserArgs)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+BENCHMARK(Caffe2ParserBench)
+->Apply(ParserArgs)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+}  // namespace dali
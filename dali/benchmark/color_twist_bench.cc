@@ -0,0 +1,127 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+#include "dali/benchmark/operator_bench.h"
+#include "dali/benchmark/dali_bench.h"
+#include "dali/kernels/imgproc/color_twist_cpu.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Color twist kernel on a single HWC uint8 image
+ *
+ * Args: width, height, channels,
+ *       mode (0 - scalar, 1 - vectorized, 2 - vectorized in place,
+ *             3 - vectorized with normalized float output)
+ */
+void ColorTwistKernelCPUBench(benchmark::State& st) {  // NOLINT
+  const int W = st.range(0), H = st.range(1), C = st.range(2);
+  const int mode = st.range(3);
+  const int64_t num_pixels = static_cast<int64_t>(W) * H;
+
+  std::vector<uint8_t> in(num_pixels * C), out(num_pixels * C);
+  std::vector<float> out_float(num_pixels * C);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = static_cast<uint8_t>(i * 7 + (i >> 5));
+
+  kernels::ColorTwistParams params;
+  const float hue_sat[3][4] = {
+    { 0.85f, 0.12f, 0.03f, 4.0f },
+    { 0.05f, 0.90f, 0.05f, -2.0f },
+    { 0.02f, 0.15f, 0.83f, 1.0f }
+  };
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++)
+      params.matrix[i][j] = hue_sat[i][j];
+    params.mean[i] = 118.0f;
+    params.inv_stddev[i] = 1 / 58.0f;
+  }
+
+  for (auto _ : st) {
+    switch (mode) {
+      case 0:
+        kernels::ColorTwistScalar(out.data(), in.data(), num_pixels, C, params);
+        break;
+      case 1:
+        kernels::ColorTwist(out.data(), in.data(), num_pixels, C, params);
+        break;
+      case 2:
+        kernels::ColorTwist(in.data(), in.data(), num_pixels, C, params);
+        break;
+      default:
+        kernels::ColorTwist(out_float.data(), in.data(), num_pixels, C, params);
+        break;
+    }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::DoNotOptimize(in.data());
+    benchmark::DoNotOptimize(out_float.data());
+  }
+  st.SetBytesProcessed(st.iterations() * num_pixels * C);
+}
+
+}  // namespace
+
+BENCHMARK(ColorTwistKernelCPUBench)
+->Args({224, 224, 3, 0})
+->Args({224, 224, 3, 1})
+->Args({224, 224, 3, 2})
+->Args({224, 224, 3, 3})
+->Args({1920, 1080, 3, 0})
+->Args({1920, 1080, 3, 1})
+->Args({1920, 1080, 3, 2})
+->Args({1920, 1080, 3, 3})
+->Args({1920, 1080, 1, 0})
+->Args({1920, 1080, 1, 1})
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+static void ColorTwistCPUArgs(benchmark::internal::Benchmark *b) {
+  int batch_size = 8;
+  for (int H = 1000; H >= 250; H /= 2) {
+    int W = H, C = 3;
+    b->Args({batch_size, H, W, C});
+  }
+}
+
+BENCHMARK_DEFINE_F(OperatorBench, ColorTwistCPU)(benchmark::State& st) {
+  int batch_size = st.range(0);
+  int H = st.range(1);
+  int W = st.range(2);
+  int C = st.range(3);
+
+  this->RunCPU<uint8_t>(
+    st,
+    OpSpec("ColorTwist")
+      .AddArg("batch_size", batch_size)
+      .AddArg("num_threads", 1)
+      .AddArg("device", "cpu")
+      .AddArg("image_type", DALI_RGB)
+      .AddArg("hue", 15.0f)
+      .AddArg("saturation", 1.2f)
+      .AddArg("contrast", 0.9f)
+      .AddArg("brightness", 1.1f),
+    batch_size, H, W, C, true);
+}
+
+BENCHMARK_REGISTER_F(OperatorBench, ColorTwistCPU)->Iterations(500)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime()
+->Apply(ColorTwistCPUArgs);
+
+}  // namespace dali
@@ -0,0 +1,626 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <opencv2/opencv.hpp>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/pipeline/pipeline.h"
+#ifdef DALI_BUILD_PROTO3
+#include "dali/pipeline/operators/reader/parser/example.pb.h"
+#include "dali/pipeline/operators/reader/parser/tf_feature.h"
+#endif  // DALI_BUILD_PROTO3
+
+namespace {
+
+/// Number of calls to the global operator new, in the whole process
+std::atomic<size_t> g_num_allocations{0};
+
+}  // namespace
+
+// Counting allocations in the library as well requires replacing the global operators;
+// the overhead of a relaxed increment is negligible compared to the allocation itself.
+// This file is built as a separate executable (dali_cpu_pipeline_benchmark.bin), so that
+// the replacement does not affect the other benchmarks.
+void *operator new(size_t size) {
+  g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  g_num_allocations.fetch_add(1, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+  return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Synthetic dataset, written once per process to a temporary directory
+ *
+ * The same images are available through every supported reader, so that the results
+ * of different pipelines differ only by the reader. The directory is placed in /dev/shm,
+ * if available, so that the benchmarks do not depend on the disk.
+ */
+class SyntheticDataset {
+ public:
+  static const int kNumImages = 64;
+  static const int kNumClasses = 4;
+
+  static const SyntheticDataset &Get() {
+    static SyntheticDataset dataset;
+    return dataset;
+  }
+
+  string file_root;
+  string coco_annotations;
+  string recordio, recordio_index;
+  string tfrecord, tfrecord_index;
+
+ private:
+  SyntheticDataset() {
+    struct stat st;
+    string tmp = stat("/dev/shm", &st) == 0 && S_ISDIR(st.st_mode) ? "/dev/shm" : "/tmp";
+    string pattern = tmp + "/dali_cpu_bench_XXXXXX";
+    DALI_ENFORCE(mkdtemp(&pattern[0]) != nullptr, "Cannot create a temporary directory");
+    root_ = pattern;
+    file_root = MakeDir(root_ + "/images");
+    for (int c = 0; c < kNumClasses; c++)
+      MakeDir(file_root + "/" + std::to_string(c));
+
+    std::mt19937 rng(1234);
+    for (int i = 0; i < kNumImages; i++)
+      images_.push_back(MakeImage(rng, i));
+
+    WriteFiles();
+    WriteCOCOAnnotations(rng);
+    WriteRecordIO();
+#ifdef DALI_BUILD_PROTO3
+    WriteTFRecord();
+#endif  // DALI_BUILD_PROTO3
+  }
+
+  ~SyntheticDataset() {
+    for (auto it = files_.rbegin(); it != files_.rend(); ++it)
+      std::remove(it->c_str());
+    for (auto it = dirs_.rbegin(); it != dirs_.rend(); ++it)
+      rmdir(it->c_str());
+    rmdir(root_.c_str());
+  }
+
+  struct Image {
+    string name;  // relative to file_root
+    int label;
+    int width, height;
+    std::vector<uint8_t> jpeg;
+  };
+
+  string MakeDir(const string &path) {
+    DALI_ENFORCE(mkdir(path.c_str(), 0700) == 0, "Cannot create directory " + path);
+    dirs_.push_back(path);
+    return path;
+  }
+
+  std::ofstream CreateFile(const string &path) {
+    std::ofstream f(path, std::ios::binary);
+    DALI_ENFORCE(f.good(), "Cannot create file " + path);
+    files_.push_back(path);
+    return f;
+  }
+
+  /// Smooth gradients with some noise, to get realistic JPEG sizes and decoding times
+  static Image MakeImage(std::mt19937 &rng, int idx) {
+    Image img;
+    img.label = idx % kNumClasses;
+    img.name = std::to_string(img.label) + "/img_" + std::to_string(idx) + ".jpg";
+    img.width = std::uniform_int_distribution<int>(400, 800)(rng);
+    img.height = std::uniform_int_distribution<int>(300, 600)(rng);
+    std::uniform_int_distribution<int> noise(-16, 16);
+    cv::Mat mat(img.height, img.width, CV_8UC3);
+    for (int y = 0; y < img.height; y++) {
+      auto *row = mat.ptr<uint8_t>(y);
+      for (int x = 0; x < img.width; x++) {
+        row[3 * x + 0] = cv::saturate_cast<uint8_t>(x * 255 / img.width + noise(rng));
+        row[3 * x + 1] = cv::saturate_cast<uint8_t>(y * 255 / img.height + noise(rng));
+        row[3 * x + 2] = cv::saturate_cast<uint8_t>((x + y + idx * 16) % 256 + noise(rng));
+      }
+    }
+    cv::imencode(".jpg", mat, img.jpeg, { cv::IMWRITE_JPEG_QUALITY, 90 });
+    return img;
+  }
+
+  void WriteFiles() {
+    for (auto &img : images_) {
+      auto f = CreateFile(file_root + "/" + img.name);
+      f.write(reinterpret_cast<const char *>(img.jpeg.data()), img.jpeg.size());
+    }
+  }
+
+  void WriteCOCOAnnotations(std::mt19937 &rng) {
+    coco_annotations = root_ + "/annotations.json";
+    auto f = CreateFile(coco_annotations);
+    f << "{\"images\":[";
+    for (int i = 0; i < kNumImages; i++) {
+      auto &img = images_[i];
+      f << (i ? "," : "") << "{\"id\":" << i << ",\"file_name\":\"" << img.name
+        << "\",\"width\":" << img.width << ",\"height\":" << img.height << "}";
+    }
+    f << "],\"categories\":[";
+    for (int c = 0; c < kNumClasses; c++)
+      f << (c ? "," : "") << "{\"id\":" << c + 1 << "}";
+    f << "],\"annotations\":[";
+    int ann_id = 0;
+    for (int i = 0; i < kNumImages; i++) {
+      auto &img = images_[i];
+      int num_boxes = std::uniform_int_distribution<int>(1, 8)(rng);
+      for (int b = 0; b < num_boxes; b++) {
+        int w = std::uniform_int_distribution<int>(img.width / 8, img.width / 2)(rng);
+        int h = std::uniform_int_distribution<int>(img.height / 8, img.height / 2)(rng);
+        int x = std::uniform_int_distribution<int>(0, img.width - w)(rng);
+        int y = std::uniform_int_distribution<int>(0, img.height - h)(rng);
+        f << (ann_id ? "," : "") << "{\"id\":" << ann_id << ",\"image_id\":" << i
+          << ",\"category_id\":" << b % kNumClasses + 1 << ",\"iscrowd\":0,\"bbox\":["
+          << x << "," << y << "," << w << "," << h << "]}";
+        ann_id++;
+      }
+    }
+    f << "]}";
+  }
+
+  void WriteRecordIO() {
+    recordio = root_ + "/data.rec";
+    recordio_index = root_ + "/data.idx";
+    auto rec = CreateFile(recordio);
+    auto idx = CreateFile(recordio_index);
+    const uint32_t kMagic = 0xced7230a;
+    for (int i = 0; i < kNumImages; i++) {
+      auto &img = images_[i];
+      idx << i << "\t" << rec.tellp() << "\n";
+      struct {
+        uint32_t flag;
+        float label;
+        uint64_t image_id[2];
+      } header = { 0, static_cast<float>(img.label), { static_cast<uint64_t>(i), 0 } };
+      uint32_t length = sizeof(header) + img.jpeg.size();
+      rec.write(reinterpret_cast<const char *>(&kMagic), sizeof(kMagic));
+      rec.write(reinterpret_cast<const char *>(&length), sizeof(length));
+      rec.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      rec.write(reinterpret_cast<const char *>(img.jpeg.data()), img.jpeg.size());
+      const char padding[4] = {};
+      rec.write(padding, (4 - length % 4) % 4);
+    }
+  }
+
+#ifdef DALI_BUILD_PROTO3
+  static uint32_t MaskedCRC32C(const char *data, size_t size) {
+    uint32_t crc = ~0u;
+    for (size_t i = 0; i < size; i++) {
+      crc ^= static_cast<uint8_t>(data[i]);
+      for (int k = 0; k < 8; k++)
+        crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1u)));
+    }
+    crc = ~crc;
+    return ((crc >> 15) | (crc << 17)) + 0xa282ead8u;
+  }
+
+  void WriteTFRecord() {
+    tfrecord = root_ + "/data.tfrecord";
+    tfrecord_index = root_ + "/data.tfrecord.idx";
+    auto rec = CreateFile(tfrecord);
+    auto idx = CreateFile(tfrecord_index);
+    for (auto &img : images_) {
+      tensorflow::Example example;
+      auto &features = *example.mutable_features()->mutable_feature();
+      features["image/encoded"].mutable_bytes_list()->add_value(
+          reinterpret_cast<const char *>(img.jpeg.data()), img.jpeg.size());
+      features["image/class/label"].mutable_int64_list()->add_value(img.label);
+      string data = example.SerializeAsString();
+
+      uint64_t length = data.size();
+      uint32_t length_crc = MaskedCRC32C(reinterpret_cast<const char *>(&length), sizeof(length));
+      uint32_t data_crc = MaskedCRC32C(data.data(), data.size());
+      idx << rec.tellp() << " " << sizeof(length) + 2 * sizeof(uint32_t) + length << "\n";
+      rec.write(reinterpret_cast<const char *>(&length), sizeof(length));
+      rec.write(reinterpret_cast<const char *>(&length_crc), sizeof(length_crc));
+      rec.write(data.data(), data.size());
+      rec.write(reinterpret_cast<const char *>(&data_crc), sizeof(data_crc));
+    }
+  }
+#endif  // DALI_BUILD_PROTO3
+
+  string root_;
+  std::vector<Image> images_;
+  std::vector<string> files_, dirs_;
+};
+
+/// Resets the peak resident set size of the process; returns false if not supported
+bool ResetPeakRSS() {
+  std::ofstream f("/proc/self/clear_refs");
+  f << "5";
+  return f.good();
+}
+
+/// Peak resident set size of the process, in KiB
+int64_t PeakRSS() {
+  std::ifstream f("/proc/self/status");
+  string line;
+  while (std::getline(f, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return std::atoll(line.c_str() + 6);
+  }
+  return 0;
+}
+
+double Percentile(std::vector<double> values, double p) {
+  if (values.empty())
+    return 0;
+  size_t n = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+  std::nth_element(values.begin(), values.begin() + n, values.end());
+  return values[n];
+}
+
+enum class ReaderKind {
+  File,
+  MXNet,
+  TFRecord,
+  Caffe,
+  Caffe2,
+};
+
+/// Path to an existing LMDB database, as the synthetic dataset has none
+string LMDBPath(const char *env_var) {
+  const char *path = std::getenv(env_var);
+  DALI_ENFORCE(path != nullptr, string(env_var) + " must point to an LMDB database");
+  return path;
+}
+
+/// Adds a reader producing "jpegs" and "labels"
+void AddReader(Pipeline &pipe, ReaderKind kind) {
+  auto &dataset = SyntheticDataset::Get();
+  switch (kind) {
+    case ReaderKind::File:
+      pipe.AddOperator(
+          OpSpec("FileReader")
+          .AddArg("device", "cpu")
+          .AddArg("file_root", dataset.file_root)
+          .AddOutput("jpegs", "cpu")
+          .AddOutput("labels", "cpu"));
+      break;
+    case ReaderKind::MXNet:
+      pipe.AddOperator(
+          OpSpec("MXNetReader")
+          .AddArg("device", "cpu")
+          .AddArg("path", vector<string>{dataset.recordio})
+          .AddArg("index_path", vector<string>{dataset.recordio_index})
+          .AddOutput("jpegs", "cpu")
+          .AddOutput("labels", "cpu"));
+      break;
+    case ReaderKind::TFRecord:
+#ifdef DALI_BUILD_PROTO3
+      pipe.AddOperator(
+          OpSpec("_TFRecordReader")
+          .AddArg("device", "cpu")
+          .AddArg("path", vector<string>{dataset.tfrecord})
+          .AddArg("index_path", vector<string>{dataset.tfrecord_index})
+          .AddArg("feature_names", vector<string>{"image/encoded", "image/class/label"})
+          .AddArg("features", vector<TFUtil::Feature>{
+              TFUtil::Feature({}, TFUtil::FeatureType::string, TFUtil::Feature::Value{}),
+              TFUtil::Feature({1}, TFUtil::FeatureType::int64, TFUtil::Feature::Value{"", -1})})
+          .AddOutput("jpegs", "cpu")
+          .AddOutput("labels", "cpu"));
+#else
+      DALI_FAIL("TFRecordReader requires DALI built with protobuf 3");
+#endif  // DALI_BUILD_PROTO3
+      break;
+    case ReaderKind::Caffe:
+      pipe.AddOperator(
+          OpSpec("CaffeReader")
+          .AddArg("device", "cpu")
+          .AddArg("path", LMDBPath("DALI_TEST_CAFFE_LMDB_PATH"))
+          .AddOutput("jpegs", "cpu")
+          .AddOutput("labels", "cpu"));
+      break;
+    case ReaderKind::Caffe2:
+      pipe.AddOperator(
+          OpSpec("Caffe2Reader")
+          .AddArg("device", "cpu")
+          .AddArg("path", LMDBPath("DALI_TEST_CAFFE2_LMDB_PATH"))
+          .AddOutput("jpegs", "cpu")
+          .AddOutput("labels", "cpu"));
+      break;
+  }
+}
+
+/**
+ * @brief Runs a built pipeline and reports its throughput, latency, memory and allocations
+ *
+ * Each iteration takes one batch out of the pipeline and schedules the next one, so that
+ * `prefetch_depth` batches are always in flight. The batch latency is the time of one such
+ * iteration, which is what a consumer of the pipeline waits for.
+ */
+void RunPipeline(benchmark::State &st, Pipeline &pipe, int batch_size, int prefetch_depth) {
+  DeviceWorkspace ws;
+  for (int i = 0; i < prefetch_depth; i++) {
+    pipe.RunCPU();
+    pipe.RunGPU();
+  }
+  // Let the buffers grow to their steady state sizes
+  const int kWarmupIters = 5;
+  for (int i = 0; i < kWarmupIters; i++) {
+    pipe.Outputs(&ws);
+    pipe.RunCPU();
+    pipe.RunGPU();
+  }
+
+  std::vector<double> latencies;
+  latencies.reserve(st.max_iterations);
+  ResetPeakRSS();
+  size_t num_allocations = g_num_allocations.load(std::memory_order_relaxed);
+
+  for (auto _ : st) {
+    auto start = std::chrono::high_resolution_clock::now();
+    pipe.Outputs(&ws);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    auto end = std::chrono::high_resolution_clock::now();
+    latencies.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  num_allocations = g_num_allocations.load(std::memory_order_relaxed) - num_allocations;
+  for (int i = 0; i < prefetch_depth; i++)
+    pipe.Outputs(&ws);
+
+  double iters = std::max<double>(1, st.iterations());
+  st.counters["images/s"] = benchmark::Counter(batch_size * st.iterations(),
+                                               benchmark::Counter::kIsRate);
+  st.counters["p50_ms"] = Percentile(latencies, 0.5);
+  st.counters["p99_ms"] = Percentile(latencies, 0.99);
+  // If the reset is not supported, this is the peak of the whole process so far
+  st.counters["peak_rss_MiB"] = PeakRSS() / 1024.0;
+  st.counters["allocs/batch"] = num_allocations / iters;
+}
+
+/**
+ * @brief Reader -> HostDecoder -> Resize -> CropMirrorNormalize, all on the CPU
+ *
+ * Args: num_threads, batch_size, prefetch_depth
+ */
+void ClassificationCPUPipe(benchmark::State &st, ReaderKind reader) {  // NOLINT
+  int num_threads = st.range(0);
+  int batch_size = st.range(1);
+  int prefetch_depth = st.range(2);
+
+  Pipeline pipe(batch_size, num_threads, 0, 1234, true, prefetch_depth, true);
+  AddReader(pipe, reader);
+
+  pipe.AddOperator(
+      OpSpec("ImageDecoder")
+      .AddArg("device", "cpu")
+      .AddArg("output_type", DALI_RGB)
+      .AddInput("jpegs", "cpu")
+      .AddOutput("images", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("Resize")
+      .AddArg("device", "cpu")
+      .AddArg("resize_shorter", 256.f)
+      .AddInput("images", "cpu")
+      .AddOutput("resized", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("CropMirrorNormalize")
+      .AddArg("device", "cpu")
+      .AddArg("output_dtype", DALI_FLOAT)
+      .AddArg("output_layout", DALI_NCHW)
+      .AddArg("crop", vector<float>{224, 224})
+      .AddArg("mean", vector<float>{0.485f * 255, 0.456f * 255, 0.406f * 255})
+      .AddArg("std", vector<float>{0.229f * 255, 0.224f * 255, 0.225f * 255})
+      .AddInput("resized", "cpu")
+      .AddOutput("final_batch", "cpu"));
+
+  vector<std::pair<string, string>> outputs = {{"final_batch", "cpu"}, {"labels", "cpu"}};
+  pipe.Build(outputs);
+
+  RunPipeline(st, pipe, batch_size, prefetch_depth);
+}
+
+/// SSD-like anchors in ltrb format: square and elongated boxes on a few grids
+vector<float> SSDAnchors() {
+  vector<float> anchors;
+  for (int grid : {19, 10, 5, 3, 1}) {
+    float scale = 1.f / grid;
+    for (int y = 0; y < grid; y++) {
+      for (int x = 0; x < grid; x++) {
+        float cx = (x + 0.5f) * scale, cy = (y + 0.5f) * scale;
+        for (float aspect : {1.f, 2.f, 0.5f}) {
+          float w = scale * std::sqrt(aspect), h = scale / std::sqrt(aspect);
+          anchors.insert(anchors.end(), {cx - w / 2, cy - h / 2, cx + w / 2, cy + h / 2});
+        }
+      }
+    }
+  }
+  return anchors;
+}
+
+/**
+ * @brief COCOReader -> HostDecoder -> SSDRandomCrop -> Resize -> CropMirrorNormalize,
+ *        with the boxes encoded by BoxEncoder, all on the CPU
+ *
+ * Args: num_threads, batch_size, prefetch_depth
+ */
+void DetectionCPUPipe(benchmark::State &st) {  // NOLINT
+  int num_threads = st.range(0);
+  int batch_size = st.range(1);
+  int prefetch_depth = st.range(2);
+  auto &dataset = SyntheticDataset::Get();
+
+  Pipeline pipe(batch_size, num_threads, 0, 1234, true, prefetch_depth, true);
+  pipe.AddOperator(
+      OpSpec("COCOReader")
+      .AddArg("device", "cpu")
+      .AddArg("file_root", dataset.file_root)
+      .AddArg("annotations_file", vector<string>{dataset.coco_annotations})
+      .AddArg("ltrb", true)
+      .AddArg("ratio", true)
+      .AddOutput("jpegs", "cpu")
+      .AddOutput("boxes", "cpu")
+      .AddOutput("labels", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("ImageDecoder")
+      .AddArg("device", "cpu")
+      .AddArg("output_type", DALI_RGB)
+      .AddInput("jpegs", "cpu")
+      .AddOutput("images", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("SSDRandomCrop")
+      .AddArg("device", "cpu")
+      .AddArg("num_attempts", 1)
+      .AddInput("images", "cpu")
+      .AddInput("boxes", "cpu")
+      .AddInput("labels", "cpu")
+      .AddOutput("cropped_images", "cpu")
+      .AddOutput("cropped_boxes", "cpu")
+      .AddOutput("cropped_labels", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("Resize")
+      .AddArg("device", "cpu")
+      .AddArg("resize_x", 300.f)
+      .AddArg("resize_y", 300.f)
+      .AddInput("cropped_images", "cpu")
+      .AddOutput("resized", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("CropMirrorNormalize")
+      .AddArg("device", "cpu")
+      .AddArg("output_dtype", DALI_FLOAT)
+      .AddArg("output_layout", DALI_NCHW)
+      .AddArg("mean", vector<float>{0.485f * 255, 0.456f * 255, 0.406f * 255})
+      .AddArg("std", vector<float>{0.229f * 255, 0.224f * 255, 0.225f * 255})
+      .AddInput("resized", "cpu")
+      .AddOutput("final_batch", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("BoxEncoder")
+      .AddArg("device", "cpu")
+      .AddArg("anchors", SSDAnchors())
+      .AddArg("criteria", 0.5f)
+      .AddInput("cropped_boxes", "cpu")
+      .AddInput("cropped_labels", "cpu")
+      .AddOutput("encoded_boxes", "cpu")
+      .AddOutput("encoded_labels", "cpu"));
+
+  vector<std::pair<string, string>> outputs = {
+    {"final_batch", "cpu"}, {"encoded_boxes", "cpu"}, {"encoded_labels", "cpu"}};
+  pipe.Build(outputs);
+
+  RunPipeline(st, pipe, batch_size, prefetch_depth);
+}
+
+void CPUPipeArgs(benchmark::internal::Benchmark *b) {
+  for (int num_threads : {1, 2, 4, 8}) {
+    for (int batch_size : {16, 64}) {
+      for (int prefetch_depth : {1, 2, 3}) {
+        b->Args({num_threads, batch_size, prefetch_depth});
+      }
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(ClassificationCPUPipe, FileReader, ReaderKind::File)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
+
+BENCHMARK_CAPTURE(ClassificationCPUPipe, MXNetReader, ReaderKind::MXNet)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
+
+#ifdef DALI_BUILD_PROTO3
+BENCHMARK_CAPTURE(ClassificationCPUPipe, TFRecordReader, ReaderKind::TFRecord)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
+#endif  // DALI_BUILD_PROTO3
+
+#if LMDB_ENABLED
+BENCHMARK_CAPTURE(ClassificationCPUPipe, CaffeReader, ReaderKind::Caffe)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
+
+BENCHMARK_CAPTURE(ClassificationCPUPipe, Caffe2Reader, ReaderKind::Caffe2)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
+#endif  // LMDB_ENABLED
+
+BENCHMARK(DetectionCPUPipe)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
+
+}  // namespace dali
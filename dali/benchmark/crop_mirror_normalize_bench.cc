@@ -67,7 +67,8 @@ BENCHMARK_DEFINE_F(OperatorBench, CropMirrorNormalizeCPU)(benchmark::State& st)
       .AddArg("crop_pos_y", 0.5f)
       .AddArg("mean", std::vector<float>(C, mean))
       .AddArg("std", std::vector<float>(C, std))
-      .AddArg("mirror", mirror),
+      .AddArg("mirror", mirror)
+      .AddArg("pad_output", static_cast<bool>(pad)),
     batch_size, H, W, C);
 }
 
@@ -126,7 +127,8 @@ BENCHMARK_DEFINE_F(OperatorBench, CropMirrorNormalizeGPU)(benchmark::State& st)
       .AddArg("crop_pos_y", 0.5f)
       .AddArg("mean", std::vector<float>(C, mean))
       .AddArg("std", std::vector<float>(C, std))
-      .AddArg("mirror", mirror),
+      .AddArg("mirror", mirror)
+      .AddArg("pad_output", static_cast<bool>(pad)),
     batch_size, H, W, C);
 }
 
@@ -0,0 +1,196 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "dali/kernels/imgproc/resample/resample_crop_normalize_cpu.h"
+#include "dali/kernels/imgproc/resample/resampling_filters.cuh"
+#include "dali/kernels/imgproc/resample/resampling_impl_cpu.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+#include "dali/kernels/scratch.h"
+#include "dali/kernels/slice/slice_flip_normalize_permute_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+template <typename T>
+Surface2D<T> MakeSurface(std::vector<T> &storage, int w, int h, int c) {
+  storage.resize(static_cast<size_t>(w) * h * c);
+  return { storage.data(), w, h, c, c, w * c, 1 };
+}
+
+struct ResampleBenchData {
+  std::vector<uint8_t> in, out;
+  std::vector<float> tmp;
+  std::vector<int32_t> col_idx, row_idx;
+  std::vector<float> col_coeffs, row_coeffs;
+  int col_support, row_support;
+  Surface2D<uint8_t> in_surf, out_surf;
+  Surface2D<float> tmp_surf;
+
+  ResampleBenchData(int in_w, int in_h, int out_w, int out_h) {
+    constexpr int C = 3;
+    in_surf = MakeSurface(in, in_w, in_h, C);
+    for (size_t i = 0; i < in.size(); i++)
+      in[i] = static_cast<uint8_t>(i * 7 + (i >> 5));
+    // vertical pass first, as SeparableResampleCPU does for downscaling
+    tmp_surf = MakeSurface(tmp, in_w, out_h, C);
+    out_surf = MakeSurface(out, out_w, out_h, C);
+
+    float scale_x = static_cast<float>(in_w) / out_w;
+    float scale_y = static_cast<float>(in_h) / out_h;
+    auto filters = GetResamplingFiltersCPU();
+    auto fx = filters->Triangular(scale_x);
+    auto fy = filters->Triangular(scale_y);
+    col_support = fx.support();
+    row_support = fy.support();
+    col_idx.resize(out_w);
+    row_idx.resize(out_h);
+    col_coeffs.resize(out_w * col_support);
+    row_coeffs.resize(out_h * row_support);
+    InitializeResamplingFilter(col_idx.data(), col_coeffs.data(), out_w, 0, scale_x, fx);
+    InitializeResamplingFilter(row_idx.data(), row_coeffs.data(), out_h, 0, scale_y, fy);
+  }
+};
+
+/**
+ * @brief Both passes of a 3-channel uint8 downscale with a triangular (antialiasing) filter
+ *
+ * Args: input width, input height, output width, output height, use SIMD (0/1)
+ */
+void ResampleCPUBench(benchmark::State& st) {  // NOLINT
+  ResampleBenchData d(st.range(0), st.range(1), st.range(2), st.range(3));
+  bool simd = st.range(4) != 0;
+  const Surface2D<const uint8_t> &in = d.in_surf;
+  const Surface2D<const float> &tmp = d.tmp_surf;
+
+  for (auto _ : st) {
+    if (simd) {
+      ResampleVert(d.tmp_surf, in, d.row_idx.data(), d.row_coeffs.data(), d.row_support);
+      ResampleHorz(d.out_surf, tmp, d.col_idx.data(), d.col_coeffs.data(), d.col_support);
+    } else {
+      ResampleVertScalar(d.tmp_surf, in, d.row_idx.data(), d.row_coeffs.data(), d.row_support);
+      ResampleHorzScalar(d.out_surf, tmp, d.col_idx.data(), d.col_coeffs.data(),
+                         d.col_support);
+    }
+    benchmark::DoNotOptimize(d.out.data());
+  }
+  st.SetBytesProcessed(st.iterations() * d.in.size());
+}
+
+/**
+ * @brief Resize to 256 (shorter side), 224x224 crop, mirror and normalize to planar float
+ *
+ * Args: input width, input height, fused (0 - resize followed by crop/mirror/normalize, 1 - fused)
+ */
+void ResizeCropMirrorNormalizeCPUBench(benchmark::State& st) {  // NOLINT
+  const int W = st.range(0), H = st.range(1), C = 3;
+  const bool fused = st.range(2) != 0;
+  const int crop = 224;
+  const int rsz_h = H < W ? 256 : 256 * H / W;
+  const int rsz_w = H < W ? 256 * W / H : 256;
+
+  std::vector<uint8_t> in(H * W * C);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = static_cast<uint8_t>(i * 7 + (i >> 5));
+  InTensorCPU<uint8_t, 3> in_view = { in.data(), { H, W, C } };
+  std::vector<float> out(crop * crop * C);
+  OutTensorCPU<float, 3> out_view = { out.data(), { C, crop, crop } };
+
+  ResamplingParams2D params;
+  params[0].output_size = rsz_h;
+  params[1].output_size = rsz_w;
+  params[0].min_filter = params[1].min_filter = ResamplingFilterType::Triangular;
+  params[0].mag_filter = params[1].mag_filter = ResamplingFilterType::Linear;
+  std::vector<float> mean = { 0.485f * 255, 0.456f * 255, 0.406f * 255 };
+  std::vector<float> inv_std = { 1 / (0.229f * 255), 1 / (0.224f * 255), 1 / (0.225f * 255) };
+  int crop_y = (rsz_h - crop) / 2, crop_x = (rsz_w - crop) / 2;
+
+  KernelContext context;
+  ScratchpadAllocator scratch_alloc;
+
+  if (fused) {
+    ResampleCropMirrorNormalizeArgs args;
+    args.resample = params;
+    args.crop_anchor = {{ crop_y, crop_x }};
+    args.crop_shape = {{ crop, crop }};
+    args.mirror = true;
+    args.mean = mean;
+    args.inv_stddev = inv_std;
+    ResampleCropMirrorNormalizeCPU<float, uint8_t> kernel;
+    for (auto _ : st) {
+      auto req = kernel.Setup(context, in_view, args);
+      scratch_alloc.Reserve(req.scratch_sizes);
+      auto scratchpad = scratch_alloc.GetScratchpad();
+      context.scratchpad = &scratchpad;
+      kernel.Run(context, out_view, in_view, args);
+      benchmark::DoNotOptimize(out.data());
+    }
+  } else {
+    std::vector<uint8_t> resized(rsz_h * rsz_w * C);
+    OutTensorCPU<uint8_t, 3> resized_view = { resized.data(), { rsz_h, rsz_w, C } };
+    InTensorCPU<uint8_t, 3> resized_in = { resized.data(), { rsz_h, rsz_w, C } };
+    SliceFlipNormalizePermuteArgs<3> args(TensorShape<3>{ crop, crop, C });
+    args.anchor = {{ crop_y, crop_x, 0 }};
+    args.flip[1] = true;
+    args.permuted_dims = {{ 2, 0, 1 }};
+    args.mean = mean;
+    args.inv_stddev = inv_std;
+    args.normalization_dim = 2;
+    SeparableResampleCPU<uint8_t, uint8_t> resample;
+    SliceFlipNormalizePermuteCPU<float, uint8_t, 3> crop_normalize;
+    for (auto _ : st) {
+      auto req = resample.Setup(context, in_view, params);
+      scratch_alloc.Reserve(req.scratch_sizes);
+      auto scratchpad = scratch_alloc.GetScratchpad();
+      context.scratchpad = &scratchpad;
+      resample.Run(context, resized_view, in_view, params);
+      crop_normalize.Setup(context, resized_in, args);
+      crop_normalize.Run(context, out_view, resized_in, args);
+      benchmark::DoNotOptimize(out.data());
+    }
+  }
+  st.SetItemsProcessed(st.iterations());
+}
+
+}  // namespace
+
+BENCHMARK(ResizeCropMirrorNormalizeCPUBench)
+->Args({500, 375, 0})
+->Args({500, 375, 1})
+->Args({640, 480, 0})
+->Args({640, 480, 1})
+->Args({1920, 1080, 0})
+->Args({1920, 1080, 1})
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+BENCHMARK(ResampleCPUBench)
+->Args({1920, 1080, 224, 224, 0})
+->Args({1920, 1080, 224, 224, 1})
+->Args({1920, 1080, 960, 540, 0})
+->Args({1920, 1080, 960, 540, 1})
+->Args({640, 480, 224, 224, 0})
+->Args({640, 480, 224, 224, 1})
+->Args({500, 375, 256, 256, 0})
+->Args({500, 375, 256, 256, 1})
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+}  // namespace kernels
+}  // namespace dali
@@ -393,5 +393,128 @@ BENCHMARK_REGISTER_F(RN50, nvJPEGPipe)->Iterations(100)
 ->UseRealTime()
 ->Apply(nvjpegPipeArgs);
 
+BENCHMARK_DEFINE_F(RN50, CPUPipe)(benchmark::State& st) { // NOLINT
+  bool depth_first = st.range(0);
+  int batch_size = st.range(1);
+  int num_thread = st.range(2);
+  DALIImageType img_type = DALI_RGB;
+
+  // Create the pipeline
+  Pipeline pipe(
+      batch_size,
+      num_thread,
+      0, -1, true, 3,
+      true);
+  pipe.SetDepthFirstCPUExecution(depth_first);
+
+  TensorList<CPUBackend> data;
+  this->MakeJPEGBatch(&data, batch_size);
+  pipe.AddExternalInput("raw_jpegs");
+  pipe.SetExternalInput("raw_jpegs", data);
+
+  pipe.AddOperator(
+      OpSpec("ImageDecoder")
+      .AddArg("device", "cpu")
+      .AddArg("output_type", img_type)
+      .AddInput("raw_jpegs", "cpu")
+      .AddOutput("images", "cpu"));
+
+  // Add uniform RNG
+  pipe.AddOperator(
+      OpSpec("Uniform")
+      .AddArg("device", "support")
+      .AddArg("range", vector<float>{256, 480})
+      .AddOutput("resize", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("Resize")
+      .AddArg("device", "cpu")
+      .AddArg("image_type", img_type)
+      .AddArg("interp_type", DALI_INTERP_LINEAR)
+      .AddInput("images", "cpu")
+      .AddArgumentInput("resize_shorter", "resize")
+      .AddOutput("resized", "cpu"));
+
+  // Add uniform RNG
+  pipe.AddOperator(
+      OpSpec("Uniform")
+      .AddArg("device", "support")
+      .AddArg("range", vector<float>{0, 1})
+      .AddOutput("uniform1", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("Uniform")
+      .AddArg("device", "support")
+      .AddArg("range", vector<float>{0, 1})
+      .AddOutput("uniform2", "cpu"));
+
+  // Add coin flip RNG for mirror mask
+  pipe.AddOperator(
+      OpSpec("CoinFlip")
+      .AddArg("device", "support")
+      .AddArg("probability", 0.5f)
+      .AddOutput("mirror", "cpu"));
+
+  pipe.AddOperator(
+      OpSpec("CropMirrorNormalize")
+      .AddArg("device", "cpu")
+      .AddArg("output_type", img_type)
+      .AddArg("output_dtype", DALI_FLOAT)
+      .AddArg("output_layout", DALI_NCHW)
+      .AddArg("crop", vector<float>{224, 224})
+      .AddArg("mean", vector<float>{128, 128, 128})
+      .AddArg("std", vector<float>{1, 1, 1})
+      .AddArgumentInput("mirror", "mirror")
+      .AddArgumentInput("crop_pos_x", "uniform1")
+      .AddArgumentInput("crop_pos_y", "uniform2")
+      .AddInput("resized", "cpu")
+      .AddOutput("final_batch", "cpu"));
+
+  // Build and run the pipeline
+  vector<std::pair<string, string>> outputs = {{"final_batch", "cpu"}};
+  pipe.Build(outputs);
+
+  // Run once to allocate the memory
+  DeviceWorkspace ws;
+  pipe.RunCPU();
+  pipe.RunGPU();
+  pipe.Outputs(&ws);
+
+  while (st.KeepRunning()) {
+    if (st.iterations() == 1) {
+      // We will start he processing for the next batch
+      // immediately to pipeline the work
+      pipe.RunCPU();
+      pipe.RunGPU();
+    }
+    pipe.RunCPU();
+    pipe.RunGPU();
+    pipe.Outputs(&ws);
+
+    if (st.iterations() == st.max_iterations) {
+      // Block for the last batch to finish
+      pipe.Outputs(&ws);
+    }
+  }
+
+  int num_batches = st.iterations() + 1;
+  st.counters["FPS"] = benchmark::Counter(batch_size*num_batches,
+      benchmark::Counter::kIsRate);
+}
+
+static void CPUPipeArgs(benchmark::internal::Benchmark *b) {
+  for (int depth_first = 0; depth_first < 2; ++depth_first) {
+    for (int batch_size = 128; batch_size <= 128; batch_size += 32) {
+      for (int num_thread = 1; num_thread <= 4; ++num_thread) {
+        b->Args({depth_first, batch_size, num_thread});
+      }
+    }
+  }
+}
+
+BENCHMARK_REGISTER_F(RN50, CPUPipe)->Iterations(100)
+->Unit(benchmark::kMillisecond)
+->UseRealTime()
+->Apply(CPUPipeArgs);
 
 }  // namespace dali
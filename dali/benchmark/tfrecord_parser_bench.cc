@@ -0,0 +1,172 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/parser/example.pb.h"
+#include "dali/pipeline/operators/reader/parser/tfrecord_parser.h"
+#include "dali/pipeline/operators/reader/parser/tfrecord_scanner.h"
+#include "dali/pipeline/workspace/host_workspace.h"
+#include "dali/pipeline/workspace/sample_workspace.h"
+
+namespace dali {
+
+namespace {
+
+using TFUtil::Feature;
+using TFUtil::FeatureType;
+
+/**
+ * @brief A framed record resembling ImageNet or COCO - encoded image, label, boxes,
+ *        and features which are not read
+ */
+std::string MakeTFRecord(int image_size, int num_boxes, int num_extra_features) {
+  tensorflow::Example example;
+  auto &features = *example.mutable_features()->mutable_feature();
+  std::string image(image_size, '\0');
+  for (int i = 0; i < image_size; i++)
+    image[i] = static_cast<char>(i * 7 + (i >> 9));
+  features["image/encoded"].mutable_bytes_list()->add_value(image);
+  features["image/class/label"].mutable_int64_list()->add_value(417);
+  for (int i = 0; i < num_boxes * 4; i++)
+    features["image/object/bbox"].mutable_float_list()->add_value(i * 0.01f);
+  for (int i = 0; i < num_extra_features; i++) {
+    auto name = "image/meta/" + std::to_string(i);
+    features[name].mutable_bytes_list()->add_value("value of the feature " + name);
+  }
+  std::string data = example.SerializeAsString();
+
+  uint64_t length = data.size();
+  auto *length_ptr = reinterpret_cast<const uint8_t *>(&length);
+  uint32_t length_crc = tfrecord::MaskedCRC32C(length_ptr, sizeof(length));
+  uint32_t data_crc = tfrecord::MaskedCRC32C(
+      reinterpret_cast<const uint8_t *>(data.data()), data.size());
+  std::string record(reinterpret_cast<const char *>(&length), sizeof(length));
+  record.append(reinterpret_cast<const char *>(&length_crc), sizeof(length_crc));
+  record += data;
+  record.append(reinterpret_cast<const char *>(&data_crc), sizeof(data_crc));
+  return record;
+}
+
+/**
+ * @brief Extraction of the requested features by deserializing the whole tf.Example,
+ *        as TFRecordParser used to do
+ */
+void ParseWithProtobuf(const Tensor<CPUBackend> &data, const std::vector<std::string> &names,
+                       SampleWorkspace *ws) {
+  const uint8_t *raw_data = data.data<uint8_t>();
+  uint64_t length;
+  std::memcpy(&length, raw_data, sizeof(length));
+  tensorflow::Example example;
+  DALI_ENFORCE(example.ParseFromArray(raw_data + tfrecord::kHeaderSize, length));
+
+  auto &image = example.features().feature().at(names[0]).bytes_list().value(0);
+  auto &image_out = ws->Output<CPUBackend>(0);
+  image_out.Resize({static_cast<Index>(image.size())});
+  std::memcpy(image_out.mutable_data<uint8_t>(), image.data(), image.size());
+
+  auto &label = example.features().feature().at(names[1]).int64_list().value();
+  auto &label_out = ws->Output<CPUBackend>(1);
+  label_out.Resize({label.size()});
+  std::memcpy(label_out.mutable_data<int64_t>(), label.data(), label.size() * sizeof(int64_t));
+
+  auto &boxes = example.features().feature().at(names[2]).float_list().value();
+  auto &boxes_out = ws->Output<CPUBackend>(2);
+  boxes_out.Resize({boxes.size() / 4, 4});
+  std::memcpy(boxes_out.mutable_data<float>(), boxes.data(), boxes.size() * sizeof(float));
+}
+
+/**
+ * @brief Extraction of an encoded image, a label and bounding boxes from a TFRecord
+ *
+ * Args: image size in bytes, number of boxes, number of features which are not read,
+ *       mode (0 - deserializing the tf.Example, 1 - TFRecordParser,
+ *             2 - TFRecordParser with a pinned output for the image, which is copied,
+ *             3 - checking the framing only)
+ */
+void TFRecordParserBench(benchmark::State& st) {  // NOLINT
+  const int image_size = st.range(0);
+  const int num_boxes = st.range(1);
+  const int num_extra_features = st.range(2);
+  const int mode = st.range(3);
+
+  std::string record = MakeTFRecord(image_size, num_boxes, num_extra_features);
+  Tensor<CPUBackend> data;
+  data.set_pinned(false);
+  data.Resize({static_cast<Index>(record.size())});
+  std::memcpy(data.mutable_data<uint8_t>(), record.data(), record.size());
+
+  std::vector<std::string> names = {
+    "image/encoded", "image/class/label", "image/object/bbox"
+  };
+  auto spec = OpSpec("TFRecordReader")
+      .AddArg("feature_names", names)
+      .AddArg("features", std::vector<Feature>{
+        Feature({}, FeatureType::string, Feature::Value{}),
+        Feature({1}, FeatureType::int64, Feature::Value{"", -1}),
+        Feature(FeatureType::float32, Feature::Value{}, {4}) });
+  TFRecordParser parser(spec);
+  parser.PrepareThreads(1);
+
+  HostWorkspace host_ws;
+  SampleWorkspace ws;
+  host_ws.GetSample(&ws, 0, 0);
+  for (int i = 0; i < 3; i++) {
+    auto output = std::make_shared<Tensor<CPUBackend>>();
+    output->set_pinned(mode == 2 && i == 0);
+    ws.AddOutput(output);
+  }
+
+  for (auto _ : st) {
+    switch (mode) {
+      case 0:
+        ParseWithProtobuf(data, names, &ws);
+        break;
+      case 1:
+      case 2:
+        parser.Parse(data, &ws);
+        break;
+      default:
+        benchmark::DoNotOptimize(tfrecord::CheckFraming(
+            span<const uint8_t>(data.data<uint8_t>(), data.size())).data());
+        break;
+    }
+    benchmark::DoNotOptimize(ws.Output<CPUBackend>(0).raw_data());
+  }
+  st.SetBytesProcessed(st.iterations() * record.size());
+}
+
+}  // namespace
+
+BENCHMARK(TFRecordParserBench)
+->Args({16 << 10, 2, 0, 0})
+->Args({16 << 10, 2, 0, 1})
+->Args({128 << 10, 2, 0, 0})
+->Args({128 << 10, 2, 0, 1})
+->Args({128 << 10, 2, 0, 2})
+->Args({128 << 10, 2, 0, 3})
+->Args({128 << 10, 2, 30, 0})
+->Args({128 << 10, 2, 30, 1})
+->Args({1 << 20, 50, 0, 0})
+->Args({1 << 20, 50, 0, 1})
+->Args({1 << 20, 50, 0, 2})
+->Args({1 << 20, 50, 0, 3})
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+}  // namespace dali
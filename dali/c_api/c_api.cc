@@ -13,11 +13,14 @@
 // limitations under the License.
 
 
+#include <cstring>
 #include <string>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
 #include "dali/c_api/c_api.h"
+#include "dali/core/tracing.h"
 #include "dali/pipeline/pipeline.h"
 #include "dali/plugin/copy.h"
 #include "dali/plugin/plugin_manager.h"
@@ -70,6 +73,43 @@ void daliPrefetchSeparate(daliPipelineHandle* pipe_handle,
   }
 }
 
+static void daliWrapExternalInput(dali::TensorList<dali::CPUBackend> *tl, int batch_size,
+                                  const void *data, dali_data_type_t type,
+                                  const int64_t *shapes, int sample_dim) {
+  DALI_ENFORCE(sample_dim > 0, "External input samples must have at least one dimension.");
+  dali::kernels::TensorListShape<> shape(batch_size, sample_dim);
+  for (int i = 0; i < batch_size; i++) {
+    shape.set_tensor_shape(i, dali::kernels::TensorShape<>(
+        std::vector<int64_t>(shapes + i * sample_dim, shapes + (i + 1) * sample_dim)));
+  }
+  dali::TypeInfo type_info = dali::TypeTable::GetTypeInfo(static_cast<dali::DALIDataType>(type));
+  tl->ShareData(const_cast<void *>(data), shape.num_elements() * type_info.size());
+  tl->set_type(type_info);
+  tl->Resize(shape);
+}
+
+void daliSetExternalInput(daliPipelineHandle* pipe_handle, const char *name,
+                          const void *data, dali_data_type_t type,
+                          const int64_t *shapes, int sample_dim) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  dali::TensorList<dali::CPUBackend> tl;
+  daliWrapExternalInput(&tl, pipeline->batch_size(), data, type, shapes, sample_dim);
+  pipeline->SetExternalInput(name, tl);
+}
+
+void daliShareExternalInput(daliPipelineHandle* pipe_handle, const char *name,
+                            const void *data, dali_data_type_t type,
+                            const int64_t *shapes, int sample_dim,
+                            daliExternalInputRelease release, void *user_data) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  dali::TensorList<dali::CPUBackend> tl;
+  daliWrapExternalInput(&tl, pipeline->batch_size(), data, type, shapes, sample_dim);
+  dali::ExternalSourceRelease on_release = [](){};
+  if (release)
+    on_release = [release, user_data]() { release(user_data); };
+  pipeline->SetExternalInput(name, tl, std::move(on_release));
+}
+
 void daliRun(daliPipelineHandle* pipe_handle) {
   dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
   pipeline->RunCPU();
@@ -239,6 +279,59 @@ void daliCopyTensorNTo(daliPipelineHandle* pipe_handle, void* dst, int n, device
   }
 }
 
+void daliGetStats(daliPipelineHandle* pipe_handle,
+                  daliOperatorStats **operators, int *num_operators,
+                  daliStageStats **stages, int *num_stages) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  dali::ExecutorStats stats = pipeline->GetStats();
+
+  *num_operators = stats.operators.size();
+  *operators = static_cast<daliOperatorStats*>(
+      malloc(sizeof(daliOperatorStats) * stats.operators.size()));
+  int i = 0;
+  for (auto &op : stats.operators) {
+    auto &t = op.second;
+    (*operators)[i++] = { strdup(op.first.c_str()), t.run_count, t.total_ms, t.max_ms,
+                          t.last_ms, t.bytes_produced, t.wait_ms };
+  }
+
+  *num_stages = stats.stages.size();
+  *stages = static_cast<daliStageStats*>(malloc(sizeof(daliStageStats) * stats.stages.size()));
+  i = 0;
+  for (auto &stage : stats.stages) {
+    auto &st = stage.second;
+    (*stages)[i++] = { strdup(stage.first.c_str()), st.acquire_count, st.total_wait_ms,
+                       st.max_wait_ms, st.mean_ready(), st.max_ready };
+  }
+}
+
+void daliFreeStats(daliOperatorStats *operators, int num_operators,
+                   daliStageStats *stages, int num_stages) {
+  for (int i = 0; i < num_operators; i++)
+    free(operators[i].name);
+  free(operators);
+  for (int i = 0; i < num_stages; i++)
+    free(stages[i].name);
+  free(stages);
+}
+
+void daliResetStats(daliPipelineHandle* pipe_handle) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  pipeline->ResetStats();
+}
+
+void daliStartTracing() {
+  dali::tracing::Start();
+}
+
+void daliStopTracing() {
+  dali::tracing::Stop();
+}
+
+void daliWriteTrace(const char *path) {
+  dali::tracing::WriteToFile(path);
+}
+
 void daliDeletePipeline(daliPipelineHandle* pipe_handle) {
   dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
   dali::DeviceWorkspace* ws = reinterpret_cast<dali::DeviceWorkspace*>(pipe_handle->ws);
@@ -31,6 +31,52 @@ extern "C" {
     GPU = 1
   };
 
+  /**
+   * @brief Element type of the external input data.
+   * The values are the same as in dali::DALIDataType.
+   */
+  enum dali_data_type_t {
+    DALI_TYPE_UINT8 = 0,
+    DALI_TYPE_INT16 = 1,
+    DALI_TYPE_INT32 = 2,
+    DALI_TYPE_INT64 = 3,
+    DALI_TYPE_FLOAT16 = 4,
+    DALI_TYPE_FLOAT = 5,
+    DALI_TYPE_FLOAT64 = 6,
+    DALI_TYPE_BOOL = 7
+  };
+
+  /**
+   * @brief Called when the pipeline no longer uses the external input data
+   * passed to daliShareExternalInput. May be called from any thread.
+   */
+  typedef void (*daliExternalInputRelease)(void *user_data);
+
+  /**
+   * @brief Timing of an operator run on whole batches, see dali::OperatorTiming
+   */
+  struct daliOperatorStats {
+    char *name;
+    int64_t run_count;
+    double total_ms;
+    double max_ms;
+    double last_ms;
+    int64_t bytes_produced;
+    double wait_ms;
+  };
+
+  /**
+   * @brief Waiting time and queue occupancy of a pipeline stage, see dali::StageStats
+   */
+  struct daliStageStats {
+    char *name;
+    int64_t acquire_count;
+    double total_wait_ms;
+    double max_wait_ms;
+    double mean_ready;
+    int max_ready;
+  };
+
   /**
    * @brief Create DALI pipeline. Setting batch_size,
    * num_threads or device_id here overrides
@@ -51,6 +97,29 @@ extern "C" {
       int cpu_prefetch_queue_depth,
       int gpu_prefetch_queue_depth);
 
+  /**
+   * @brief Set the data of the external input `name` for one of the next iterations.
+   * The batch consists of `batch_size` samples with `sample_dim` dimensions, stored
+   * contiguously in `data`; `shapes` holds `batch_size * sample_dim` extents.
+   * The data is copied, so it can be reused as soon as the function returns.
+   * Blocks while the queue of the external input is full.
+   */
+  DLL_PUBLIC void daliSetExternalInput(daliPipelineHandle* pipe_handle, const char *name,
+                                       const void *data, dali_data_type_t type,
+                                       const int64_t *shapes, int sample_dim);
+
+  /**
+   * @brief Same as daliSetExternalInput, but the data is used without copying.
+   * The memory must stay valid until `release(user_data)` is called, which happens
+   * when the pipeline no longer uses it - at the latest when the pipeline is deleted.
+   * `release` may be NULL if the caller keeps the memory valid for the whole lifetime
+   * of the pipeline.
+   */
+  DLL_PUBLIC void daliShareExternalInput(daliPipelineHandle* pipe_handle, const char *name,
+                                         const void *data, dali_data_type_t type,
+                                         const int64_t *shapes, int sample_dim,
+                                         daliExternalInputRelease release, void *user_data);
+
   /**
    * @brief Start the execution of the pipeline.
    */
@@ -148,6 +217,42 @@ extern "C" {
   DLL_PUBLIC void daliCopyTensorNTo(daliPipelineHandle* pipe_handle, void* dst, int n,
                                     device_type_t dst_type, cudaStream_t stream);
 
+  /**
+   * @brief Return the statistics of all the operators and stages of the pipeline.
+   * @remarks Caller is responsible to release the memory returned with daliFreeStats
+   */
+  DLL_PUBLIC void daliGetStats(daliPipelineHandle* pipe_handle,
+                               daliOperatorStats **operators, int *num_operators,
+                               daliStageStats **stages, int *num_stages);
+
+  /**
+   * @brief Release the statistics returned by daliGetStats.
+   */
+  DLL_PUBLIC void daliFreeStats(daliOperatorStats *operators, int num_operators,
+                                daliStageStats *stages, int num_stages);
+
+  /**
+   * @brief Clear the statistics of the pipeline.
+   */
+  DLL_PUBLIC void daliResetStats(daliPipelineHandle* pipe_handle);
+
+  /**
+   * @brief Start recording the execution timeline of all pipelines in the process,
+   * discarding the previously recorded events.
+   */
+  DLL_PUBLIC void daliStartTracing();
+
+  /**
+   * @brief Stop recording the execution timeline.
+   */
+  DLL_PUBLIC void daliStopTracing();
+
+  /**
+   * @brief Write the recorded timeline to `path` as Chrome trace event JSON,
+   * which can be loaded in chrome://tracing or Perfetto.
+   */
+  DLL_PUBLIC void daliWriteTrace(const char *path);
+
   /**
    * @brief Delete the pipeline object.
    */
@@ -0,0 +1,263 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/core/tracing.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+
+namespace dali {
+namespace tracing {
+
+namespace detail {
+
+std::atomic<bool> enabled{false};
+
+}  // namespace detail
+
+namespace {
+
+struct Event {
+  std::string name;
+  clock::time_point begin, end;
+};
+
+/**
+ * @brief Events of a single thread
+ *
+ * Only the owning thread appends; the events are stored in a list of fixed-size chunks,
+ * which are never moved, so that they can be read concurrently without locking.
+ */
+class ThreadBuffer {
+ public:
+  static constexpr int kChunkSize = 1024;
+
+  ThreadBuffer(int tid, std::string thread_name)
+  : tid(tid), thread_name(std::move(thread_name)), first_(new Chunk()), last_(first_) {}
+
+  ~ThreadBuffer() {
+    Chunk *c = first_;
+    while (c) {
+      Chunk *next = c->next.load(std::memory_order_relaxed);
+      delete c;
+      c = next;
+    }
+  }
+
+  ThreadBuffer(const ThreadBuffer &) = delete;
+  ThreadBuffer &operator=(const ThreadBuffer &) = delete;
+
+  /// @brief Called only by the owning thread
+  void Push(Event &&event) {
+    int n = last_->size.load(std::memory_order_relaxed);
+    if (n == kChunkSize) {
+      Chunk *c = new Chunk();
+      last_->next.store(c, std::memory_order_release);
+      last_ = c;
+      n = 0;
+    }
+    last_->events[n] = std::move(event);
+    last_->size.store(n + 1, std::memory_order_release);
+  }
+
+  /// @brief Can be called from any thread
+  template <typename Callback>
+  void ForEach(Callback &&callback) const {
+    for (Chunk *c = first_; c; c = c->next.load(std::memory_order_acquire)) {
+      int n = c->size.load(std::memory_order_acquire);
+      for (int i = 0; i < n; i++)
+        callback(c->events[i]);
+    }
+  }
+
+  const int tid;
+  /// Guarded by the registry mutex
+  std::string thread_name;
+
+ private:
+  struct Chunk {
+    Event events[kChunkSize];
+    std::atomic<int> size{0};
+    std::atomic<Chunk *> next{nullptr};
+  };
+
+  Chunk *first_;
+  Chunk *last_;
+};
+
+constexpr int ThreadBuffer::kChunkSize;
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  clock::time_point origin = clock::now();
+  /// Incremented by Start(); threads holding buffers of an older generation replace them
+  std::atomic<int> generation{0};
+  std::atomic<int> next_tid{1};
+};
+
+Registry &GetRegistry() {
+  // Never destroyed - threads may still record events during static destruction
+  static Registry *registry = new Registry();
+  return *registry;
+}
+
+struct ThreadState {
+  std::shared_ptr<ThreadBuffer> buffer;
+  int generation = -1;
+  int tid = 0;
+  std::string name;
+};
+
+thread_local ThreadState thread_state;
+
+ThreadBuffer &CurrentBuffer() {
+  auto &registry = GetRegistry();
+  auto &state = thread_state;
+  if (!state.buffer || state.generation != registry.generation.load(std::memory_order_acquire)) {
+    if (state.tid == 0)
+      state.tid = registry.next_tid++;
+    if (state.name.empty())
+      state.name = "Thread " + std::to_string(state.tid);
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    state.buffer = std::make_shared<ThreadBuffer>(state.tid, state.name);
+    state.generation = registry.generation.load(std::memory_order_relaxed);
+    registry.buffers.push_back(state.buffer);
+  }
+  return *state.buffer;
+}
+
+void WriteString(std::ostream &os, const std::string &s) {
+  os << '"';
+  for (char c : s) {
+    switch (c) {
+      case '"':  os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          os << buf;
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+double Microseconds(clock::duration d) {
+  return std::chrono::duration<double, std::micro>(d).count();
+}
+
+}  // namespace
+
+namespace detail {
+
+void RecordEvent(std::string name, clock::time_point begin, clock::time_point end) {
+  CurrentBuffer().Push({ std::move(name), begin, end });
+}
+
+}  // namespace detail
+
+void Start() {
+  auto &registry = GetRegistry();
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.clear();
+    registry.origin = clock::now();
+    registry.generation++;
+  }
+  detail::enabled = true;
+}
+
+void Stop() {
+  detail::enabled = false;
+}
+
+void Write(std::ostream &os) {
+  auto &registry = GetRegistry();
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::vector<std::string> names;
+  clock::time_point origin;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    buffers = registry.buffers;
+    for (auto &b : buffers)
+      names.push_back(b->thread_name);
+    origin = registry.origin;
+  }
+
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&]() {
+    if (!first)
+      os << ",";
+    os << "\n";
+    first = false;
+  };
+  for (size_t i = 0; i < buffers.size(); i++) {
+    separator();
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffers[i]->tid
+       << ",\"args\":{\"name\":";
+    WriteString(os, names[i]);
+    os << "}}";
+  }
+  for (auto &buffer : buffers) {
+    buffer->ForEach([&](const Event &e) {
+      // scopes that started before tracing was (re)started are clipped
+      auto begin = e.begin < origin ? origin : e.begin;
+      separator();
+      os << "{\"name\":";
+      WriteString(os, e.name);
+      os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+         << ",\"ts\":" << Microseconds(begin - origin)
+         << ",\"dur\":" << Microseconds(e.end - begin) << "}";
+    });
+  }
+  os << "\n]}\n";
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void WriteToFile(const std::string &path) {
+  std::ofstream f(path);
+  DALI_ENFORCE(f.good(), "Could not open trace file " + path + " for writing.");
+  Write(f);
+  DALI_ENFORCE(f.good(), "Could not write trace file " + path + ".");
+}
+
+void SetThreadName(const std::string &name) {
+  auto &state = thread_state;
+  state.name = name;
+  if (state.buffer) {
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    state.buffer->thread_name = name;
+  }
+}
+
+}  // namespace tracing
+}  // namespace dali
@@ -0,0 +1,96 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "dali/core/common.h"
+#include "dali/core/tracing.h"
+
+namespace dali {
+
+namespace {
+
+std::string GetTrace() {
+  std::stringstream ss;
+  tracing::Write(ss);
+  return ss.str();
+}
+
+int CountOccurrences(const std::string &s, const std::string &pattern) {
+  int count = 0;
+  for (size_t pos = s.find(pattern); pos != std::string::npos; pos = s.find(pattern, pos + 1))
+    count++;
+  return count;
+}
+
+}  // namespace
+
+TEST(Tracing, DisabledRecordsNothing) {
+  tracing::Start();
+  tracing::Stop();
+  {
+    DALI_TRACE_SCOPE("not recorded");
+    TimeRange tr("not recorded either");
+  }
+  auto trace = GetTrace();
+  EXPECT_EQ(trace.find("not recorded"), std::string::npos) << trace;
+  EXPECT_EQ(CountOccurrences(trace, "\"ph\":\"X\""), 0) << trace;
+}
+
+TEST(Tracing, RecordsScopesPerThread) {
+  tracing::Start();
+  {
+    DALI_TRACE_SCOPE("main scope");
+    TimeRange tr("time range");
+  }
+  std::thread worker([]() {
+    tracing::SetThreadName("test \"worker\"");
+    for (int i = 0; i < 3000; i++) {
+      DALI_TRACE_SCOPE("task " + to_string(i));
+    }
+  });
+  worker.join();
+  tracing::Stop();
+
+  auto trace = GetTrace();
+  EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  EXPECT_EQ(CountOccurrences(trace, "\"name\":\"main scope\""), 1);
+  EXPECT_EQ(CountOccurrences(trace, "\"name\":\"time range\""), 1);
+  EXPECT_EQ(CountOccurrences(trace, "\"name\":\"task 2999\""), 1);
+  // the events of the worker span several chunks
+  EXPECT_EQ(CountOccurrences(trace, "\"ph\":\"X\""), 3002);
+  EXPECT_EQ(CountOccurrences(trace, "\"ph\":\"M\""), 2);
+  EXPECT_NE(trace.find("\"args\":{\"name\":\"test \\\"worker\\\"\"}"), std::string::npos);
+
+  // restarting discards the previous events
+  tracing::Start();
+  tracing::Stop();
+  trace = GetTrace();
+  EXPECT_EQ(CountOccurrences(trace, "\"ph\":\"X\""), 0) << trace;
+}
+
+TEST(Tracing, ScopeEndsEarly) {
+  tracing::Start();
+  {
+    TimeRange tr("stopped range");
+    tr.stop();
+    tr.stop();
+  }
+  tracing::Stop();
+  EXPECT_EQ(CountOccurrences(GetTrace(), "\"name\":\"stopped range\""), 1);
+}
+
+}  // namespace dali
@@ -27,55 +27,70 @@ std::pair<std::shared_ptr<uint8_t>, Image::ImageDims>
 GenericImage::DecodeImpl(DALIImageType image_type,
                          const uint8_t *encoded_buffer,
                          size_t length) const {
-  // Decode image to tmp cv::Mat
-  cv::Mat decoded_image = cv::imdecode(
-    cv::Mat(1, length, CV_8UC1, (void *) (encoded_buffer)),         //NOLINT
-    IsColor(image_type) ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+  const int c = IsColor(image_type) ? 3 : 1;
+  const int flags = IsColor(image_type) ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+  const cv::Mat encoded(1, length, CV_8UC1, (void *) (encoded_buffer));  //NOLINT
+  auto crop_generator = GetCropWindowGenerator();
 
-  int W = decoded_image.cols;
-  int H = decoded_image.rows;
+  std::shared_ptr<uint8_t> decoded_img_ptr;
+  cv::Mat out_mat;
+  int W = 0, H = 0;
 
-  DALI_ENFORCE(decoded_image.data != nullptr, "Unsupported image type.");
+  // Without cropping, try to decode straight to the output memory. This requires
+  // knowing the dimensions upfront, which is not possible for all formats.
+  bool dims_known = false;
+  if (!crop_generator) {
+    try {
+      auto dims = PeekDims(encoded_buffer, length);
+      H = std::get<0>(dims);
+      W = std::get<1>(dims);
+      dims_known = H > 0 && W > 0;
+    } catch (std::exception &) {
+      dims_known = false;
+    }
+  }
 
-  // If required, crop the image
-  auto crop_generator = GetCropWindowGenerator();
-  if (crop_generator) {
-      cv::Mat decoded_image_roi;
-      auto crop = crop_generator(H, W);
-      const int x = crop.x;
-      const int y = crop.y;
-      const int newW = crop.w;
-      const int newH = crop.h;
-      DALI_ENFORCE(newW > 0 && newW <= W);
-      DALI_ENFORCE(newH > 0 && newH <= H);
-      cv::Rect roi(x, y, newW, newH);
-      decoded_image(roi).copyTo(decoded_image_roi);
-      decoded_image = decoded_image_roi;
+  if (dims_known) {
+    decoded_img_ptr = AllocateImage(H, W, c);
+    out_mat = cv::Mat(H, W, CV_8UC(c), decoded_img_ptr.get());
+    cv::Mat decoded_image = cv::imdecode(encoded, flags, &out_mat);
+    DALI_ENFORCE(decoded_image.data != nullptr, "Unsupported image type.");
+    if (decoded_image.data != decoded_img_ptr.get()) {
+      // OpenCV reallocated the image, e.g. because it was rotated according to EXIF
       W = decoded_image.cols;
       H = decoded_image.rows;
-      DALI_ENFORCE(W == newW);
-      DALI_ENFORCE(H == newH);
+      decoded_img_ptr = AllocateImage(H, W, c);
+      out_mat = cv::Mat(H, W, CV_8UC(c), decoded_img_ptr.get());
+      decoded_image.copyTo(out_mat);
+    }
+  } else {
+    // Decode image to tmp cv::Mat
+    cv::Mat decoded_image = cv::imdecode(encoded, flags);
+    DALI_ENFORCE(decoded_image.data != nullptr, "Unsupported image type.");
+    W = decoded_image.cols;
+    H = decoded_image.rows;
+
+    // If required, crop the image
+    if (crop_generator) {
+      auto crop = crop_generator(H, W);
+      DALI_ENFORCE(crop.w > 0 && crop.w <= W);
+      DALI_ENFORCE(crop.h > 0 && crop.h <= H);
+      decoded_image = decoded_image(cv::Rect(crop.x, crop.y, crop.w, crop.h));
+      W = crop.w;
+      H = crop.h;
+    }
+
+    decoded_img_ptr = AllocateImage(H, W, c);
+    out_mat = cv::Mat(H, W, CV_8UC(c), decoded_img_ptr.get());
+    decoded_image.copyTo(out_mat);
+    DALI_ENFORCE(out_mat.data == decoded_img_ptr.get());
   }
 
   // if different image type needed (e.g. RGB), permute from BGR
   if (IsColor(image_type) && image_type != DALI_BGR) {
-    OpenCvColorConversion(DALI_BGR, decoded_image, image_type, decoded_image);
+    OpenCvColorConversion(DALI_BGR, out_mat, image_type, out_mat);
   }
 
-  const int c = IsColor(image_type) ? 3 : 1;
-
-  std::shared_ptr<uint8_t> decoded_img_ptr(
-          decoded_image.ptr(),
-          [decoded_image](decltype(decoded_image.ptr()) ptr) {
-              // This is an empty lambda, which is a custom deleter for
-              // std::shared_ptr.
-              // While instantiating shared_ptr, also lambda is instantiated,
-              // making a copy of cv::Mat. This way, reference counter of cv::Mat
-              // is incremented. Therefore, for the duration of life cycle of
-              // underlying memory in shared_ptr, cv::Mat won't free its memory.
-              // It will be freed, when last shared_ptr is deleted.
-          });
-
   return std::make_pair(decoded_img_ptr, std::make_tuple(H, W, c));
 }
 
@@ -0,0 +1,130 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dali/image/generic_image.h"
+#include "dali/test/dali_test_decoder.h"
+
+namespace dali {
+
+namespace {
+
+void AddImage(ImgSetDescr *imgs, const std::vector<uint8_t> &encoded, const string &name) {
+  auto *data = new uint8[encoded.size()];
+  std::memcpy(data, encoded.data(), encoded.size());
+  imgs->data_.push_back(data);
+  imgs->sizes_.push_back(encoded.size());
+  imgs->filenames_.push_back(name);
+}
+
+/**
+ * Inserts an EXIF (APP1) segment with the given orientation tag right after
+ * the SOI marker of a JPEG stream
+ */
+std::vector<uint8_t> AddExifOrientation(const std::vector<uint8_t> &jpeg, uint16_t orientation) {
+  const uint8_t o_hi = orientation >> 8, o_lo = orientation & 0xFF;
+  const std::vector<uint8_t> app1 = {
+    0xFF, 0xE1, 0x00, 0x22,                           // APP1, segment length 34
+    'E', 'x', 'i', 'f', 0x00, 0x00,
+    'M', 'M', 0x00, 0x2A, 0x00, 0x00, 0x00, 0x08,     // big endian TIFF header
+    0x00, 0x01,                                       // 1 IFD entry
+    0x01, 0x12, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01,   // Orientation, SHORT, count 1
+    o_hi, o_lo, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00                            // no next IFD
+  };
+  std::vector<uint8_t> out(jpeg.begin(), jpeg.begin() + 2);
+  out.insert(out.end(), app1.begin(), app1.end());
+  out.insert(out.end(), jpeg.begin() + 2, jpeg.end());
+  return out;
+}
+
+/**
+ * Decodes with OpenCV, reporting the stored (not EXIF-rotated) dimensions
+ * from PeekDims, as the JPEG decoder does when libjpeg-turbo is not available
+ */
+class StoredDimsImage : public GenericImage {
+ public:
+  StoredDimsImage(const uint8_t *encoded_buffer, size_t length, DALIImageType image_type,
+                  size_t h, size_t w)
+      : GenericImage(encoded_buffer, length, image_type), h_(h), w_(w) {}
+
+ protected:
+  ImageDims PeekDims(const uint8_t *, size_t) const override {
+    return std::make_tuple(h_, w_, 0);
+  }
+
+ private:
+  size_t h_, w_;
+};
+
+}  // namespace
+
+// Fixture for the OpenCV-based (PNG, BMP, TIFF) decode testing. Templated
+// to make googletest run our tests grayscale & rgb
+template <typename ImgType>
+class GenericImageDecodeTest : public GenericDecoderTest<ImgType> {
+ protected:
+  /// The JPEG test images re-encoded as BMP
+  void EncodeBMPs(ImgSetDescr *bmps) {
+    for (size_t i = 0; i < this->jpegs_.nImages(); i++) {
+      cv::Mat encoded(1, this->jpegs_.sizes_[i], CV_8UC1, this->jpegs_.data_[i]);
+      std::vector<uint8_t> bmp;
+      ASSERT_TRUE(cv::imencode(".bmp", cv::imdecode(encoded, cv::IMREAD_COLOR), bmp));
+      AddImage(bmps, bmp, std::to_string(i) + ".bmp");
+    }
+  }
+};
+
+typedef ::testing::Types<RGB, BGR, Gray> Types;
+TYPED_TEST_SUITE(GenericImageDecodeTest, Types);
+
+TYPED_TEST(GenericImageDecodeTest, DecodePNGHostToOutput) {
+  this->RunTestDecodeToOutput(this->png_);
+}
+
+TYPED_TEST(GenericImageDecodeTest, DecodeBMPHostToOutput) {
+  ImgSetDescr bmps;
+  this->EncodeBMPs(&bmps);
+  this->RunTestDecodeToOutput(bmps);
+}
+
+TYPED_TEST(GenericImageDecodeTest, DecodeTiffHostToOutput) {
+  this->RunTestDecodeToOutput(this->tiff_);
+}
+
+// OpenCV applies the EXIF orientation, so the image does not fit the memory allocated
+// for the peeked dimensions and is copied to a newly allocated output
+TYPED_TEST(GenericImageDecodeTest, DecodeExifRotatedHostToOutput) {
+  cv::Mat encoded(1, this->jpegs_.sizes_[0], CV_8UC1, this->jpegs_.data_[0]);
+  cv::Mat decoded = cv::imdecode(encoded, cv::IMREAD_COLOR);
+  // make sure the rotated image has a different shape
+  const int h = std::min(decoded.rows, decoded.cols / 2);
+  const int w = decoded.cols;
+  std::vector<uint8_t> jpeg;
+  ASSERT_TRUE(cv::imencode(".jpg", decoded(cv::Rect(0, 0, w, h)), jpeg));
+
+  ImgSetDescr imgs;
+  AddImage(&imgs, AddExifOrientation(jpeg, 6), "rotated.jpg");  // 6 - rotate 90 CW
+
+  StoredDimsImage image(imgs.data_[0], imgs.sizes_[0], this->img_type_, h, w);
+  this->VerifyDecodeToOutput(&image, imgs, 0);
+  const auto dims = image.GetImageDims();
+  EXPECT_EQ(static_cast<int>(std::get<0>(dims)), w);
+  EXPECT_EQ(static_cast<int>(std::get<1>(dims)), h);
+}
+
+}  // namespace dali
@@ -68,6 +68,16 @@ std::shared_ptr<uint8_t> Image::GetImage() const {
 }
 
 
+std::shared_ptr<uint8_t> Image::AllocateImage(size_t h, size_t w, size_t c) const {
+  if (output_allocator_) {
+    uint8_t *data = output_allocator_(h, w, c);
+    DALI_ENFORCE(data != nullptr, "Output allocator returned a null pointer");
+    return std::shared_ptr<uint8_t>(data, [](uint8_t *) {});
+  }
+  return std::shared_ptr<uint8_t>(new uint8_t[h * w * c], [](uint8_t *data) { delete[] data; });
+}
+
+
 std::tuple<size_t, size_t, size_t> Image::GetImageDims() const {
   if (decoded_) {
     return dims_;
@@ -38,6 +38,12 @@ DLL_PUBLIC bool HasKnownImageExtension(const std::string &image_path);
 
 class Image {
  public:
+  /**
+   * Provides memory for the decoded image, given its (height, width, channels).
+   * The memory is owned by the caller and has to outlive the Image object.
+   */
+  using OutputAllocator = std::function<uint8_t *(size_t, size_t, size_t)>;
+
   /**
    * Perform image decoding. Actual implementation is defined
    * by DecodeImpl template method
@@ -54,10 +60,13 @@ class Image {
   /**
    * Populates given data buffer with decoded image.
    * User is responsible for allocating `dst` buffer.
+   * If the image was decoded directly to `dst`, nothing is copied.
    */
   template<typename DstType>
   void GetImage(DstType *dst) const {
     DALI_ENFORCE(decoded_image_ && decoded_, "Image hasn't been decoded, call Decode(...)");
+    if (reinterpret_cast<const uint8_t *>(dst) == decoded_image_.get())
+      return;
     std::memcpy(dst, decoded_image_.get(), dims_multiply() * sizeof(DstType));
   }
 
@@ -92,6 +101,29 @@ class Image {
     };
   }
 
+  /**
+   * Makes the decoder write the image to memory provided by `allocator`,
+   * instead of allocating a buffer of its own.
+   * The allocator may be called more than once, if the decoder falls back to
+   * a different implementation - only the memory returned by the last call is used.
+   */
+  inline void SetOutputAllocator(OutputAllocator allocator) {
+    output_allocator_ = std::move(allocator);
+  }
+
+  /**
+   * Allows the decoder to reduce the resolution of the image (e.g. with IDCT scaling
+   * for JPEG), as long as the shorter side of the decoded, cropped image is not smaller
+   * than `min_size`. 0 disables the downscaling.
+   */
+  inline void SetMinDecodeSize(int min_size) {
+    min_decode_size_ = min_size;
+  }
+
+  inline int MinDecodeSize() const {
+    return min_decode_size_;
+  }
+
   inline void SetUseFastIdct(bool use_fast_idct) {
     use_fast_idct_ = use_fast_idct;
   }
@@ -134,6 +166,12 @@ class Image {
     return crop_window_generator_;
   }
 
+  /**
+   * Allocates memory for the decoded image, using the output allocator, if set.
+   * Memory obtained from the output allocator is not owned by the returned pointer.
+   */
+  std::shared_ptr<uint8_t> AllocateImage(size_t h, size_t w, size_t c) const;
+
  private:
   inline size_t dims_multiply() const {
     // There's no elegant way in C++11
@@ -146,8 +184,10 @@ class Image {
   const DALIImageType image_type_;
   bool decoded_ = false;
   bool use_fast_idct_ = false;
+  int min_decode_size_ = 0;
   ImageDims dims_;
   CropWindowGenerator crop_window_generator_;
+  OutputAllocator output_allocator_;
   std::shared_ptr<uint8_t> decoded_image_ = nullptr;
 };
 
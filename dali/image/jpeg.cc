@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "dali/image/jpeg.h"
+#include <algorithm>
 #include <cmath>
 #include <memory>
 #include "dali/image/jpeg_mem.h"
@@ -57,6 +58,39 @@ bool get_jpeg_size(const uint8 *data, size_t data_size, int *height, int *width)
 }
 #endif
 
+#ifdef DALI_USE_JPEG_TURBO
+namespace {
+
+/**
+ * Selects the largest IDCT scaling denominator (1, 2, 4 or 8) that keeps
+ * the shorter side of a `region_h` x `region_w` region at least `min_size` pixels.
+ */
+int SelectScaleRatio(int region_h, int region_w, int min_size) {
+  if (min_size <= 0)
+    return 1;
+  const int shorter = std::min(region_h, region_w);
+  int ratio = 1;
+  while (ratio < 8 && shorter / (ratio * 2) >= min_size)
+    ratio *= 2;
+  return ratio;
+}
+
+/**
+ * Maps a crop window given in the coordinates of the full image to the smallest window
+ * in an image downscaled by `ratio` (as done by libjpeg: size = ceil(size / ratio))
+ * that covers it.
+ */
+CropWindow ScaleCropWindow(const CropWindow &crop, int ratio, int scaled_h, int scaled_w) {
+  const int x0 = crop.x / ratio;
+  const int y0 = crop.y / ratio;
+  const int x1 = std::min(scaled_w, (crop.x + crop.w + ratio - 1) / ratio);
+  const int y1 = std::min(scaled_h, (crop.y + crop.h + ratio - 1) / ratio);
+  return CropWindow(x0, y0, x1 - x0, y1 - y0);
+}
+
+}  // namespace
+#endif  // DALI_USE_JPEG_TURBO
+
 std::pair<std::shared_ptr<uint8_t>, Image::ImageDims>
 JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) const {
   const int c = IsColor(type) ? 3 : 1;
@@ -82,11 +116,28 @@ JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) cons
   flags.components = c;
 
   flags.crop = false;
+  CropWindow crop;
   auto crop_window_generator = GetCropWindowGenerator();
   if (crop_window_generator) {
     flags.crop = true;
-    auto crop = crop_window_generator(h, w);
+    crop = crop_window_generator(h, w);
     DALI_ENFORCE(crop.IsInRange(h, w));
+  }
+
+  // Decode at reduced resolution (IDCT scaling), if the requested size allows it.
+  // The crop window is generated for the full image and mapped to the scaled one.
+  const int full_h = static_cast<int>(h);
+  const int full_w = static_cast<int>(w);
+  flags.ratio = flags.crop
+      ? SelectScaleRatio(crop.h, crop.w, MinDecodeSize())
+      : SelectScaleRatio(full_h, full_w, MinDecodeSize());
+  if (flags.ratio > 1 && flags.crop) {
+    const int scaled_h = (full_h + flags.ratio - 1) / flags.ratio;
+    const int scaled_w = (full_w + flags.ratio - 1) / flags.ratio;
+    crop = ScaleCropWindow(crop, flags.ratio, scaled_h, scaled_w);
+  }
+
+  if (flags.crop) {
     flags.crop_x = crop.x;
     flags.crop_y = crop.y;
     flags.crop_width = crop.w;
@@ -102,10 +153,9 @@ JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) cons
   int cropped_w = 0;
   uint8_t* result = jpeg::Uncompress(
     jpeg, length, flags, nullptr /* nwarn */,
-    [&decoded_image, &cropped_h, &cropped_w](int width, int height, int channels) -> uint8* {
-      decoded_image.reset(
-        new uint8_t[height * width * channels],
-        [](uint8_t* data){ delete [] data; } );
+    [this, &decoded_image, &cropped_h, &cropped_w](int width, int height, int channels)
+        -> uint8* {
+      decoded_image = AllocateImage(height, width, channels);
       cropped_h = height;
       cropped_w = width;
       return decoded_image.get();
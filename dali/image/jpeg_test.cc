@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include "dali/test/dali_test_decoder.h"
 
 namespace dali {
@@ -30,4 +31,50 @@ TYPED_TEST(JpegDecodeTest, DecodeJPEGHost) {
   this->RunTestDecode(this->jpegs_);
 }
 
+TYPED_TEST(JpegDecodeTest, DecodeJPEGHostToOutput) {
+  this->RunTestDecodeToOutput(this->jpegs_);
+}
+
+#ifdef DALI_USE_JPEG_TURBO
+TYPED_TEST(JpegDecodeTest, DecodeJPEGHostScaled) {
+  const auto &imgs = this->jpegs_;
+  for (size_t i = 0; i < imgs.nImages(); i++) {
+    auto full = ImageFactory::CreateImage(imgs.data_[i], imgs.sizes_[i], this->img_type_);
+    const auto dims = full->GetImageDims();
+    const int H = std::get<0>(dims);
+    const int W = std::get<1>(dims);
+    const int min_size = std::max(std::min(H, W) / 5, 1);
+    // the largest power-of-two ratio, not exceeding 8, that keeps the shorter side >= min_size
+    int ratio = 1;
+    while (ratio < 8 && std::min(H, W) / (ratio * 2) >= min_size)
+      ratio *= 2;
+
+    auto scaled = ImageFactory::CreateImage(imgs.data_[i], imgs.sizes_[i], this->img_type_);
+    scaled->SetMinDecodeSize(min_size);
+    scaled->Decode();
+    auto scaled_dims = scaled->GetImageDims();
+    EXPECT_EQ(static_cast<int>(std::get<0>(scaled_dims)), (H + ratio - 1) / ratio);
+    EXPECT_EQ(static_cast<int>(std::get<1>(scaled_dims)), (W + ratio - 1) / ratio);
+    EXPECT_GE(static_cast<int>(std::min(std::get<0>(scaled_dims), std::get<1>(scaled_dims))),
+              min_size);
+
+    // the crop window is mapped to the scaled image and covers the requested region
+    auto cropped = ImageFactory::CreateImage(imgs.data_[i], imgs.sizes_[i], this->img_type_);
+    cropped->SetMinDecodeSize(1);
+    cropped->SetCropWindow(CropWindow(W / 4 + 1, H / 4 + 1, W / 2, H / 2));
+    cropped->Decode();
+    auto cropped_dims = cropped->GetImageDims();
+    int crop_ratio = 1;
+    while (crop_ratio < 8 && std::min(H / 2, W / 2) / (crop_ratio * 2) >= 1)
+      crop_ratio *= 2;
+    const int y0 = (H / 4 + 1) / crop_ratio;
+    const int y1 = (H / 4 + 1 + H / 2 + crop_ratio - 1) / crop_ratio;
+    const int x0 = (W / 4 + 1) / crop_ratio;
+    const int x1 = (W / 4 + 1 + W / 2 + crop_ratio - 1) / crop_ratio;
+    EXPECT_EQ(static_cast<int>(std::get<0>(cropped_dims)), y1 - y0);
+    EXPECT_EQ(static_cast<int>(std::get<1>(cropped_dims)), x1 - x0);
+  }
+}
+#endif  // DALI_USE_JPEG_TURBO
+
 }  // namespace dali
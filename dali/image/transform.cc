@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "dali/image/transform.h"
+#include "dali/kernels/imgproc/color_twist_cpu.h"
 
 #include "dali/util/image.h"
 #include "dali/util/ocv.h"
@@ -178,39 +179,13 @@ void CheckParam(const Tensor<CPUBackend> &input, const std::string &opName) {
                opName + " supports hwc rgb & grayscale inputs.");
 }
 
-typedef cv::Vec<uchar, 1> Vec1b;
-
 DALIError_t MakeColorTransformation(const uint8 *img, int H, int W, int C,
                                     const float *matr, uint8 *out_img) {
-  const int channel_flag = C == 3 ? CV_8UC3 : CV_8UC1;
-
-  const cv::Mat cv_imgIn = CreateMatFromPtr(H, W, channel_flag, img);
-  cv::Mat cv_imgOut = CreateMatFromPtr(H, W, channel_flag, out_img);
-
-  if (C == 1) {
-    for (int y = 0; y < H; ++y) {
-      for (int x = 0; x < W; ++x) {
-        cv_imgOut.at<Vec1b>(y, x)[0] =
-            cv::saturate_cast<uint8>((matr[0] * cv_imgIn.at<Vec1b>(y, x)[0]) + matr[1]);
-      }
-    }
-  } else {
-    for (int y = 0; y < H; ++y) {
-      for (int x = 0; x < W; ++x) {
-        // Using direct calculation because they are 25% faster
-        // than two loops which could be used here
-        const auto &inpPix = cv_imgIn.at<cv::Vec3b>(y, x);
-        auto &outPix = cv_imgOut.at<cv::Vec3b>(y, x);
-        outPix[0] = cv::saturate_cast<uint8>
-          (inpPix[0] * matr[0] + inpPix[1] * matr[1] + inpPix[2] * matr[2] + matr[3]);
-        outPix[1] = cv::saturate_cast<uint8>
-          (inpPix[0] * matr[4] + inpPix[1] * matr[5] + inpPix[2] * matr[6] + matr[7]);
-        outPix[2] = cv::saturate_cast<uint8>
-          (inpPix[0] * matr[8] + inpPix[1] * matr[9] + inpPix[2] * matr[10] + matr[11]);
-      }
-    }
-  }
-
+  kernels::ColorTwistParams params;
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 4; j++)
+      params.matrix[i][j] = matr[i * 4 + j];
+  kernels::ColorTwist(out_img, img, static_cast<int64_t>(H) * W, C, params);
   return DALISuccess;
 }
 
@@ -0,0 +1,133 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_COLOR_TWIST_CPU_H_
+#define DALI_KERNELS_IMGPROC_COLOR_TWIST_CPU_H_
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "dali/core/common.h"
+#include "dali/core/error_handling.h"
+#include "dali/kernels/kernel.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Affine color transformation, optionally followed by normalization
+ *
+ * For each pixel, the intermediate value is `clamp(M * in + offset, 0, 255)`, where
+ * `M` is the left 3x3 part of `matrix` and `offset` is its last column.
+ * For integral output, the value is rounded to nearest, ties to even (as cv::saturate_cast);
+ * for floating point output, the value is normalized: `(value - mean[c]) * inv_stddev[c]`.
+ *
+ * For single-channel images the value is `matrix[0][0] * in + matrix[0][3]`, the same as
+ * in the GPU implementation (nppiColorTwist32f_8u_C1R).
+ */
+struct ColorTwistParams {
+  float matrix[3][4] = {
+    { 1, 0, 0, 0 },
+    { 0, 1, 0, 0 },
+    { 0, 0, 1, 0 }
+  };
+  float mean[3] = { 0, 0, 0 };
+  float inv_stddev[3] = { 1, 1, 1 };
+};
+
+/// @brief Reference implementation; `out` and `in` may point to the same memory
+template <typename Out>
+void ColorTwistScalar(Out *out, const uint8_t *in, int64_t num_pixels, int channels,
+                      const ColorTwistParams &params) {
+  const auto &m = params.matrix;
+  auto convert = [&](float v, int c) -> Out {
+    v = v < 0 ? 0 : v > 255 ? 255 : v;
+    if (std::is_integral<Out>::value)
+      return static_cast<Out>(std::nearbyint(v));
+    else
+      return (v - params.mean[c]) * params.inv_stddev[c];
+  };
+
+  if (channels == 1) {
+    for (int64_t i = 0; i < num_pixels; i++)
+      out[i] = convert(in[i] * m[0][0] + m[0][3], 0);
+  } else {
+    for (int64_t i = 0; i < num_pixels; i++) {
+      const float r = in[3*i], g = in[3*i+1], b = in[3*i+2];
+      out[3*i]   = convert(r * m[0][0] + g * m[0][1] + b * m[0][2] + m[0][3], 0);
+      out[3*i+1] = convert(r * m[1][0] + g * m[1][1] + b * m[1][2] + m[1][3], 1);
+      out[3*i+2] = convert(r * m[2][0] + g * m[2][1] + b * m[2][2] + m[2][3], 2);
+    }
+  }
+}
+
+/// @brief Vectorized (AVX2) color twist, selected at run time.
+///
+/// The results are bit-exact with ColorTwistScalar.
+/// @return number of pixels processed - the remaining ones should be processed
+///         with ColorTwistScalar; 0 if the CPU is not supported.
+#define DALI_DECLARE_COLOR_TWIST_SIMD(Out)                                               \
+int64_t ColorTwistSIMD(Out *out, const uint8_t *in, int64_t num_pixels, int channels,    \
+                       const ColorTwistParams &params);
+
+DALI_DECLARE_COLOR_TWIST_SIMD(uint8_t)
+DALI_DECLARE_COLOR_TWIST_SIMD(float)
+
+#undef DALI_DECLARE_COLOR_TWIST_SIMD
+
+template <typename Out>
+void ColorTwist(Out *out, const uint8_t *in, int64_t num_pixels, int channels,
+                const ColorTwistParams &params) {
+  DALI_ENFORCE(channels == 1 || channels == 3,
+               "Color twist supports 1 or 3 channels, got " + std::to_string(channels));
+  int64_t done = ColorTwistSIMD(out, in, num_pixels, channels, params);
+  ColorTwistScalar(out + done * channels, in + done * channels, num_pixels - done, channels,
+                   params);
+}
+
+/**
+ * @brief Applies a ColorTwistParams transformation to a HWC uint8 image with 1 or 3 channels
+ *
+ * The output has the same shape as the input. For uint8 output, the operation can be
+ * performed in place.
+ */
+template <typename Out>
+struct ColorTwistCPU {
+  static_assert(std::is_same<Out, uint8_t>::value || std::is_same<Out, float>::value,
+                "Color twist output must be uint8_t or float");
+
+  KernelRequirements Setup(KernelContext &context,
+                           const InTensorCPU<uint8_t, 3> &in,
+                           const ColorTwistParams &params) {
+    DALI_ENFORCE(in.shape[2] == 1 || in.shape[2] == 3,
+                 "Color twist supports 1 or 3 channels");
+    KernelRequirements req;
+    req.output_shapes = { TensorListShape<DynamicDimensions>({ in.shape }) };
+    return req;
+  }
+
+  void Run(KernelContext &context,
+           const OutTensorCPU<Out, 3> &out,
+           const InTensorCPU<uint8_t, 3> &in,
+           const ColorTwistParams &params) {
+    DALI_ENFORCE(out.shape == in.shape, "Output shape must match the input shape");
+    ColorTwist(out.data, in.data, in.shape[0] * in.shape[1], in.shape[2], params);
+  }
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_COLOR_TWIST_CPU_H_
@@ -0,0 +1,314 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Vectorized color twist. The functions are compiled for AVX2 with target attributes
+// and selected at run time, so the rest of the library keeps the baseline ISA.
+//
+// Interleaved pixels are split into channel planes with byte shuffles, transformed
+// 8 pixels at a time and interleaved back. The order of operations is the same as in
+// ColorTwistScalar and no FMA is used (the file is built with -ffp-contract=off),
+// so the results are bit-exact.
+
+#include <cstdint>
+#include "dali/core/cpu_features.h"
+#include "dali/kernels/imgproc/color_twist_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+#if DALI_X86_SIMD
+
+namespace {
+
+/**
+ * @brief Shuffle and permutation tables for 3-channel (de)interleaving
+ *
+ * Calculated from the flat index of each element, instead of being spelled out.
+ */
+struct InterleaveTables {
+  /// deinterleave[c][v] - gathers the bytes of channel `c` found in the input vector `v`
+  alignas(16) int8_t deinterleave[3][3][16];
+  /// interleave[v][c] - places the bytes of channel `c` in the output vector `v`
+  alignas(16) int8_t interleave[3][3][16];
+  /// permute[v][c] - places the floats of channel `c` in the output vector `v`...
+  alignas(32) int32_t permute[3][3][8];
+  /// ...where select[v][c] is set
+  alignas(32) int32_t select[3][3][8];
+
+  InterleaveTables() {
+    for (int c = 0; c < 3; c++) {
+      for (int v = 0; v < 3; v++) {
+        for (int j = 0; j < 16; j++) {
+          int s = 3 * j + c;  // pixel j, channel c in the interleaved data
+          deinterleave[c][v][j] = s / 16 == v ? s % 16 : -1;
+          int d = 16 * v + j;  // byte j of output vector v
+          interleave[v][c][j] = d % 3 == c ? d / 3 : -1;
+        }
+        for (int j = 0; j < 8; j++) {
+          int d = 8 * v + j;
+          permute[v][c][j] = d % 3 == c ? d / 3 % 8 : 0;
+          select[v][c][j] = d % 3 == c ? -1 : 0;
+        }
+      }
+    }
+  }
+};
+
+const InterleaveTables &GetInterleaveTables() {
+  static const InterleaveTables tables;
+  return tables;
+}
+
+DALI_TARGET_AVX2 inline __m128i LoadMask(const int8_t *mask) {
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+}
+
+DALI_TARGET_AVX2 inline __m256i LoadIndices(const int32_t *idx) {
+  return _mm256_load_si256(reinterpret_cast<const __m256i *>(idx));
+}
+
+/// Gathers the bytes from 3 vectors with 3 shuffle masks
+DALI_TARGET_AVX2 inline __m128i Shuffle3(__m128i a0, __m128i a1, __m128i a2,
+                                         const __m128i (&mask)[3]) {
+  return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mask[0]),
+                                   _mm_shuffle_epi8(a1, mask[1])),
+                      _mm_shuffle_epi8(a2, mask[2]));
+}
+
+DALI_TARGET_AVX2 inline __m256 LoLo(__m128i bytes) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+}
+
+DALI_TARGET_AVX2 inline __m256 HiLo(__m128i bytes) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+}
+
+DALI_TARGET_AVX2 inline __m256 Clamp255(__m256 v) {
+  return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+}
+
+/// Same as the conversion in ColorTwistScalar: clamp and round in the current rounding
+/// mode - to nearest, ties to even, by default
+DALI_TARGET_AVX2 inline __m128i ToBytes(__m256 lo, __m256 hi) {
+  __m256i ilo = _mm256_cvtps_epi32(Clamp255(lo));
+  __m256i ihi = _mm256_cvtps_epi32(Clamp255(hi));
+  __m128i wlo = _mm_packs_epi32(_mm256_castsi256_si128(ilo), _mm256_extracti128_si256(ilo, 1));
+  __m128i whi = _mm_packs_epi32(_mm256_castsi256_si128(ihi), _mm256_extracti128_si256(ihi, 1));
+  return _mm_packus_epi16(wlo, whi);
+}
+
+DALI_TARGET_AVX2 inline __m256 Normalize(__m256 v, __m256 mean, __m256 inv_stddev) {
+  return _mm256_mul_ps(_mm256_sub_ps(Clamp255(v), mean), inv_stddev);
+}
+
+struct MatrixRow {
+  __m256 m0, m1, m2, offset;
+};
+
+DALI_TARGET_AVX2 inline MatrixRow LoadRow(const float *row) {
+  return { _mm256_set1_ps(row[0]), _mm256_set1_ps(row[1]),
+           _mm256_set1_ps(row[2]), _mm256_set1_ps(row[3]) };
+}
+
+DALI_TARGET_AVX2 inline __m256 Apply(const MatrixRow &m, __m256 r, __m256 g, __m256 b) {
+  __m256 v = _mm256_add_ps(_mm256_mul_ps(r, m.m0), _mm256_mul_ps(g, m.m1));
+  v = _mm256_add_ps(v, _mm256_mul_ps(b, m.m2));
+  return _mm256_add_ps(v, m.offset);
+}
+
+/// 16 pixels, split into channel planes and converted to float; 8 pixels per vector
+struct Planes16 {
+  __m256 r0, r1, g0, g1, b0, b1;
+};
+
+DALI_TARGET_AVX2 inline Planes16 Load16(const uint8_t *in, const __m128i (&mask)[3][3]) {
+  __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16));
+  __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 32));
+  __m128i r = Shuffle3(a0, a1, a2, mask[0]);
+  __m128i g = Shuffle3(a0, a1, a2, mask[1]);
+  __m128i b = Shuffle3(a0, a1, a2, mask[2]);
+  return { LoLo(r), HiLo(r), LoLo(g), HiLo(g), LoLo(b), HiLo(b) };
+}
+
+DALI_TARGET_AVX2 inline Planes16 Transform16(const Planes16 &p, const MatrixRow &m0,
+                                             const MatrixRow &m1, const MatrixRow &m2) {
+  return {
+    Apply(m0, p.r0, p.g0, p.b0), Apply(m0, p.r1, p.g1, p.b1),
+    Apply(m1, p.r0, p.g0, p.b0), Apply(m1, p.r1, p.g1, p.b1),
+    Apply(m2, p.r0, p.g0, p.b0), Apply(m2, p.r1, p.g1, p.b1)
+  };
+}
+
+DALI_TARGET_AVX2 int64_t ColorTwist3AVX2(uint8_t *out, const uint8_t *in, int64_t num_pixels,
+                                         const ColorTwistParams &params) {
+  const auto &t = GetInterleaveTables();
+  __m128i deinterleave[3][3], interleave[3][3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      deinterleave[i][j] = LoadMask(t.deinterleave[i][j]);
+      interleave[i][j] = LoadMask(t.interleave[i][j]);
+    }
+  }
+  const MatrixRow m0 = LoadRow(params.matrix[0]);
+  const MatrixRow m1 = LoadRow(params.matrix[1]);
+  const MatrixRow m2 = LoadRow(params.matrix[2]);
+  int64_t i = 0;
+  for (; i + 16 <= num_pixels; i += 16) {
+    Planes16 v = Transform16(Load16(in + 3 * i, deinterleave), m0, m1, m2);
+    __m128i r = ToBytes(v.r0, v.r1);
+    __m128i g = ToBytes(v.g0, v.g1);
+    __m128i b = ToBytes(v.b0, v.b1);
+    // all input is loaded before anything is stored, so in-place operation is fine
+    __m128i *o = reinterpret_cast<__m128i *>(out + 3 * i);
+    _mm_storeu_si128(o, Shuffle3(r, g, b, interleave[0]));
+    _mm_storeu_si128(o + 1, Shuffle3(r, g, b, interleave[1]));
+    _mm_storeu_si128(o + 2, Shuffle3(r, g, b, interleave[2]));
+  }
+  return i;
+}
+
+/// Permutation indices and blend masks for interleaving 8 pixels of float planes
+struct FloatInterleave {
+  __m256i perm[3][3];
+  __m256 select_g[3], select_b[3];
+};
+
+DALI_TARGET_AVX2 inline FloatInterleave LoadFloatInterleave(const InterleaveTables &t) {
+  FloatInterleave fi;
+  for (int k = 0; k < 3; k++) {
+    for (int c = 0; c < 3; c++)
+      fi.perm[k][c] = LoadIndices(t.permute[k][c]);
+    fi.select_g[k] = _mm256_castsi256_ps(LoadIndices(t.select[k][1]));
+    fi.select_b[k] = _mm256_castsi256_ps(LoadIndices(t.select[k][2]));
+  }
+  return fi;
+}
+
+DALI_TARGET_AVX2 inline __m256 Interleave(__m256 r, __m256 g, __m256 b,
+                                          const FloatInterleave &fi, int k) {
+  __m256 o = _mm256_permutevar8x32_ps(r, fi.perm[k][0]);
+  o = _mm256_blendv_ps(o, _mm256_permutevar8x32_ps(g, fi.perm[k][1]), fi.select_g[k]);
+  return _mm256_blendv_ps(o, _mm256_permutevar8x32_ps(b, fi.perm[k][2]), fi.select_b[k]);
+}
+
+/// Interleaves 8 pixels given as channel planes and stores them as 24 floats
+DALI_TARGET_AVX2 inline void StoreInterleaved(float *out, __m256 r, __m256 g, __m256 b,
+                                              const FloatInterleave &fi) {
+  _mm256_storeu_ps(out,      Interleave(r, g, b, fi, 0));
+  _mm256_storeu_ps(out + 8,  Interleave(r, g, b, fi, 1));
+  _mm256_storeu_ps(out + 16, Interleave(r, g, b, fi, 2));
+}
+
+DALI_TARGET_AVX2 int64_t ColorTwist3AVX2(float *out, const uint8_t *in, int64_t num_pixels,
+                                         const ColorTwistParams &params) {
+  const auto &t = GetInterleaveTables();
+  __m128i deinterleave[3][3];
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      deinterleave[i][j] = LoadMask(t.deinterleave[i][j]);
+  const FloatInterleave fi = LoadFloatInterleave(t);
+  const MatrixRow m0 = LoadRow(params.matrix[0]);
+  const MatrixRow m1 = LoadRow(params.matrix[1]);
+  const MatrixRow m2 = LoadRow(params.matrix[2]);
+  const __m256 mean_r = _mm256_set1_ps(params.mean[0]);
+  const __m256 mean_g = _mm256_set1_ps(params.mean[1]);
+  const __m256 mean_b = _mm256_set1_ps(params.mean[2]);
+  const __m256 inv_stddev_r = _mm256_set1_ps(params.inv_stddev[0]);
+  const __m256 inv_stddev_g = _mm256_set1_ps(params.inv_stddev[1]);
+  const __m256 inv_stddev_b = _mm256_set1_ps(params.inv_stddev[2]);
+  int64_t i = 0;
+  for (; i + 16 <= num_pixels; i += 16) {
+    Planes16 v = Transform16(Load16(in + 3 * i, deinterleave), m0, m1, m2);
+    StoreInterleaved(out + 3 * i,
+                     Normalize(v.r0, mean_r, inv_stddev_r),
+                     Normalize(v.g0, mean_g, inv_stddev_g),
+                     Normalize(v.b0, mean_b, inv_stddev_b), fi);
+    StoreInterleaved(out + 3 * i + 24,
+                     Normalize(v.r1, mean_r, inv_stddev_r),
+                     Normalize(v.g1, mean_g, inv_stddev_g),
+                     Normalize(v.b1, mean_b, inv_stddev_b), fi);
+  }
+  return i;
+}
+
+DALI_TARGET_AVX2 int64_t ColorTwist1AVX2(uint8_t *out, const uint8_t *in, int64_t num_pixels,
+                                         const ColorTwistParams &params) {
+  const auto &m = params.matrix;
+  const __m256 gain = _mm256_set1_ps(m[0][0]);
+  const __m256 offset = _mm256_set1_ps(m[0][3]);
+  int64_t i = 0;
+  for (; i + 16 <= num_pixels; i += 16) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    __m256 lo = _mm256_add_ps(_mm256_mul_ps(LoLo(bytes), gain), offset);
+    __m256 hi = _mm256_add_ps(_mm256_mul_ps(HiLo(bytes), gain), offset);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), ToBytes(lo, hi));
+  }
+  return i;
+}
+
+DALI_TARGET_AVX2 int64_t ColorTwist1AVX2(float *out, const uint8_t *in, int64_t num_pixels,
+                                         const ColorTwistParams &params) {
+  const auto &m = params.matrix;
+  const __m256 gain = _mm256_set1_ps(m[0][0]);
+  const __m256 offset = _mm256_set1_ps(m[0][3]);
+  const __m256 mean = _mm256_set1_ps(params.mean[0]);
+  const __m256 inv_stddev = _mm256_set1_ps(params.inv_stddev[0]);
+  int64_t i = 0;
+  for (; i + 8 <= num_pixels; i += 8) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+    __m256 v = _mm256_add_ps(_mm256_mul_ps(LoLo(bytes), gain), offset);
+    _mm256_storeu_ps(out + i, Normalize(v, mean, inv_stddev));
+  }
+  return i;
+}
+
+template <typename Out>
+int64_t ColorTwistSIMDImpl(Out *out, const uint8_t *in, int64_t num_pixels, int channels,
+                           const ColorTwistParams &params) {
+  if (!HasAVX2())
+    return 0;
+  if (channels == 3)
+    return ColorTwist3AVX2(out, in, num_pixels, params);
+  else if (channels == 1)
+    return ColorTwist1AVX2(out, in, num_pixels, params);
+  return 0;
+}
+
+}  // namespace
+
+#else  // DALI_X86_SIMD
+
+namespace {
+
+template <typename Out>
+int64_t ColorTwistSIMDImpl(Out *, const uint8_t *, int64_t, int, const ColorTwistParams &) {
+  return 0;
+}
+
+}  // namespace
+
+#endif  // DALI_X86_SIMD
+
+#define DALI_INSTANTIATE_COLOR_TWIST_SIMD(Out)                                             \
+int64_t ColorTwistSIMD(Out *out, const uint8_t *in, int64_t num_pixels, int channels,      \
+                       const ColorTwistParams &params) {                                   \
+  return ColorTwistSIMDImpl(out, in, num_pixels, channels, params);                        \
+}
+
+DALI_INSTANTIATE_COLOR_TWIST_SIMD(uint8_t)
+DALI_INSTANTIATE_COLOR_TWIST_SIMD(float)
+
+}  // namespace kernels
+}  // namespace dali
@@ -0,0 +1,169 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "dali/kernels/imgproc/color_twist_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+ColorTwistParams RandomParams(std::mt19937 &rng) {
+  std::uniform_real_distribution<float> coeff(-0.5f, 1.5f);
+  std::uniform_real_distribution<float> offset(-64, 64);
+  ColorTwistParams params;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++)
+      params.matrix[i][j] = coeff(rng);
+    params.matrix[i][3] = offset(rng);
+    params.mean[i] = offset(rng) + 128;
+    params.inv_stddev[i] = 1.0f / (offset(rng) + 100);
+  }
+  return params;
+}
+
+std::vector<uint8_t> RandomImage(std::mt19937 &rng, int H, int W, int C) {
+  std::vector<uint8_t> img(H * W * C);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto &v : img)
+    v = dist(rng);
+  return img;
+}
+
+/// Independent, straightforward implementation in double precision
+double Reference(const uint8_t *pixel, int C, int c, const ColorTwistParams &params) {
+  const auto &m = params.matrix;
+  double v = m[c][3];
+  if (C == 1) {
+    v += m[0][0] * pixel[0];
+  } else {
+    for (int k = 0; k < 3; k++)
+      v += m[c][k] * pixel[k];
+  }
+  return std::min(255.0, std::max(0.0, v));
+}
+
+}  // namespace
+
+TEST(ColorTwistCPU, Uint8) {
+  std::mt19937 rng(1234);
+  for (int C : { 1, 3 }) {
+    // odd width to exercise the scalar tail
+    const int H = 13, W = 37;
+    auto in = RandomImage(rng, H, W, C);
+    std::vector<uint8_t> out(in.size());
+    auto params = RandomParams(rng);
+
+    ColorTwistCPU<uint8_t> kernel;
+    KernelContext ctx;
+    InTensorCPU<uint8_t, 3> in_view = { in.data(), { H, W, C } };
+    OutTensorCPU<uint8_t, 3> out_view = { out.data(), { H, W, C } };
+    auto req = kernel.Setup(ctx, in_view, params);
+    ASSERT_EQ(req.output_shapes[0][0], in_view.shape);
+    kernel.Run(ctx, out_view, in_view, params);
+
+    std::vector<uint8_t> scalar(in.size());
+    ColorTwistScalar(scalar.data(), in.data(), H * W, C, params);
+    EXPECT_EQ(out, scalar) << "SIMD and scalar results differ for " << C << " channels";
+
+    for (int i = 0; i < H * W; i++) {
+      for (int c = 0; c < C; c++) {
+        double ref = Reference(&in[i * C], C, C == 1 ? 0 : c, params);
+        ASSERT_NEAR(out[i * C + c], ref, 0.5 + 1e-3) << "pixel " << i << " channel " << c;
+      }
+    }
+  }
+}
+
+TEST(ColorTwistCPU, InPlace) {
+  std::mt19937 rng(4321);
+  const int H = 20, W = 41, C = 3;
+  auto img = RandomImage(rng, H, W, C);
+  auto params = RandomParams(rng);
+  std::vector<uint8_t> expected(img.size());
+  ColorTwistScalar(expected.data(), img.data(), H * W, C, params);
+
+  ColorTwistCPU<uint8_t> kernel;
+  KernelContext ctx;
+  InTensorCPU<uint8_t, 3> in_view = { img.data(), { H, W, C } };
+  OutTensorCPU<uint8_t, 3> out_view = { img.data(), { H, W, C } };
+  kernel.Setup(ctx, in_view, params);
+  kernel.Run(ctx, out_view, in_view, params);
+  EXPECT_EQ(img, expected);
+}
+
+TEST(ColorTwistCPU, FloatNormalized) {
+  std::mt19937 rng(5678);
+  for (int C : { 1, 3 }) {
+    const int H = 11, W = 29;
+    auto in = RandomImage(rng, H, W, C);
+    std::vector<float> out(in.size());
+    auto params = RandomParams(rng);
+
+    ColorTwistCPU<float> kernel;
+    KernelContext ctx;
+    InTensorCPU<uint8_t, 3> in_view = { in.data(), { H, W, C } };
+    OutTensorCPU<float, 3> out_view = { out.data(), { H, W, C } };
+    kernel.Setup(ctx, in_view, params);
+    kernel.Run(ctx, out_view, in_view, params);
+
+    std::vector<float> scalar(in.size());
+    ColorTwistScalar(scalar.data(), in.data(), H * W, C, params);
+    EXPECT_EQ(out, scalar) << "SIMD and scalar results differ for " << C << " channels";
+
+    for (int i = 0; i < H * W; i++) {
+      for (int c = 0; c < C; c++) {
+        double ref = (Reference(&in[i * C], C, C == 1 ? 0 : c, params) - params.mean[c]) *
+                     params.inv_stddev[c];
+        ASSERT_NEAR(out[i * C + c], ref, 1e-4) << "pixel " << i << " channel " << c;
+      }
+    }
+  }
+}
+
+TEST(ColorTwistCPU, GrayRounding) {
+  // single channel: only matrix[0][0] and the offset are used, as on the GPU
+  ColorTwistParams params;
+  params.matrix[0][0] = 0.5f;
+  params.matrix[0][1] = 7;
+  params.matrix[0][2] = 7;
+  std::vector<uint8_t> in(64);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = i;
+  std::vector<uint8_t> out(in.size()), scalar(in.size());
+  ColorTwist(out.data(), in.data(), in.size(), 1, params);
+  ColorTwistScalar(scalar.data(), in.data(), in.size(), 1, params);
+  EXPECT_EQ(out, scalar);
+  // halves are rounded to even, as by cv::saturate_cast
+  for (size_t i = 0; i < in.size(); i++) {
+    int expected = i / 2 + (i % 4 == 3 ? 1 : 0);
+    ASSERT_EQ(out[i], expected) << "pixel " << i;
+  }
+}
+
+TEST(ColorTwistCPU, Identity) {
+  std::mt19937 rng(42);
+  const int H = 7, W = 33, C = 3;
+  auto in = RandomImage(rng, H, W, C);
+  std::vector<uint8_t> out(in.size());
+  ColorTwist(out.data(), in.data(), H * W, C, ColorTwistParams());
+  EXPECT_EQ(out, in);
+}
+
+}  // namespace kernels
+}  // namespace dali
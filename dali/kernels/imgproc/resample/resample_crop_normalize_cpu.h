@@ -0,0 +1,249 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLE_CROP_NORMALIZE_CPU_H_
+#define DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLE_CROP_NORMALIZE_CPU_H_
+
+#include <array>
+#include <vector>
+#include "dali/core/convert.h"
+#include "dali/core/error_handling.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+struct ResampleCropMirrorNormalizeArgs {
+  /// @brief Resampling of the whole image; `output_size` is the size of the resized image
+  ResamplingParams2D resample;
+  /// @brief Crop window in the resized image, (y, x)
+  std::array<int, 2> crop_anchor = {{ 0, 0 }};
+  /// @brief Crop size, (height, width)
+  std::array<int, 2> crop_shape = {{ 0, 0 }};
+  /// @brief Flip the output horizontally
+  bool mirror = false;
+  /// @brief Produce planar (CHW) output instead of interleaved (HWC)
+  bool planar = true;
+  /// @brief Per-channel (or a single) mean and inverse standard deviation;
+  ///        empty vectors mean no normalization
+  std::vector<float> mean, inv_stddev;
+};
+
+/// @brief Resize, crop, mirror and normalize an HWC image in a single kernel
+///
+/// The crop window is backprojected to the input, so only the pixels which end up
+/// in the output are resampled. The second resampling pass is done row by row into
+/// a small buffer which is immediately normalized, mirrored and stored in the output
+/// layout - there's no full-size intermediate image.
+///
+/// The resampled values are rounded to `InputElement`, as the Resize operator does,
+/// so the result is equivalent to resizing, cropping and then normalizing.
+template <typename OutputElement, typename InputElement>
+struct ResampleCropMirrorNormalizeCPU {
+  using Input =  InTensorCPU<InputElement, 3>;
+  using Output = OutTensorCPU<OutputElement, 3>;
+
+  /// @brief Resampling parameters restricted to the crop window
+  static ResamplingParams2D CropParams(const TensorShape<3> &in_shape,
+                                       const ResampleCropMirrorNormalizeArgs &args) {
+    ResamplingParams2D params = args.resample;
+    for (int axis = 0; axis < 2; axis++) {
+      auto &p = params[axis];
+      int in_size = in_shape[axis];
+      int rsz_size = p.output_size == KeepOriginalSize ? in_size : p.output_size;
+      int crop_start = args.crop_anchor[axis];
+      int crop_size = args.crop_shape[axis];
+      DALI_ENFORCE(crop_size > 0 && crop_start >= 0 && crop_start + crop_size <= rsz_size,
+        "Crop window exceeds the resized image");
+
+      float roi_start = p.roi.use_roi ? p.roi.start : 0;
+      float roi_end = p.roi.use_roi ? p.roi.end : in_size;
+      float scale = (roi_end - roi_start) / rsz_size;
+      p.roi = ResamplingParams::ROI(roi_start + crop_start * scale,
+                                    roi_start + (crop_start + crop_size) * scale);
+      p.output_size = crop_size;
+    }
+    return params;
+  }
+
+  KernelRequirements Setup(KernelContext &context,
+                           const Input &input,
+                           const ResampleCropMirrorNormalizeArgs &args) {
+    DALI_ENFORCE(args.mean.size() == args.inv_stddev.size(),
+      "Mean and standard deviation must have the same number of elements");
+    setup.Setup(input.shape, CropParams(input.shape, args));
+    auto &desc = setup.desc;
+    int C = desc.channels;
+    DALI_ENFORCE(args.mean.size() <= 1 || static_cast<int>(args.mean.size()) == C,
+      "Normalization parameters must be given for each channel or as a single value");
+
+    // pure NN resampling does not report the intermediate buffer size - we need it anyway
+    setup.memory.tmp_size = volume(desc.tmp_shape()) * C;
+
+    int out_h = desc.out_shape()[0];
+    int out_w = desc.out_shape()[1];
+    TensorShape<3> out_shape = args.planar
+      ? TensorShape<3>{ C, out_h, out_w }
+      : TensorShape<3>{ out_h, out_w, C };
+
+    ScratchpadEstimator se;
+    se.add<float>(AllocType::Host, setup.memory.tmp_size);
+    se.add<InputElement>(AllocType::Host, out_w * C);
+    se.add<float>(AllocType::Host, 2 * C);
+
+    KernelRequirements req;
+    req.output_shapes = { TensorListShape<>({ out_shape }) };
+    req.scratch_sizes = se.sizes;
+    return req;
+  }
+
+  void Run(KernelContext &context,
+           const Output &output,
+           const Input &input,
+           const ResampleCropMirrorNormalizeArgs &args) {
+    auto &desc = setup.desc;
+    const int C = desc.channels;
+    const int out_w = desc.out_shape()[1];
+
+    desc.set_base_pointers(input.data, static_cast<char*>(nullptr),
+                           static_cast<OutputElement*>(nullptr));
+
+    auto in_ROI = as_surface_HWC(input);
+    in_ROI.width  = desc.in_shape()[1];
+    in_ROI.height = desc.in_shape()[0];
+    in_ROI.data   = desc.template in_ptr<InputElement>();
+
+    TensorShape<3> tmp_shape = { desc.tmp_shape()[0], desc.tmp_shape()[1], C };
+    auto tmp = context.scratchpad->AllocTensor<AllocType::Host, float, 3>(tmp_shape);
+    auto tmp_surf = as_surface_HWC(tmp);
+    InputElement *row_buf = context.scratchpad->Allocate<InputElement>(AllocType::Host, out_w * C);
+    Surface2D<InputElement> row = { row_buf, out_w, 1, C, C, out_w * C, 1 };
+
+    float *mean = context.scratchpad->Allocate<float>(AllocType::Host, 2 * C);
+    float *inv_stddev = mean + C;
+    for (int c = 0; c < C; c++) {
+      int i = args.mean.size() > 1 ? c : 0;
+      mean[c] = args.mean.empty() ? 0.0f : args.mean[i];
+      inv_stddev[c] = args.inv_stddev.empty() ? 1.0f : args.inv_stddev[i];
+    }
+
+    const Surface2D<const float> &tmp_in = tmp_surf;
+    if (desc.order == setup.VertHorz) {
+      FirstPass<0>(tmp_surf, in_ROI);
+      SecondPass<1>(output, row, tmp_in, args, mean, inv_stddev);
+    } else {
+      FirstPass<1>(tmp_surf, in_ROI);
+      SecondPass<0>(output, row, tmp_in, args, mean, inv_stddev);
+    }
+  }
+
+ private:
+  template <int axis>
+  void FirstPass(const Surface2D<float> &out, const Surface2D<const InputElement> &in) {
+    auto &desc = setup.desc;
+    if (desc.filter_type[axis] == ResamplingFilterType::Nearest) {
+      // only the resampled axis is offset - the other one is handled in the second pass
+      ResampleNN(out, in,
+        axis == 1 ? desc.origin[1] : 0.0f, axis == 0 ? desc.origin[0] : 0.0f,
+        axis == 1 ? desc.scale[1] : 1.0f, axis == 0 ? desc.scale[0] : 1.0f);
+    } else {
+      auto table = GetFilterTable(axis);
+      ResampleAxis(out, in, table.indices, table.coeffs, table.support, axis);
+    }
+  }
+
+  template <int axis>
+  void SecondPass(const Output &output, const Surface2D<InputElement> &row,
+                  const Surface2D<const float> &in,
+                  const ResampleCropMirrorNormalizeArgs &args,
+                  const float *mean, const float *inv_stddev) {
+    auto &desc = setup.desc;
+    const int out_h = desc.out_shape()[0];
+    const int out_w = desc.out_shape()[1];
+    const bool nn = desc.filter_type[axis] == ResamplingFilterType::Nearest;
+
+    const int32_t *indices = nullptr;
+    const float *coeffs = nullptr;
+    int support = 1;
+    if (!nn) {
+      auto table = GetFilterTable(axis);
+      indices = table.indices;
+      coeffs = table.coeffs;
+      support = table.support;
+    }
+
+    for (int y = 0; y < out_h; y++) {
+      if (axis == 1) {
+        Surface2D<const float> in_row = in;
+        in_row.data = &in(0, y);
+        in_row.height = 1;
+        if (nn)
+          ResampleNN(row, in_row, desc.origin[1], 0.0f, desc.scale[1], 1.0f);
+        else
+          ResampleHorz(row, in_row, indices, coeffs, support);
+      } else {
+        if (nn)
+          ResampleNN(row, in, 0.0f, desc.origin[0] + y * desc.scale[0], 1.0f, desc.scale[0]);
+        else
+          ResampleVert(row, in, indices + y, coeffs + y * support, support);
+      }
+      StoreRow(output, y, row.data, out_h, out_w, row.channels, args, mean, inv_stddev);
+    }
+  }
+
+  ResamplingFilterTable GetFilterTable(int axis) {
+    auto &desc = setup.desc;
+    return filter_cache.Get(desc.in_shape()[axis], desc.out_shape()[axis],
+                            desc.origin[axis], desc.scale[axis],
+                            desc.filter_type[axis], desc.filter[axis]);
+  }
+
+  static void StoreRow(const Output &output, int y, const InputElement *row,
+                       int h, int w, int C, const ResampleCropMirrorNormalizeArgs &args,
+                       const float *mean, const float *inv_stddev) {
+    if (args.planar) {
+      for (int c = 0; c < C; c++) {
+        OutputElement *out_row = output.data + (static_cast<ptrdiff_t>(c) * h + y) * w;
+        const float m = mean[c], s = inv_stddev[c];
+        if (args.mirror) {
+          for (int x = 0; x < w; x++)
+            out_row[w - 1 - x] = clamp<OutputElement>((row[x * C + c] - m) * s);
+        } else {
+          for (int x = 0; x < w; x++)
+            out_row[x] = clamp<OutputElement>((row[x * C + c] - m) * s);
+        }
+      }
+    } else {
+      OutputElement *out_row = output.data + static_cast<ptrdiff_t>(y) * w * C;
+      for (int x = 0; x < w; x++) {
+        OutputElement *out_px = out_row + (args.mirror ? w - 1 - x : x) * C;
+        for (int c = 0; c < C; c++)
+          out_px[c] = clamp<OutputElement>((row[x * C + c] - mean[c]) * inv_stddev[c]);
+      }
+    }
+  }
+
+  ResamplingSetupSingleImage setup;
+  ResamplingFilterCache filter_cache;
+
+ public:
+  const ResamplingFilterCache::Stats &FilterCacheStats() const noexcept {
+    return filter_cache.stats();
+  }
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLE_CROP_NORMALIZE_CPU_H_
@@ -0,0 +1,151 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLING_FILTER_CACHE_H_
+#define DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLING_FILTER_CACHE_H_
+
+#include <cstdint>
+#include <vector>
+#include "dali/core/error_handling.h"
+#include "dali/kernels/imgproc/resample/params.h"
+#include "dali/kernels/imgproc/resample/resampling_filters.cuh"
+#include "dali/kernels/imgproc/resample/resampling_impl_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Index and coefficient tables for resampling one axis
+ *
+ * The layout is the one produced by InitializeResamplingFilter: `indices` has one entry
+ * per output pixel and `coeffs` has `support` entries per output pixel.
+ */
+struct ResamplingFilterTable {
+  const int32_t *indices;
+  const float *coeffs;
+  int support;
+};
+
+/**
+ * @brief A small LRU cache of resampling filter tables
+ *
+ * Building the tables is a per-sample cost that is wasted when consecutive samples
+ * have the same size - which is the case for validation sets and video frames.
+ * Entries are keyed by input size, output size, origin, scale and the filter itself.
+ *
+ * The cache is not thread-safe - it's meant to be owned by a kernel instance, which is
+ * only ever used by one thread at a time.
+ */
+class ResamplingFilterCache {
+ public:
+  struct Stats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+
+  explicit ResamplingFilterCache(int capacity = 8) : capacity_(capacity) {
+    DALI_ENFORCE(capacity > 0, "Filter cache capacity must be positive");
+    // no reallocation may happen - the tables returned by Get must remain valid
+    entries_.reserve(capacity);
+  }
+
+  /**
+   * @brief Returns the tables for given resampling parameters, calculating them on a miss
+   *
+   * The returned pointers are valid until the next call to Get or Clear.
+   */
+  ResamplingFilterTable Get(int in_size, int out_size, float origin, float scale,
+                            ResamplingFilterType type, const ResamplingFilter &filter) {
+    Key key = { in_size, out_size, origin, scale, type,
+                filter.coeffs, filter.num_coeffs, filter.anchor, filter.scale };
+    ++tick_;
+    for (auto &e : entries_) {
+      if (e.key == key) {
+        e.last_use = tick_;
+        stats_.hits++;
+        return { e.indices.data(), e.coeffs.data(), e.support };
+      }
+    }
+    stats_.misses++;
+
+    Entry *e;
+    if (static_cast<int>(entries_.size()) < capacity_) {
+      entries_.emplace_back();
+      e = &entries_.back();
+    } else {
+      e = &entries_[0];
+      for (auto &candidate : entries_)
+        if (candidate.last_use < e->last_use)
+          e = &candidate;
+    }
+    e->key = key;
+    e->last_use = tick_;
+    e->support = filter.support();
+    e->indices.resize(out_size);
+    e->coeffs.resize(static_cast<size_t>(out_size) * e->support);
+    InitializeResamplingFilter(e->indices.data(), e->coeffs.data(), out_size,
+                               origin, scale, filter);
+    return { e->indices.data(), e->coeffs.data(), e->support };
+  }
+
+  const Stats &stats() const noexcept { return stats_; }
+  void ResetStats() { stats_ = {}; }
+
+  int size() const noexcept { return entries_.size(); }
+  int capacity() const noexcept { return capacity_; }
+
+  void Clear() {
+    entries_.clear();
+  }
+
+ private:
+  struct Key {
+    int in_size, out_size;
+    float origin, scale;
+    ResamplingFilterType type;
+    const float *filter_coeffs;
+    int filter_num_coeffs;
+    float filter_anchor, filter_scale;
+
+    bool operator==(const Key &other) const {
+      return in_size == other.in_size &&
+             out_size == other.out_size &&
+             origin == other.origin &&
+             scale == other.scale &&
+             type == other.type &&
+             filter_coeffs == other.filter_coeffs &&
+             filter_num_coeffs == other.filter_num_coeffs &&
+             filter_anchor == other.filter_anchor &&
+             filter_scale == other.filter_scale;
+    }
+  };
+
+  struct Entry {
+    Key key;
+    std::vector<int32_t> indices;
+    std::vector<float> coeffs;
+    int support = 0;
+    int64_t last_use = 0;
+  };
+
+  int capacity_;
+  int64_t tick_ = 0;
+  std::vector<Entry> entries_;
+  Stats stats_;
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_RESAMPLE_RESAMPLING_FILTER_CACHE_H_
@@ -30,6 +30,35 @@ struct ResamplingFilter;
 void InitializeResamplingFilter(int32_t *out_indices, float *out_coeffs, int out_size,
                                 float srcx0, float scale, const ResamplingFilter &filter);
 
+/// @brief Vectorized (AVX2/AVX-512) resampling passes, selected at run time.
+///
+/// The results are bit-exact with the scalar implementations.
+/// @return false, if the CPU or the surface layout is not supported - in that case
+///         nothing is written and the scalar implementation should be used.
+#define DALI_DECLARE_RESAMPLING_SIMD(Out, In)                                            \
+bool ResampleVertSIMD(Surface2D<Out> out, Surface2D<const In> in,                        \
+                      const int32_t *in_rows, const float *row_coeffs, int support);     \
+bool ResampleHorzSIMD(Surface2D<Out> out, Surface2D<const In> in,                        \
+                      const int32_t *in_columns, const float *col_coeffs, int support);
+
+DALI_DECLARE_RESAMPLING_SIMD(float, uint8_t)
+DALI_DECLARE_RESAMPLING_SIMD(float, float)
+DALI_DECLARE_RESAMPLING_SIMD(uint8_t, uint8_t)
+DALI_DECLARE_RESAMPLING_SIMD(uint8_t, float)
+
+#undef DALI_DECLARE_RESAMPLING_SIMD
+
+/// @brief Fallback for the types that have no vectorized implementation
+template <typename Out, typename In>
+inline bool ResampleVertSIMD(Surface2D<Out>, Surface2D<In>, const int32_t *, const float *, int) {
+  return false;
+}
+
+template <typename Out, typename In>
+inline bool ResampleHorzSIMD(Surface2D<Out>, Surface2D<In>, const int32_t *, const float *, int) {
+  return false;
+}
+
 template <int static_channels, bool clamp_left, bool clamp_right, typename Out, typename In>
 void ResampleCol(Out *out, const In *in, int x, int w, const int32_t *in_columns,
                  const float *coeffs, int support, int dynamic_channels) {
@@ -110,7 +139,7 @@ void ResampleHorz_Channels(
 }
 
 template <typename Out, typename In>
-void ResampleVert(
+void ResampleVertScalar(
     Surface2D<Out> out, Surface2D<In> in, const int32_t *in_rows,
     const float *row_coeffs, int support) {
   constexpr float bias = std::is_integral<Out>::value ? 0.5f : 0;
@@ -153,8 +182,17 @@ void ResampleVert(
 }
 
 template <typename Out, typename In>
-inline void ResampleHorz(Surface2D<Out> out, Surface2D<In> in,
-                         const int *in_columns, const float *col_coeffs, int support) {
+inline void ResampleVert(
+    Surface2D<Out> out, Surface2D<In> in, const int32_t *in_rows,
+    const float *row_coeffs, int support) {
+  const Surface2D<const std::remove_const_t<In>> &const_in = in;
+  if (!ResampleVertSIMD(out, const_in, in_rows, row_coeffs, support))
+    ResampleVertScalar(out, in, in_rows, row_coeffs, support);
+}
+
+template <typename Out, typename In>
+inline void ResampleHorzScalar(Surface2D<Out> out, Surface2D<In> in,
+                               const int *in_columns, const float *col_coeffs, int support) {
   VALUE_SWITCH(out.channels, static_channels, (1, 2, 3, 4), (
     ResampleHorz_Channels<static_channels>(out, in, in_columns, col_coeffs, support);
   ), (  // NOLINT
@@ -162,6 +200,14 @@ inline void ResampleHorz(Surface2D<Out> out, Surface2D<In> in,
   ));   // NOLINT
 }
 
+template <typename Out, typename In>
+inline void ResampleHorz(Surface2D<Out> out, Surface2D<In> in,
+                         const int *in_columns, const float *col_coeffs, int support) {
+  const Surface2D<const std::remove_const_t<In>> &const_in = in;
+  if (!ResampleHorzSIMD(out, const_in, in_columns, col_coeffs, support))
+    ResampleHorzScalar(out, in, in_columns, col_coeffs, support);
+}
+
 template <typename Out, typename In>
 inline void ResampleAxis(Surface2D<Out> out, Surface2D<In> in,
                          const int *in_indices, const float *coeffs, int support, int axis) {
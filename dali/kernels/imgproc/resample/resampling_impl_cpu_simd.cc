@@ -0,0 +1,318 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Vectorized resampling passes. The functions are compiled for AVX2 / AVX-512 with target
+// attributes and selected at run time, so the rest of the library keeps the baseline ISA.
+//
+// The accumulation order is the same as in the scalar code and no FMA is used (the file is built
+// with -ffp-contract=off), so the results are bit-exact with ResampleVertScalar /
+// ResampleHorzScalar.
+
+#include <cstring>
+#include <type_traits>
+#include "dali/core/cpu_features.h"
+#include "dali/kernels/imgproc/resample/resampling_impl_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+#if DALI_X86_SIMD
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////////////
+// AVX2 load/store helpers - 8 elements
+
+DALI_TARGET_AVX2 inline __m256 Load8(const float *in) {
+  return _mm256_loadu_ps(in);
+}
+
+DALI_TARGET_AVX2 inline __m256 Load8(const uint8_t *in) {
+  __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+}
+
+DALI_TARGET_AVX2 inline void Store8(float *out, __m256 v) {
+  _mm256_storeu_ps(out, v);
+}
+
+// Same as clamp<uint8_t>(float): saturate and truncate
+DALI_TARGET_AVX2 inline void Store8(uint8_t *out, __m256 v) {
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+  __m256i i32 = _mm256_cvttps_epi32(v);
+  __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(i16, i16));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// AVX-512 load/store helpers - 16 elements
+
+DALI_TARGET_AVX512 inline __m512 Load16(const float *in) {
+  return _mm512_loadu_ps(in);
+}
+
+DALI_TARGET_AVX512 inline __m512 Load16(const uint8_t *in) {
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+  return _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(bytes));
+}
+
+DALI_TARGET_AVX512 inline void Store16(float *out, __m512 v) {
+  _mm512_storeu_ps(out, v);
+}
+
+DALI_TARGET_AVX512 inline void Store16(uint8_t *out, __m512 v) {
+  v = _mm512_min_ps(_mm512_max_ps(v, _mm512_setzero_ps()), _mm512_set1_ps(255.0f));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(out),
+                   _mm512_cvtepi32_epi8(_mm512_cvttps_epi32(v)));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Vertical pass - rows are processed as flat arrays, vectorized along the row
+
+template <typename In>
+void GetInputRows(const In **in_row_ptrs, const Surface2D<const In> &in,
+                  const int32_t *in_rows, int y, int support) {
+  for (int k = 0; k < support; k++) {
+    int sy = in_rows[y] + k;
+    if (sy < 0) sy = 0;
+    else if (sy > in.height-1) sy = in.height-1;
+    in_row_ptrs[k] = &in(0, sy);
+  }
+}
+
+template <typename Out, typename In>
+void ResampleVertRowTail(Out *out_row, const In **in_row_ptrs, const float *coeffs,
+                         int support, int x0, int flat_w) {
+  constexpr float bias = std::is_integral<Out>::value ? 0.5f : 0;
+  for (int x = x0; x < flat_w; x++) {
+    float sum = bias;
+    for (int k = 0; k < support; k++)
+      sum += coeffs[k] * in_row_ptrs[k][x];
+    out_row[x] = clamp<Out>(sum);
+  }
+}
+
+template <typename Out, typename In>
+DALI_TARGET_AVX2 void ResampleVertAVX2(Surface2D<Out> out, Surface2D<const In> in,
+                                       const int32_t *in_rows, const float *row_coeffs,
+                                       int support) {
+  constexpr float bias = std::is_integral<Out>::value ? 0.5f : 0;
+  const int flat_w = out.width * out.channels;
+  const In **in_row_ptrs = static_cast<const In **>(alloca(support * sizeof(const In *)));
+
+  for (int y = 0; y < out.height; y++) {
+    Out *out_row = &out(0, y, 0);
+    const float *coeffs = &row_coeffs[y * support];
+    GetInputRows(in_row_ptrs, in, in_rows, y, support);
+
+    int x = 0;
+    // 4 accumulators to hide the latency of the additions
+    for (; x + 32 <= flat_w; x += 32) {
+      __m256 acc0 = _mm256_set1_ps(bias), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+      for (int k = 0; k < support; k++) {
+        __m256 flt = _mm256_set1_ps(coeffs[k]);
+        const In *in_row = in_row_ptrs[k] + x;
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(flt, Load8(in_row)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(flt, Load8(in_row + 8)));
+        acc2 = _mm256_add_ps(acc2, _mm256_mul_ps(flt, Load8(in_row + 16)));
+        acc3 = _mm256_add_ps(acc3, _mm256_mul_ps(flt, Load8(in_row + 24)));
+      }
+      Store8(out_row + x, acc0);
+      Store8(out_row + x + 8, acc1);
+      Store8(out_row + x + 16, acc2);
+      Store8(out_row + x + 24, acc3);
+    }
+    for (; x + 8 <= flat_w; x += 8) {
+      __m256 acc = _mm256_set1_ps(bias);
+      for (int k = 0; k < support; k++) {
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(coeffs[k]),
+                                               Load8(in_row_ptrs[k] + x)));
+      }
+      Store8(out_row + x, acc);
+    }
+    ResampleVertRowTail(out_row, in_row_ptrs, coeffs, support, x, flat_w);
+  }
+}
+
+template <typename Out, typename In>
+DALI_TARGET_AVX512 void ResampleVertAVX512(Surface2D<Out> out, Surface2D<const In> in,
+                                           const int32_t *in_rows, const float *row_coeffs,
+                                           int support) {
+  constexpr float bias = std::is_integral<Out>::value ? 0.5f : 0;
+  const int flat_w = out.width * out.channels;
+  const In **in_row_ptrs = static_cast<const In **>(alloca(support * sizeof(const In *)));
+
+  for (int y = 0; y < out.height; y++) {
+    Out *out_row = &out(0, y, 0);
+    const float *coeffs = &row_coeffs[y * support];
+    GetInputRows(in_row_ptrs, in, in_rows, y, support);
+
+    int x = 0;
+    for (; x + 64 <= flat_w; x += 64) {
+      __m512 acc0 = _mm512_set1_ps(bias), acc1 = acc0, acc2 = acc0, acc3 = acc0;
+      for (int k = 0; k < support; k++) {
+        __m512 flt = _mm512_set1_ps(coeffs[k]);
+        const In *in_row = in_row_ptrs[k] + x;
+        acc0 = _mm512_add_ps(acc0, _mm512_mul_ps(flt, Load16(in_row)));
+        acc1 = _mm512_add_ps(acc1, _mm512_mul_ps(flt, Load16(in_row + 16)));
+        acc2 = _mm512_add_ps(acc2, _mm512_mul_ps(flt, Load16(in_row + 32)));
+        acc3 = _mm512_add_ps(acc3, _mm512_mul_ps(flt, Load16(in_row + 48)));
+      }
+      Store16(out_row + x, acc0);
+      Store16(out_row + x + 16, acc1);
+      Store16(out_row + x + 32, acc2);
+      Store16(out_row + x + 48, acc3);
+    }
+    for (; x + 16 <= flat_w; x += 16) {
+      __m512 acc = _mm512_set1_ps(bias);
+      for (int k = 0; k < support; k++) {
+        acc = _mm512_add_ps(acc, _mm512_mul_ps(_mm512_set1_ps(coeffs[k]),
+                                               Load16(in_row_ptrs[k] + x)));
+      }
+      Store16(out_row + x, acc);
+    }
+    ResampleVertRowTail(out_row, in_row_ptrs, coeffs, support, x, flat_w);
+  }
+}
+
+template <typename Out, typename In>
+bool ResampleVertSIMDImpl(Surface2D<Out> out, Surface2D<const In> in,
+                          const int32_t *in_rows, const float *row_coeffs, int support) {
+  // rows must be contiguous, as in the scalar version
+  if (out.pixel_stride != out.channels || out.channel_stride != 1 ||
+      in.pixel_stride != in.channels || in.channel_stride != 1 || support <= 0)
+    return false;
+  if (HasAVX512F()) {
+    ResampleVertAVX512(out, in, in_rows, row_coeffs, support);
+    return true;
+  } else if (HasAVX2()) {
+    ResampleVertAVX2(out, in, in_rows, row_coeffs, support);
+    return true;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Horizontal pass - one output pixel (up to 4 channels) per 128-bit vector
+
+DALI_TARGET_AVX2 inline __m128 LoadPixel(const float *in) {
+  return _mm_loadu_ps(in);
+}
+
+DALI_TARGET_AVX2 inline __m128 LoadPixel(const uint8_t *in) {
+  int32_t bytes;
+  std::memcpy(&bytes, in, sizeof(bytes));
+  return _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes)));
+}
+
+template <int channels, typename Out, typename In>
+DALI_TARGET_AVX2 void ResampleHorzAVX2(Surface2D<Out> out, Surface2D<const In> in,
+                                       const int32_t *in_columns, const float *coeffs,
+                                       int support) {
+  static_assert(channels == 3 || channels == 4, "Only 3 and 4 channels are vectorized");
+  const float bias = std::is_integral<Out>::value ? 0.5f : 0;
+
+  // The vector loads read 4 elements, so with 3 channels they touch the first channel
+  // of the next pixel - it must still be within the row
+  int first_simd_col = 0;
+  int last_simd_col = out.width - 1;
+  const int overread = channels == 3 ? 1 : 0;
+  while (first_simd_col < out.width && in_columns[first_simd_col] < 0)
+    first_simd_col++;
+  while (last_simd_col >= 0 && in_columns[last_simd_col] + support + overread > in.width)
+    last_simd_col--;
+
+  alignas(16) float tmp[4];
+  for (int y = 0; y < out.height; y++) {
+    Out *out_row = &out(0, y);
+    const In *in_row = &in(0, y);
+
+    for (int x = 0; x < out.width; x++) {
+      if (x < first_simd_col || x > last_simd_col) {
+        ResampleCol<channels, true, true>(out_row, in_row, x, in.width, in_columns, coeffs,
+                                          support, channels);
+        continue;
+      }
+      const In *in_px = in_row + in_columns[x] * channels;
+      const float *flt = coeffs + x * support;
+      __m128 acc = _mm_set1_ps(bias);
+      for (int k = 0; k < support; k++) {
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(flt[k]), LoadPixel(in_px + k * channels)));
+      }
+      _mm_store_ps(tmp, acc);
+      for (int c = 0; c < channels; c++)
+        out_row[channels * x + c] = clamp<Out>(tmp[c]);
+    }
+  }
+}
+
+template <typename Out, typename In>
+bool ResampleHorzSIMDImpl(Surface2D<Out> out, Surface2D<const In> in,
+                          const int32_t *in_columns, const float *col_coeffs, int support) {
+  if (out.channels != in.channels ||
+      out.pixel_stride != out.channels || out.channel_stride != 1 ||
+      in.pixel_stride != in.channels || in.channel_stride != 1 || support <= 0)
+    return false;
+  // AVX-512 gives no benefit here, one pixel fills only a 128-bit vector
+  if (!HasAVX2())
+    return false;
+  if (out.channels == 3) {
+    ResampleHorzAVX2<3>(out, in, in_columns, col_coeffs, support);
+    return true;
+  } else if (out.channels == 4) {
+    ResampleHorzAVX2<4>(out, in, in_columns, col_coeffs, support);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+#else  // DALI_X86_SIMD
+
+namespace {
+
+template <typename Out, typename In>
+bool ResampleVertSIMDImpl(Surface2D<Out>, Surface2D<const In>,
+                          const int32_t *, const float *, int) {
+  return false;
+}
+
+template <typename Out, typename In>
+bool ResampleHorzSIMDImpl(Surface2D<Out>, Surface2D<const In>,
+                          const int32_t *, const float *, int) {
+  return false;
+}
+
+}  // namespace
+
+#endif  // DALI_X86_SIMD
+
+#define DALI_INSTANTIATE_RESAMPLING_SIMD(Out, In)                                         \
+bool ResampleVertSIMD(Surface2D<Out> out, Surface2D<const In> in,                         \
+                      const int32_t *in_rows, const float *row_coeffs, int support) {     \
+  return ResampleVertSIMDImpl(out, in, in_rows, row_coeffs, support);                     \
+}                                                                                         \
+bool ResampleHorzSIMD(Surface2D<Out> out, Surface2D<const In> in,                         \
+                      const int32_t *in_columns, const float *col_coeffs, int support) {  \
+  return ResampleHorzSIMDImpl(out, in, in_columns, col_coeffs, support);                  \
+}
+
+DALI_INSTANTIATE_RESAMPLING_SIMD(float, uint8_t)
+DALI_INSTANTIATE_RESAMPLING_SIMD(float, float)
+DALI_INSTANTIATE_RESAMPLING_SIMD(uint8_t, uint8_t)
+DALI_INSTANTIATE_RESAMPLING_SIMD(uint8_t, float)
+
+}  // namespace kernels
+}  // namespace dali
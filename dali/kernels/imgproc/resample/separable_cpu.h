@@ -16,6 +16,7 @@
 #define DALI_KERNELS_IMGPROC_RESAMPLE_SEPARABLE_CPU_H_
 
 #include "dali/kernels/imgproc/resample/params.h"
+#include "dali/kernels/imgproc/resample/resampling_filter_cache.h"
 #include "dali/kernels/imgproc/resample/resampling_filters.cuh"
 #include "dali/kernels/imgproc/resample/resampling_impl_cpu.h"
 #include "dali/kernels/imgproc/resample/resampling_setup.h"
@@ -34,18 +35,13 @@ struct ResamplingSetupCPU : SeparableResamplingSetup {
       desc.filter_type[1] == ResamplingFilterType::Nearest;
   }
 
+  /// Filter tables are not included - they are kept in a ResamplingFilterCache
   struct MemoryReq {
     size_t tmp_size = 0;
-    size_t coeffs_size = 0;
-    size_t indices_size = 0;
 
     MemoryReq &extend(const MemoryReq &other) {
       if (other.tmp_size > tmp_size)
         tmp_size = other.tmp_size;
-      if (other.coeffs_size > coeffs_size)
-        coeffs_size = other.coeffs_size;
-      if (other.indices_size > indices_size)
-        indices_size = other.indices_size;
       return *this;
     }
   };
@@ -56,16 +52,6 @@ struct ResamplingSetupCPU : SeparableResamplingSetup {
     } else {
       MemoryReq req;
       req.tmp_size = volume(desc.tmp_shape()) * desc.channels;
-      int axis_order[2];
-      axis_order[0] = desc.order == HorzVert ? 1 : 0;  // axis 1 is horizontal, HWC layout
-      axis_order[1] = 1 - axis_order[0];
-
-      req.indices_size = std::max(desc.tmp_shape()[axis_order[0]],
-                                  desc.out_shape()[axis_order[1]]);
-
-      int support[2] = { desc.filter[0].support(), desc.filter[1].support() };
-      req.coeffs_size = std::max(desc.tmp_shape()[axis_order[0]] * support[axis_order[0]],
-                                 desc.out_shape()[axis_order[1]] * support[axis_order[1]]);
       return req;
     }
   }
@@ -96,8 +82,6 @@ struct SeparableResampleCPU  {
 
     ScratchpadEstimator se;
     se.add<float>(AllocType::Host, setup.memory.tmp_size);
-    se.add<float>(AllocType::Host, setup.memory.coeffs_size);
-    se.add<int32_t>(AllocType::Host, setup.memory.indices_size);
 
     TensorListShape<> out_tls({ out_shape });
 
@@ -135,23 +119,19 @@ struct SeparableResampleCPU  {
 
       auto tmp_surf = as_surface_HWC(tmp);
 
-      void *filter_mem = context.scratchpad->Allocate<int32_t>(AllocType::Host,
-        setup.memory.coeffs_size + setup.memory.indices_size);
-
       if (desc.order == setup.VertHorz) {
-        ResamplePass<0, float, InputElement>(tmp_surf, in_ROI, filter_mem);
-        ResamplePass<1, OutputElement, float>(out_ROI, tmp_surf, filter_mem);
+        ResamplePass<0, float, InputElement>(tmp_surf, in_ROI);
+        ResamplePass<1, OutputElement, float>(out_ROI, tmp_surf);
       } else {
-        ResamplePass<1, float, InputElement>(tmp_surf, in_ROI, filter_mem);
-        ResamplePass<0, OutputElement, float>(out_ROI, tmp_surf, filter_mem);
+        ResamplePass<1, float, InputElement>(tmp_surf, in_ROI);
+        ResamplePass<0, OutputElement, float>(out_ROI, tmp_surf);
       }
     }
   }
 
   template <int axis, typename PassOutput, typename PassInput>
   void ResamplePass(const Surface2D<PassOutput> &out,
-                    const Surface2D<const PassInput> &in,
-                    void *mem) {
+                    const Surface2D<const PassInput> &in) {
     auto &desc = setup.desc;
 
     if (desc.filter_type[axis] == ResamplingFilterType::Nearest) {
@@ -160,18 +140,20 @@ struct SeparableResampleCPU  {
         desc.origin[1], desc.origin[0],
         (axis == 1 ? desc.scale[1] : 1.0f), (axis == 0 ? desc.scale[0] : 1.0f));
     } else {
-      int32_t *indices = static_cast<int32_t*>(mem);
-      float *coeffs = static_cast<float*>(static_cast<void*>(indices + desc.out_shape()[axis]));
-      int support = desc.filter[axis].support();
-
-      InitializeResamplingFilter(indices, coeffs, desc.out_shape()[axis],
-                                 desc.origin[axis], desc.scale[axis], desc.filter[axis]);
-
-      ResampleAxis(out, in, indices, coeffs, support, axis);
+      auto table = filter_cache.Get(desc.in_shape()[axis], desc.out_shape()[axis],
+                                    desc.origin[axis], desc.scale[axis],
+                                    desc.filter_type[axis], desc.filter[axis]);
+      ResampleAxis(out, in, table.indices, table.coeffs, table.support, axis);
     }
   }
 
+  const ResamplingFilterCache::Stats &FilterCacheStats() const noexcept {
+    return filter_cache.stats();
+  }
+
   ResamplingSetupSingleImage setup;
+  /// Filter tables reused across samples of the same size
+  ResamplingFilterCache filter_cache;
 };
 
 }  // namespace kernels
@@ -15,6 +15,8 @@
 #ifndef DALI_KERNELS_SLICE_SLICE_FLIP_NORMALIZE_PERMUTE_CPU_H_
 #define DALI_KERNELS_SLICE_SLICE_FLIP_NORMALIZE_PERMUTE_CPU_H_
 
+#include <cstring>
+#include <type_traits>
 #include <utility>
 #include <vector>
 #include "dali/core/common.h"
@@ -150,6 +152,162 @@ inline void SliceFlipNormalizePermuteImpl(OutputType *output, const InputType *i
   }
 }
 
+/**
+ * @brief Vectorized conversion of a row of pixels, see ConvertPixels
+ *
+ * Only uint8 to float conversion is vectorized; for other types nothing is processed.
+ * @return number of pixels processed - the remaining ones should be processed
+ *         with the scalar code; 0 if the CPU or the layout is not supported.
+ */
+template <typename OutputType, typename InputType>
+inline int64_t ConvertPixelsSIMD(OutputType *, const InputType *, int64_t, int64_t, int64_t,
+                                 int64_t, int64_t, int64_t, const float *, const float *,
+                                 int64_t) {
+  return 0;
+}
+
+/// @brief AVX2 implementation, selected at run time. `mean == nullptr` means no normalization.
+int64_t ConvertPixelsSIMD(float *output, const uint8_t *input, int64_t num_pixels,
+                          int64_t channels, int64_t padded_channels,
+                          int64_t in_pixel_stride, int64_t out_pixel_stride,
+                          int64_t out_channel_stride,
+                          const float *mean, const float *inv_stddev, int64_t norm_step);
+
+/**
+ * @brief Converts `num_pixels` pixels of `channels` contiguous input elements each
+ *
+ * Output channels are `out_channel_stride` elements apart, so the same function produces
+ * interleaved and planar output. Channels from `channels` to `padded_channels` are zero-filled.
+ * The normalization parameters for channel `c` are `mean[c * norm_step]`
+ * and `inv_stddev[c * norm_step]`.
+ */
+template <typename Policy, typename OutputType, typename InputType>
+inline void ConvertPixels(OutputType *output, const InputType *input, int64_t num_pixels,
+                          int64_t channels, int64_t padded_channels,
+                          int64_t in_pixel_stride, int64_t out_pixel_stride,
+                          int64_t out_channel_stride,
+                          const float *mean, const float *inv_stddev, int64_t norm_step) {
+  const bool contiguous = in_pixel_stride == channels && out_pixel_stride == channels &&
+                          out_channel_stride == 1 && padded_channels == channels;
+  if (std::is_same<Policy, ClampPolicy>::value && std::is_same<OutputType, InputType>::value &&
+      contiguous) {
+    std::memcpy(output, input, num_pixels * channels * sizeof(OutputType));
+    return;
+  }
+
+  int64_t i = ConvertPixelsSIMD(output, input, num_pixels, channels, padded_channels,
+                                in_pixel_stride, out_pixel_stride, out_channel_stride,
+                                mean, inv_stddev, norm_step);
+  input += i * in_pixel_stride;
+  output += i * out_pixel_stride;
+  for (; i < num_pixels; i++) {
+    int64_t c = 0;
+    for (; c < channels; c++) {
+      Policy::Fill(output[c * out_channel_stride], input[c],
+                   mean + c * norm_step, inv_stddev + c * norm_step);
+    }
+    for (; c < padded_channels; c++)
+      output[c * out_channel_stride] = 0;
+    input += in_pixel_stride;
+    output += out_pixel_stride;
+  }
+}
+
+template <typename Policy, typename OutputType, typename InputType>
+void ConvertImage(OutputType *output, const InputType *input,
+                  int64_t rows, int64_t padded_rows,
+                  int64_t pixels, int64_t padded_pixels,
+                  int64_t channels, int64_t padded_channels,
+                  int64_t in_row_stride, int64_t in_pixel_stride,
+                  int64_t out_row_stride, int64_t out_pixel_stride, int64_t out_channel_stride,
+                  const float *mean, const float *inv_stddev, int64_t norm_step) {
+  int64_t r = 0;
+  for (; r < rows; r++) {
+    ConvertPixels<Policy>(output, input, pixels, channels, padded_channels,
+                          in_pixel_stride, out_pixel_stride, out_channel_stride,
+                          mean, inv_stddev, norm_step);
+    for (int64_t i = pixels; i < padded_pixels; i++)
+      for (int64_t c = 0; c < padded_channels; c++)
+        output[i * out_pixel_stride + c * out_channel_stride] = 0;
+    input += in_row_stride;
+    output += out_row_stride;
+  }
+  for (; r < padded_rows; r++) {
+    for (int64_t i = 0; i < padded_pixels; i++)
+      for (int64_t c = 0; c < padded_channels; c++)
+        output[i * out_pixel_stride + c * out_channel_stride] = 0;
+    output += out_row_stride;
+  }
+}
+
+template <typename OutputType, typename InputType, size_t Dims>
+bool SliceFlipNormalizePermuteImage(OutputType *, const InputType *,
+                                    const std::array<int64_t, Dims> &,
+                                    const std::array<int64_t, Dims> &,
+                                    const std::array<int64_t, Dims> &,
+                                    const std::array<int64_t, Dims> &,
+                                    const std::vector<float> &,
+                                    const std::vector<float> &,
+                                    size_t) {
+  return false;
+}
+
+/**
+ * @brief Fast path for 3D data, where one of the input dimensions (channels) is contiguous
+ *        and becomes either the innermost (HWC output) or the outermost (CHW output)
+ *        output dimension.
+ *
+ * Each pixel is read once, as a whole; mirrored rows are handled with a negative pixel stride.
+ * @return false, if the layout or the normalization is not supported by this path
+ */
+template <typename OutputType, typename InputType>
+bool SliceFlipNormalizePermuteImage(OutputType *output, const InputType *input,
+                                    const std::array<int64_t, 3> &in_strides,
+                                    const std::array<int64_t, 3> &out_strides,
+                                    const std::array<int64_t, 3> &out_shape,
+                                    const std::array<int64_t, 3> &padded_out_shape,
+                                    const std::vector<float> &mean,
+                                    const std::vector<float> &inv_stddev,
+                                    size_t normalization_dim) {
+  // CHW output writes a separate stream per channel, so only a few channels are allowed
+  constexpr int64_t kMaxPlanes = 16;
+  size_t channel_dim, row_dim, pixel_dim;
+  if (in_strides[2] == 1) {
+    channel_dim = 2;
+    row_dim = 0;
+    pixel_dim = 1;
+  } else if (in_strides[0] == 1 && padded_out_shape[0] <= kMaxPlanes) {
+    channel_dim = 0;
+    row_dim = 1;
+    pixel_dim = 2;
+  } else {
+    return false;
+  }
+
+  const bool per_channel_norm = mean.size() > 1;
+  if (per_channel_norm && normalization_dim != channel_dim)
+    return false;
+
+  auto convert = [&](auto policy) {
+    using Policy = decltype(policy);
+    ConvertImage<Policy>(
+        output, input,
+        out_shape[row_dim], padded_out_shape[row_dim],
+        out_shape[pixel_dim], padded_out_shape[pixel_dim],
+        out_shape[channel_dim], padded_out_shape[channel_dim],
+        in_strides[row_dim], in_strides[pixel_dim],
+        out_strides[row_dim], out_strides[pixel_dim], out_strides[channel_dim],
+        mean.empty() ? nullptr : mean.data(),
+        inv_stddev.empty() ? nullptr : inv_stddev.data(),
+        per_channel_norm ? 1 : 0);
+  };
+  if (mean.empty())
+    convert(ClampPolicy());
+  else
+    convert(NormalizePolicy());
+  return true;
+}
+
 template <typename OutputType, typename InputType, size_t Dims>
 void SliceFlipNormalizePermute(OutputType *output, const InputType *input,
                                const std::array<int64_t, Dims> &in_strides,
@@ -161,6 +319,9 @@ void SliceFlipNormalizePermute(OutputType *output, const InputType *input,
                                size_t normalization_dim) {
   DALI_ENFORCE(mean.size() == inv_stddev.size());
   DALI_ENFORCE(mean.size() <= 1 || normalization_dim < Dims);
+  if (SliceFlipNormalizePermuteImage(output, input, in_strides, out_strides, out_shape,
+                                     padded_out_shape, mean, inv_stddev, normalization_dim))
+    return;
   const bool should_normalize = !mean.empty();
   const bool IsNextNormalizationDim = (0 == normalization_dim);
   if (should_normalize) {
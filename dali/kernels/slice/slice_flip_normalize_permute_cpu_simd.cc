@@ -0,0 +1,337 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Vectorized uint8 to float conversion with normalization for SliceFlipNormalizePermuteCPU.
+// The functions are compiled for AVX2 with target attributes and selected at run time.
+//
+// Contiguous rows are converted as a flat array, with the per-channel normalization
+// parameters arranged in repeating patterns. Other 3-channel layouts (mirrored, planar
+// or padded output) are split into channel planes with byte shuffles first.
+// The arithmetic is the same as in NormalizePolicy and no FMA is used (the file is built
+// with -ffp-contract=off), so the results are bit-exact with the scalar code.
+
+#include <cstdint>
+#include "dali/core/cpu_features.h"
+#include "dali/kernels/slice/slice_flip_normalize_permute_cpu.h"
+
+namespace dali {
+namespace kernels {
+namespace detail {
+
+#if DALI_X86_SIMD
+
+namespace {
+
+struct ShuffleTables {
+  /// deinterleave[flip][c][v] - gathers channel `c` of 16 RGB pixels from the input vector `v`;
+  /// in reverse pixel order, if `flip` is set
+  alignas(16) int8_t deinterleave[2][3][3][16];
+  /// reverses the order of 16 bytes
+  alignas(16) int8_t reverse[16];
+  /// permute[v][c] - places the floats of channel `c` in the output vector `v`...
+  alignas(32) int32_t permute[3][3][8];
+  /// ...where select[v][c] is set
+  alignas(32) int32_t select[3][3][8];
+
+  ShuffleTables() {
+    for (int flip = 0; flip < 2; flip++) {
+      for (int c = 0; c < 3; c++) {
+        for (int v = 0; v < 3; v++) {
+          for (int j = 0; j < 16; j++) {
+            int s = 3 * (flip ? 15 - j : j) + c;
+            deinterleave[flip][c][v][j] = s / 16 == v ? s % 16 : -1;
+          }
+        }
+      }
+    }
+    for (int j = 0; j < 16; j++)
+      reverse[j] = 15 - j;
+    for (int v = 0; v < 3; v++) {
+      for (int c = 0; c < 3; c++) {
+        for (int j = 0; j < 8; j++) {
+          int d = 8 * v + j;
+          permute[v][c][j] = d % 3 == c ? d / 3 % 8 : 0;
+          select[v][c][j] = d % 3 == c ? -1 : 0;
+        }
+      }
+    }
+  }
+};
+
+const ShuffleTables &GetShuffleTables() {
+  static const ShuffleTables tables;
+  return tables;
+}
+
+DALI_TARGET_AVX2 inline __m128i LoadMask(const int8_t *mask) {
+  return _mm_load_si128(reinterpret_cast<const __m128i *>(mask));
+}
+
+DALI_TARGET_AVX2 inline __m256i LoadIndices(const int32_t *idx) {
+  return _mm256_load_si256(reinterpret_cast<const __m256i *>(idx));
+}
+
+DALI_TARGET_AVX2 inline __m128i Load(const uint8_t *in) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+}
+
+DALI_TARGET_AVX2 inline __m256 LoLo(__m128i bytes) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+}
+
+DALI_TARGET_AVX2 inline __m256 HiLo(__m128i bytes) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)));
+}
+
+/// Same as NormalizePolicy
+DALI_TARGET_AVX2 inline __m256 Normalize(__m256 v, __m256 mean, __m256 inv_stddev) {
+  return _mm256_mul_ps(_mm256_sub_ps(v, mean), inv_stddev);
+}
+
+/// Gathers the bytes from 3 vectors with 3 shuffle masks
+DALI_TARGET_AVX2 inline __m128i Shuffle3(__m128i a0, __m128i a1, __m128i a2,
+                                         const __m128i (&mask)[3]) {
+  return _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, mask[0]),
+                                   _mm_shuffle_epi8(a1, mask[1])),
+                      _mm_shuffle_epi8(a2, mask[2]));
+}
+
+/// Normalization parameters for up to 3 channels, or repeating patterns of them
+struct NormParams {
+  __m256 mean[3], inv_stddev[3];
+};
+
+/**
+ * @brief Converts a contiguous array of `n` elements; element `i` is normalized with lane
+ *        `i % 8` of the parameters `i / 8 % 3`
+ */
+DALI_TARGET_AVX2 int64_t ConvertContiguous(float *out, const uint8_t *in, int64_t n,
+                                           const NormParams &p) {
+  int64_t i = 0;
+  for (; i + 24 <= n; i += 24) {
+    __m128i a = Load(in + i);
+    __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i + 16));
+    _mm256_storeu_ps(out + i,      Normalize(LoLo(a), p.mean[0], p.inv_stddev[0]));
+    _mm256_storeu_ps(out + i + 8,  Normalize(HiLo(a), p.mean[1], p.inv_stddev[1]));
+    _mm256_storeu_ps(out + i + 16, Normalize(LoLo(b), p.mean[2], p.inv_stddev[2]));
+  }
+  return i;
+}
+
+/// Single channel with reversed order of pixels; `in` points to the first (rightmost) pixel
+DALI_TARGET_AVX2 int64_t ConvertMirrored1(float *out, const uint8_t *in, int64_t num_pixels,
+                                          const NormParams &p) {
+  const __m128i reverse = LoadMask(GetShuffleTables().reverse);
+  int64_t i = 0;
+  for (; i + 16 <= num_pixels; i += 16) {
+    __m128i a = _mm_shuffle_epi8(Load(in - i - 15), reverse);
+    _mm256_storeu_ps(out + i,     Normalize(LoLo(a), p.mean[0], p.inv_stddev[0]));
+    _mm256_storeu_ps(out + i + 8, Normalize(HiLo(a), p.mean[0], p.inv_stddev[0]));
+  }
+  return i;
+}
+
+/// 8 pixels, split into channel planes
+struct Planes8 {
+  __m256 r, g, b;
+};
+
+/// Permutation indices and blend masks for interleaving 8 pixels of float planes
+struct FloatInterleave {
+  __m256i perm[3][3];
+  __m256 select_g[3], select_b[3];
+};
+
+DALI_TARGET_AVX2 inline FloatInterleave LoadFloatInterleave(const ShuffleTables &t) {
+  FloatInterleave fi;
+  for (int k = 0; k < 3; k++) {
+    for (int c = 0; c < 3; c++)
+      fi.perm[k][c] = LoadIndices(t.permute[k][c]);
+    fi.select_g[k] = _mm256_castsi256_ps(LoadIndices(t.select[k][1]));
+    fi.select_b[k] = _mm256_castsi256_ps(LoadIndices(t.select[k][2]));
+  }
+  return fi;
+}
+
+DALI_TARGET_AVX2 inline __m256 Interleave(const Planes8 &p, const FloatInterleave &fi, int k) {
+  __m256 o = _mm256_permutevar8x32_ps(p.r, fi.perm[k][0]);
+  o = _mm256_blendv_ps(o, _mm256_permutevar8x32_ps(p.g, fi.perm[k][1]), fi.select_g[k]);
+  return _mm256_blendv_ps(o, _mm256_permutevar8x32_ps(p.b, fi.perm[k][2]), fi.select_b[k]);
+}
+
+/// Stores 8 pixels as 24 interleaved floats
+DALI_TARGET_AVX2 inline void StoreInterleaved3(float *out, const Planes8 &p,
+                                               const FloatInterleave &fi) {
+  _mm256_storeu_ps(out,      Interleave(p, fi, 0));
+  _mm256_storeu_ps(out + 8,  Interleave(p, fi, 1));
+  _mm256_storeu_ps(out + 16, Interleave(p, fi, 2));
+}
+
+/// Stores 8 pixels as 32 interleaved floats, with the 4th channel set to zero
+DALI_TARGET_AVX2 inline void StoreInterleaved4(float *out, const Planes8 &p) {
+  const __m256 zero = _mm256_setzero_ps();
+  __m256 rg_lo = _mm256_unpacklo_ps(p.r, p.g);  // r0 g0 r1 g1 | r4 g4 r5 g5
+  __m256 rg_hi = _mm256_unpackhi_ps(p.r, p.g);  // r2 g2 r3 g3 | r6 g6 r7 g7
+  __m256 b0_lo = _mm256_unpacklo_ps(p.b, zero);
+  __m256 b0_hi = _mm256_unpackhi_ps(p.b, zero);
+  __m256 px04 = _mm256_shuffle_ps(rg_lo, b0_lo, 0x44);
+  __m256 px15 = _mm256_shuffle_ps(rg_lo, b0_lo, 0xEE);
+  __m256 px26 = _mm256_shuffle_ps(rg_hi, b0_hi, 0x44);
+  __m256 px37 = _mm256_shuffle_ps(rg_hi, b0_hi, 0xEE);
+  _mm256_storeu_ps(out,      _mm256_permute2f128_ps(px04, px15, 0x20));
+  _mm256_storeu_ps(out + 8,  _mm256_permute2f128_ps(px26, px37, 0x20));
+  _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(px04, px15, 0x31));
+  _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(px26, px37, 0x31));
+}
+
+DALI_TARGET_AVX2 inline void StorePlanar(float *out, int64_t plane_stride, bool pad,
+                                         const Planes8 &p) {
+  _mm256_storeu_ps(out, p.r);
+  _mm256_storeu_ps(out + plane_stride, p.g);
+  _mm256_storeu_ps(out + 2 * plane_stride, p.b);
+  if (pad)
+    _mm256_storeu_ps(out + 3 * plane_stride, _mm256_setzero_ps());
+}
+
+/**
+ * @brief 3-channel pixels, deinterleaved and stored with the given layout
+ *
+ * `in` points to the first pixel; if `flip` is set, the subsequent pixels are
+ * at lower addresses.
+ */
+DALI_TARGET_AVX2 int64_t ConvertPlanes3(float *out, const uint8_t *in, int64_t num_pixels,
+                                        bool flip, int64_t padded_channels,
+                                        int64_t out_pixel_stride, int64_t out_channel_stride,
+                                        const NormParams &p) {
+  const auto &t = GetShuffleTables();
+  __m128i mask[3][3];
+  for (int c = 0; c < 3; c++)
+    for (int v = 0; v < 3; v++)
+      mask[c][v] = LoadMask(t.deinterleave[flip][c][v]);
+  const FloatInterleave fi = LoadFloatInterleave(t);
+  const bool planar = out_pixel_stride == 1;
+  const bool pad = padded_channels == 4;
+
+  int64_t i = 0;
+  for (; i + 16 <= num_pixels; i += 16) {
+    const uint8_t *src = flip ? in - 3 * (i + 15) : in + 3 * i;
+    __m128i a0 = Load(src), a1 = Load(src + 16), a2 = Load(src + 32);
+    __m128i r = Shuffle3(a0, a1, a2, mask[0]);
+    __m128i g = Shuffle3(a0, a1, a2, mask[1]);
+    __m128i b = Shuffle3(a0, a1, a2, mask[2]);
+    Planes8 lo = {
+      Normalize(LoLo(r), p.mean[0], p.inv_stddev[0]),
+      Normalize(LoLo(g), p.mean[1], p.inv_stddev[1]),
+      Normalize(LoLo(b), p.mean[2], p.inv_stddev[2])
+    };
+    Planes8 hi = {
+      Normalize(HiLo(r), p.mean[0], p.inv_stddev[0]),
+      Normalize(HiLo(g), p.mean[1], p.inv_stddev[1]),
+      Normalize(HiLo(b), p.mean[2], p.inv_stddev[2])
+    };
+    float *dst = out + i * out_pixel_stride;
+    if (planar) {
+      StorePlanar(dst, out_channel_stride, pad, lo);
+      StorePlanar(dst + 8, out_channel_stride, pad, hi);
+    } else if (pad) {
+      StoreInterleaved4(dst, lo);
+      StoreInterleaved4(dst + 32, hi);
+    } else {
+      StoreInterleaved3(dst, lo, fi);
+      StoreInterleaved3(dst + 24, hi, fi);
+    }
+  }
+  return i;
+}
+
+DALI_TARGET_AVX2 int64_t ConvertPixelsAVX2(float *output, const uint8_t *input,
+                                           int64_t num_pixels,
+                                           int64_t channels, int64_t padded_channels,
+                                           int64_t in_pixel_stride, int64_t out_pixel_stride,
+                                           int64_t out_channel_stride,
+                                           const float *mean, const float *inv_stddev,
+                                           int64_t norm_step) {
+  auto channel_mean = [&](int64_t c) {
+    return mean ? mean[c * norm_step] : 0.0f;
+  };
+  auto channel_inv_stddev = [&](int64_t c) {
+    return inv_stddev ? inv_stddev[c * norm_step] : 1.0f;
+  };
+
+  const bool contiguous = in_pixel_stride == channels && out_pixel_stride == channels &&
+                          out_channel_stride == 1 && padded_channels == channels;
+  if (contiguous && (norm_step == 0 || channels == 1 || channels == 3)) {
+    // element i belongs to channel i % channels; 24 elements are always 8 whole RGB pixels
+    NormParams p;
+    for (int v = 0; v < 3; v++) {
+      alignas(32) float m[8], s[8];
+      for (int j = 0; j < 8; j++) {
+        int64_t c = (8 * v + j) % channels;
+        m[j] = channel_mean(c);
+        s[j] = channel_inv_stddev(c);
+      }
+      p.mean[v] = _mm256_load_ps(m);
+      p.inv_stddev[v] = _mm256_load_ps(s);
+    }
+    // For other numbers of channels, the last pixel may be converted only partially;
+    // it is converted again by the caller, with the same result.
+    return ConvertContiguous(output, input, num_pixels * channels, p) / channels;
+  }
+
+  NormParams p;
+  for (int c = 0; c < 3 && c < channels; c++) {
+    p.mean[c] = _mm256_set1_ps(channel_mean(c));
+    p.inv_stddev[c] = _mm256_set1_ps(channel_inv_stddev(c));
+  }
+
+  if (channels == 1 && in_pixel_stride == -1 && out_pixel_stride == 1 && padded_channels == 1)
+    return ConvertMirrored1(output, input, num_pixels, p);
+
+  if (channels == 3 && (in_pixel_stride == 3 || in_pixel_stride == -3) &&
+      (padded_channels == 3 || padded_channels == 4)) {
+    const bool planar = out_pixel_stride == 1;
+    const bool interleaved = out_channel_stride == 1 && out_pixel_stride == padded_channels;
+    if (planar || interleaved)
+      return ConvertPlanes3(output, input, num_pixels, in_pixel_stride < 0, padded_channels,
+                            out_pixel_stride, out_channel_stride, p);
+  }
+  return 0;
+}
+
+}  // namespace
+
+int64_t ConvertPixelsSIMD(float *output, const uint8_t *input, int64_t num_pixels,
+                          int64_t channels, int64_t padded_channels,
+                          int64_t in_pixel_stride, int64_t out_pixel_stride,
+                          int64_t out_channel_stride,
+                          const float *mean, const float *inv_stddev, int64_t norm_step) {
+  if (!HasAVX2())
+    return 0;
+  return ConvertPixelsAVX2(output, input, num_pixels, channels, padded_channels,
+                           in_pixel_stride, out_pixel_stride, out_channel_stride,
+                           mean, inv_stddev, norm_step);
+}
+
+#else  // DALI_X86_SIMD
+
+int64_t ConvertPixelsSIMD(float *, const uint8_t *, int64_t, int64_t, int64_t,
+                          int64_t, int64_t, int64_t, const float *, const float *, int64_t) {
+  return 0;
+}
+
+#endif  // DALI_X86_SIMD
+
+}  // namespace detail
+}  // namespace kernels
+}  // namespace dali
@@ -94,10 +94,13 @@ class SliceFlipNormalizePermuteTest : public ::testing::Test {
       for (size_t out_idx = 0; out_idx < total_size; out_idx++) {
         size_t idx = out_idx;
         size_t in_idx = 0;
+        size_t norm_idx = 0;
         bool is_zero_pad = false;
         for (size_t d = 0; d < Dims; d++) {
           auto perm_d = permuted_dims[d];
           size_t i_d = idx / out_strides[d];
+          if (static_cast<size_t>(perm_d) == args[i].normalization_dim)
+            norm_idx = i_d;
           is_zero_pad = is_zero_pad ||
             (out_shape[d] > slice_shape[perm_d] && i_d >= static_cast<size_t>(slice_shape[perm_d]));
           idx = idx % out_strides[d];
@@ -110,7 +113,7 @@ class SliceFlipNormalizePermuteTest : public ::testing::Test {
         OutputType output_value = 0;
         if (!is_zero_pad) {
           if (!mean.empty() && !inv_stddev.empty()) {
-            auto c = mean.size() == 1 ? 0 : out_idx % out_shape[Dims - 1];
+            auto c = mean.size() == 1 ? 0 : norm_idx;
             float fpout = (static_cast<float>(in_tensor[in_idx]) - mean[c]) * inv_stddev[c];
             if (std::is_integral<OutputType>::value) {
               output_value = clamp<OutputType>(std::roundf(fpout));
@@ -309,6 +312,32 @@ struct SliceFlipNormPermArgsGen_SliceFlipNormalizePermute_PermuteHWC2CHW {
   }
 };
 
+/**
+ * @brief Same arguments as in CropMirrorNormalize: HWC input, cropped, optionally mirrored
+ *        horizontally, normalized per channel and optionally transposed to CHW and padded
+ *        to 4 channels
+ */
+template <typename OutputType, size_t Dims, bool Mirror, bool ToCHW, bool PadChannels>
+struct SliceFlipNormPermArgsGen_CropMirrorNormalize {
+  SliceFlipNormalizePermuteArgs<Dims> Get(const TensorShape<Dims>& input_shape) {
+    SliceFlipNormalizePermuteArgs<Dims> args(input_shape);
+    args.anchor[0] = input_shape[0] / 8;
+    args.anchor[1] = input_shape[1] / 8;
+    args.shape[0] = args.padded_shape[0] = input_shape[0] - input_shape[0] / 4;
+    args.shape[1] = args.padded_shape[1] = input_shape[1] - input_shape[1] / 4;
+    if (PadChannels)
+      args.padded_shape[2] = 4;
+    args.flip[1] = Mirror;
+    if (ToCHW)
+      args.permuted_dims = { 2, 0, 1 };
+    for (int c = 0; c < args.shape[2]; c++) {
+      args.mean.push_back(100.0f + 10.0f * c);
+      args.inv_stddev.push_back(1.0f / (50.0f + 5.0f * c));
+    }
+    return args;
+  }
+};
+
 template <typename OutputType, size_t Dims, size_t PaddedDim, size_t PadSize>
 struct SliceFlipNormPermArgsGen_OnlyPad_GivenDim {
   SliceFlipNormalizePermuteArgs<Dims> Get(const TensorShape<Dims>& input_shape) {
@@ -373,7 +402,31 @@ using SLICE_FLIP_NORMALIZE_PERMUTE_TEST_TYPES_CPU_ONLY = ::testing::Types<
     SliceTestArgs<uint8_t, float16_cpu, 3, 1, 2,
       SliceFlipNormPermArgsGen_SliceOnly<float16_cpu, 3>>,
     SliceTestArgs<float16_cpu, uint8_t, 3, 1, 2,
-      SliceFlipNormPermArgsGen_SliceOnly<uint8_t, 3>>
+      SliceFlipNormPermArgsGen_SliceOnly<uint8_t, 3>>,
+    SliceTestArgs<uint8_t, uint8_t, 3, 1, 3,
+      SliceFlipNormPermArgsGen_SliceOnly<uint8_t, 3>, 20, 37>,
+    SliceTestArgs<uint8_t, float, 3, 1, 1,
+      SliceFlipNormPermArgsGen_FlipDim<float, 3, 1>, 5, 77>,
+    SliceTestArgs<uint8_t, float, 3, 1, 1,
+      SliceFlipNormPermArgsGen_NormalizeOnly_Scalar<float, 3>, 5, 77>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_NormalizeOnly_Scalar<float, 3>, 20, 37>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, false, false, false>, 20, 75>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, true, false, false>, 20, 75>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, false, false, true>, 20, 75>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, true, false, true>, 20, 75>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, false, true, false>, 20, 75>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, true, true, false>, 20, 75>,
+    SliceTestArgs<uint8_t, float, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<float, 3, true, true, true>, 20, 75>,
+    SliceTestArgs<uint8_t, uint8_t, 3, 1, 3,
+      SliceFlipNormPermArgsGen_CropMirrorNormalize<uint8_t, 3, true, true, true>, 20, 75>
 >;
 
 }  // namespace kernels
@@ -0,0 +1,152 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "dali/kernels/imgproc/resample/resample_crop_normalize_cpu.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+#include "dali/kernels/scratch.h"
+
+namespace dali {
+namespace kernels {
+namespace resample_test {
+
+struct ResampleCropNormalizeCase {
+  int H, W, C;
+  int rsz_h, rsz_w;
+  int crop_y, crop_x, crop_h, crop_w;
+  ResamplingFilterType filter;
+};
+
+class ResampleCropMirrorNormalizeCPUTest
+    : public ::testing::TestWithParam<ResampleCropNormalizeCase> {};
+
+template <typename Kernel, typename Out, typename In, typename Args>
+void RunKernel(Kernel &kernel, const Out &out, const In &in, const Args &args) {
+  KernelContext context;
+  ScratchpadAllocator scratch_alloc;
+  auto req = kernel.Setup(context, in, args);
+  scratch_alloc.Reserve(req.scratch_sizes);
+  auto scratchpad = scratch_alloc.GetScratchpad();
+  context.scratchpad = &scratchpad;
+  kernel.Run(context, out, in, args);
+}
+
+/// Compares the fused kernel with a full resize followed by crop, flip and normalization
+TEST_P(ResampleCropMirrorNormalizeCPUTest, MatchesResizeThenCrop) {
+  auto p = GetParam();
+  std::vector<uint8_t> in(p.H * p.W * p.C);
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto &v : in)
+    v = dist(rng);
+  InTensorCPU<uint8_t, 3> in_view = { in.data(), { p.H, p.W, p.C } };
+
+  ResamplingParams2D params;
+  params[0].output_size = p.rsz_h;
+  params[1].output_size = p.rsz_w;
+  params[0].min_filter = params[1].min_filter = p.filter;
+  params[0].mag_filter = params[1].mag_filter = p.filter;
+
+  std::vector<uint8_t> resized(p.rsz_h * p.rsz_w * p.C);
+  OutTensorCPU<uint8_t, 3> resized_view = { resized.data(), { p.rsz_h, p.rsz_w, p.C } };
+  SeparableResampleCPU<uint8_t, uint8_t> resample;
+  RunKernel(resample, resized_view, in_view, params);
+
+  ResampleCropMirrorNormalizeArgs args;
+  args.resample = params;
+  args.crop_anchor = {{ p.crop_y, p.crop_x }};
+  args.crop_shape = {{ p.crop_h, p.crop_w }};
+  for (int c = 0; c < p.C; c++) {
+    args.mean.push_back(10.0f * c + 5);
+    args.inv_stddev.push_back(1.0f / (c + 1));
+  }
+
+  for (bool planar : { false, true }) {
+    for (bool mirror : { false, true }) {
+      args.planar = planar;
+      args.mirror = mirror;
+      std::vector<float> out(p.crop_h * p.crop_w * p.C);
+      OutTensorCPU<float, 3> out_view = { out.data(), planar
+        ? TensorShape<3>{ p.C, p.crop_h, p.crop_w }
+        : TensorShape<3>{ p.crop_h, p.crop_w, p.C } };
+      ResampleCropMirrorNormalizeCPU<float, uint8_t> kernel;
+      RunKernel(kernel, out_view, in_view, args);
+
+      for (int y = 0; y < p.crop_h; y++) {
+        for (int x = 0; x < p.crop_w; x++) {
+          int src_x = p.crop_x + (mirror ? p.crop_w - 1 - x : x);
+          for (int c = 0; c < p.C; c++) {
+            float ref = resized[((p.crop_y + y) * p.rsz_w + src_x) * p.C + c];
+            ref = (ref - args.mean[c]) * args.inv_stddev[c];
+            float value = planar
+              ? out[(c * p.crop_h + y) * p.crop_w + x]
+              : out[(y * p.crop_w + x) * p.C + c];
+            // the crop window is resampled with a different origin - allow off-by-one
+            ASSERT_NEAR(value, ref, args.inv_stddev[c] + 1e-5f)
+              << "at (" << y << ", " << x << ", " << c << ") planar: " << planar
+              << " mirror: " << mirror;
+          }
+        }
+      }
+    }
+  }
+}
+
+static std::vector<ResampleCropNormalizeCase> ResampleCropNormalizeCases = {
+  { 375, 500, 3, 256, 341, 16, 58, 224, 224, ResamplingFilterType::Triangular },
+  { 480, 640, 3, 300, 300, 0, 76, 224, 224, ResamplingFilterType::Linear },
+  { 480, 640, 3, 256, 256, 10, 20, 224, 224, ResamplingFilterType::Cubic },
+  { 100, 80, 1, 200, 160, 10, 0, 190, 160, ResamplingFilterType::Lanczos3 },
+  { 33, 47, 4, 33, 47, 3, 5, 20, 30, ResamplingFilterType::Linear },
+};
+
+INSTANTIATE_TEST_SUITE_P(ResampleCropNormalize, ResampleCropMirrorNormalizeCPUTest,
+                         ::testing::ValuesIn(ResampleCropNormalizeCases));
+
+TEST(ResampleCropMirrorNormalizeCPU, NearestNeighbor) {
+  const int H = 480, W = 640, C = 3;
+  std::vector<uint8_t> in(H * W * C);
+  for (size_t i = 0; i < in.size(); i++)
+    in[i] = i * 7;
+  InTensorCPU<uint8_t, 3> in_view = { in.data(), { H, W, C } };
+
+  ResampleCropMirrorNormalizeArgs args;
+  args.resample[0].output_size = 300;
+  args.resample[1].output_size = 300;
+  args.crop_anchor = {{ 0, 76 }};
+  args.crop_shape = {{ 224, 224 }};
+  args.planar = false;
+
+  std::vector<float> out(224 * 224 * C);
+  OutTensorCPU<float, 3> out_view = { out.data(), { 224, 224, C } };
+  ResampleCropMirrorNormalizeCPU<float, uint8_t> kernel;
+  RunKernel(kernel, out_view, in_view, args);
+
+  for (int y = 0; y < 224; y++) {
+    for (int x = 0; x < 224; x++) {
+      int src_y = (y + 0.5f) * H / 300;
+      int src_x = (76 + x + 0.5f) * W / 300;
+      for (int c = 0; c < C; c++) {
+        ASSERT_EQ(out[(y * 224 + x) * C + c], in[(src_y * W + src_x) * C + c])
+          << "at (" << y << ", " << x << ", " << c << ")";
+      }
+    }
+  }
+}
+
+}  // namespace resample_test
+}  // namespace kernels
+}  // namespace dali
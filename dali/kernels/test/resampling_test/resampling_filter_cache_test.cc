@@ -0,0 +1,113 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "dali/kernels/imgproc/resample/resampling_filter_cache.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+#include "dali/kernels/scratch.h"
+
+namespace dali {
+namespace kernels {
+namespace resample_test {
+
+TEST(ResamplingFilterCache, HitMissAndEviction) {
+  auto filters = GetResamplingFiltersCPU();
+  auto tri = filters->Triangular(2.0f);
+  auto cubic = filters->Cubic();
+  ResamplingFilterCache cache(2);
+
+  auto t1 = cache.Get(200, 100, 0, 2.0f, ResamplingFilterType::Triangular, tri);
+  EXPECT_EQ(cache.stats().misses, 1);
+  EXPECT_EQ(cache.stats().hits, 0);
+
+  std::vector<int32_t> ref_idx(100);
+  std::vector<float> ref_coeffs(100 * tri.support());
+  InitializeResamplingFilter(ref_idx.data(), ref_coeffs.data(), 100, 0, 2.0f, tri);
+  ASSERT_EQ(t1.support, tri.support());
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(t1.indices[i], ref_idx[i]);
+  for (size_t i = 0; i < ref_coeffs.size(); i++)
+    EXPECT_EQ(t1.coeffs[i], ref_coeffs[i]);
+
+  auto t2 = cache.Get(200, 100, 0, 2.0f, ResamplingFilterType::Triangular, tri);
+  EXPECT_EQ(cache.stats().hits, 1);
+  EXPECT_EQ(t2.indices, t1.indices);
+  EXPECT_EQ(t2.coeffs, t1.coeffs);
+
+  // any difference in the key is a miss
+  cache.Get(200, 100, 0.5f, 2.0f, ResamplingFilterType::Triangular, tri);
+  EXPECT_EQ(cache.stats().misses, 2);
+  EXPECT_EQ(cache.size(), 2);
+
+  // the least recently used entry (origin 0) is evicted
+  cache.Get(200, 100, 0, 2.0f, ResamplingFilterType::Cubic, cubic);
+  EXPECT_EQ(cache.stats().misses, 3);
+  EXPECT_EQ(cache.size(), 2);
+  cache.Get(200, 100, 0.5f, 2.0f, ResamplingFilterType::Triangular, tri);
+  EXPECT_EQ(cache.stats().hits, 2);
+  cache.Get(200, 100, 0, 2.0f, ResamplingFilterType::Triangular, tri);
+  EXPECT_EQ(cache.stats().misses, 4);
+
+  cache.ResetStats();
+  EXPECT_EQ(cache.stats().hits, 0);
+  EXPECT_EQ(cache.stats().misses, 0);
+}
+
+TEST(ResamplingFilterCache, SeparableResampleCPUReusesFilters) {
+  const int H = 120, W = 160, C = 3;
+  std::vector<uint8_t> in1(H * W * C), in2(H * W * C);
+  std::mt19937 rng(4321);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (auto &v : in1)
+    v = dist(rng);
+  for (auto &v : in2)
+    v = dist(rng);
+
+  ResamplingParams2D params;
+  params[0].output_size = 50;
+  params[1].output_size = 70;
+  params[0].min_filter = params[1].min_filter = ResamplingFilterType::Triangular;
+
+  auto run = [&](SeparableResampleCPU<uint8_t, uint8_t> &kernel, const std::vector<uint8_t> &in) {
+    InTensorCPU<uint8_t, 3> in_view = { in.data(), { H, W, C } };
+    std::vector<uint8_t> out(50 * 70 * C);
+    OutTensorCPU<uint8_t, 3> out_view = { out.data(), { 50, 70, C } };
+    KernelContext context;
+    ScratchpadAllocator scratch_alloc;
+    auto req = kernel.Setup(context, in_view, params);
+    scratch_alloc.Reserve(req.scratch_sizes);
+    auto scratchpad = scratch_alloc.GetScratchpad();
+    context.scratchpad = &scratchpad;
+    kernel.Run(context, out_view, in_view, params);
+    return out;
+  };
+
+  SeparableResampleCPU<uint8_t, uint8_t> kernel;
+  run(kernel, in1);
+  EXPECT_EQ(kernel.FilterCacheStats().misses, 2);
+  EXPECT_EQ(kernel.FilterCacheStats().hits, 0);
+
+  auto out2 = run(kernel, in2);
+  EXPECT_EQ(kernel.FilterCacheStats().misses, 2);
+  EXPECT_EQ(kernel.FilterCacheStats().hits, 2);
+
+  SeparableResampleCPU<uint8_t, uint8_t> fresh;
+  EXPECT_EQ(run(fresh, in2), out2);
+}
+
+}  // namespace resample_test
+}  // namespace kernels
+}  // namespace dali
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 #include <opencv2/imgcodecs.hpp>
+#include <random>
+#include <vector>
 #include "dali/kernels/test/test_data.h"
 #include "dali/kernels/test/tensor_test_utils.h"
 #include "dali/kernels/imgproc/resample/resampling_filters.cuh"
@@ -237,6 +239,88 @@ TEST(ResampleCPU, Linear) {
   Check(ref_tensor, out_tensor);
 }
 
+namespace {
+
+/// Random filter of given support, with windows partially outside the input at both ends
+void RandomFilter(std::vector<int32_t> &indices, std::vector<float> &coeffs,
+                  int in_size, int out_size, int support, std::mt19937 &rng) {
+  std::uniform_real_distribution<float> dist(0, 1);
+  indices.resize(out_size);
+  coeffs.resize(out_size * support);
+  float scale = static_cast<float>(in_size) / out_size;
+  for (int i = 0; i < out_size; i++) {
+    indices[i] = static_cast<int>(std::floor((i + 0.5f) * scale)) - support / 2;
+    float sum = 0;
+    for (int k = 0; k < support; k++)
+      sum += coeffs[i * support + k] = dist(rng);
+    for (int k = 0; k < support; k++)
+      coeffs[i * support + k] /= sum;
+  }
+}
+
+template <typename T>
+std::vector<T> RandomImage(int w, int h, int c, std::mt19937 &rng) {
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<T> data(w * h * c);
+  for (auto &x : data)
+    x = dist(rng);
+  return data;
+}
+
+template <typename Out, typename In>
+void TestSIMDBitExact(int axis) {
+  std::mt19937 rng(1234);
+  for (int channels = 1; channels <= 4; channels++) {
+    for (int support : {1, 2, 3, 7}) {
+      for (int out_extent : {1, 5, 31, 97}) {
+        int in_w = 67, in_h = 45;
+        int out_w = axis == 1 ? out_extent : in_w;
+        int out_h = axis == 0 ? out_extent : in_h;
+        auto in_data = RandomImage<In>(in_w, in_h, channels, rng);
+        std::vector<int32_t> indices;
+        std::vector<float> coeffs;
+        RandomFilter(indices, coeffs, axis == 1 ? in_w : in_h, out_extent, support, rng);
+
+        std::vector<Out> ref(out_w * out_h * channels), out(ref.size());
+        Surface2D<const In> in = { in_data.data(), in_w, in_h, channels,
+                                   channels, in_w * channels, 1 };
+        Surface2D<Out> ref_surf = { ref.data(), out_w, out_h, channels,
+                                    channels, out_w * channels, 1 };
+        Surface2D<Out> out_surf = ref_surf;
+        out_surf.data = out.data();
+
+        if (axis == 0) {
+          ResampleVertScalar(ref_surf, in, indices.data(), coeffs.data(), support);
+          ResampleVert(out_surf, in, indices.data(), coeffs.data(), support);
+        } else {
+          ResampleHorzScalar(ref_surf, in, indices.data(), coeffs.data(), support);
+          ResampleHorz(out_surf, in, indices.data(), coeffs.data(), support);
+        }
+        for (size_t i = 0; i < ref.size(); i++) {
+          ASSERT_EQ(out[i], ref[i]) << "at " << i << ", channels = " << channels
+                                    << ", support = " << support << ", extent = " << out_extent;
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(ResampleCPU, SIMD_BitExact_Vert) {
+  TestSIMDBitExact<float, uint8_t>(0);
+  TestSIMDBitExact<uint8_t, float>(0);
+  TestSIMDBitExact<float, float>(0);
+  TestSIMDBitExact<uint8_t, uint8_t>(0);
+}
+
+TEST(ResampleCPU, SIMD_BitExact_Horz) {
+  TestSIMDBitExact<float, uint8_t>(1);
+  TestSIMDBitExact<uint8_t, float>(1);
+  TestSIMDBitExact<float, float>(1);
+  TestSIMDBitExact<uint8_t, uint8_t>(1);
+}
+
 
 }  // namespace kernels
 }  // namespace dali
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "dali/pipeline/data/allocator.h"
+#include "dali/pipeline/data/pooled_allocator.h"
 
 namespace dali {
 
@@ -24,5 +25,7 @@ DALI_DEFINE_OPTYPE_REGISTRY(CPUAllocator, CPUAllocator);
 DALI_REGISTER_GPU_ALLOCATOR(GPUAllocator, GPUAllocator);
 DALI_REGISTER_CPU_ALLOCATOR(CPUAllocator, CPUAllocator);
 DALI_REGISTER_CPU_ALLOCATOR(PinnedCPUAllocator, PinnedCPUAllocator);
+DALI_REGISTER_CPU_ALLOCATOR(PooledCPUAllocator, PooledCPUAllocator);
+DALI_REGISTER_CPU_ALLOCATOR(PooledPinnedCPUAllocator, PooledPinnedCPUAllocator);
 
 }  // namespace dali
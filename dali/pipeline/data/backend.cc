@@ -147,6 +147,14 @@ GPUAllocator& GetGPUAllocator() {
   return AllocatorManager::GetGPUAllocator();
 }
 
+CPUAllocator& GetCPUAllocator() {
+  return AllocatorManager::GetCPUAllocator();
+}
+
+CPUAllocator& GetPinnedCPUAllocator() {
+  return AllocatorManager::GetPinnedCPUAllocator();
+}
+
 void* GPUBackend::New(size_t bytes, bool) {
   void *ptr = nullptr;
   AllocatorManager::GetGPUAllocator().New(&ptr, bytes);
@@ -35,6 +35,9 @@ DLL_PUBLIC void SetGPUAllocator(const OpSpec& allocator);
 DLL_PUBLIC void SetGPUAllocator(std::unique_ptr<GPUAllocator> allocator);
 
 GPUAllocator& GetGPUAllocator();
+DLL_PUBLIC CPUAllocator& GetCPUAllocator();
+DLL_PUBLIC CPUAllocator& GetPinnedCPUAllocator();
+
 /**
  * @brief Provides access to GPU allocator and other GPU meta-data.
  */
@@ -15,6 +15,8 @@
 #ifndef DALI_PIPELINE_DATA_BUFFER_H_
 #define DALI_PIPELINE_DATA_BUFFER_H_
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -42,6 +44,28 @@ inline string ShapeString(vector<Index> shape) {
   return tmp;
 }
 
+/**
+ * @brief Controls how a Buffer grows and shrinks its allocation
+ *
+ * When the buffer has to grow, it allocates at least `growth_factor` times its current
+ * capacity and no less than `min_reservation` bytes.
+ *
+ * If `shrink_after` is positive, a buffer whose requested size stays below
+ * `shrink_threshold` of its capacity for `shrink_after` consecutive resizes is reallocated
+ * to fit - so that a single huge outlier doesn't hold on to memory indefinitely.
+ * Note that the count is in resizes, not pipeline iterations: an operator may resize
+ * its output more than once per iteration.
+ * As with growing, the contents are not preserved when the buffer is shrunk.
+ *
+ * The default policy allocates the exact size (with padding) and never shrinks.
+ */
+struct BufferGrowthPolicy {
+  double growth_factor = 1.0;
+  size_t min_reservation = 0;
+  double shrink_threshold = 0.5;
+  int shrink_after = 0;
+};
+
 // NOTE: Data storage types in DALI use delayed allocation, and have a
 // small custom type system that allows us to circumvent template
 // paramters. This is turn allows the Pipeline to manage all intermediate
@@ -195,6 +219,29 @@ class Buffer {
     return pinned_;
   }
 
+  /**
+   * @brief Sets the policy used when the buffer grows or shrinks
+   */
+  inline void set_growth_policy(const BufferGrowthPolicy &policy) {
+    DALI_ENFORCE(policy.growth_factor >= 1.0, "Growth factor must be at least 1");
+    DALI_ENFORCE(policy.shrink_threshold >= 0 && policy.shrink_threshold <= 1,
+                 "Shrink threshold must be between 0 and 1");
+    growth_policy_ = policy;
+    low_use_count_ = 0;
+  }
+
+  inline const BufferGrowthPolicy &growth_policy() const {
+    return growth_policy_;
+  }
+
+  /**
+   * @brief Returns the number of times an existing allocation was replaced
+   * with a new one (either to grow or to shrink)
+   */
+  inline size_t num_reallocs() const {
+    return num_reallocs_.load(std::memory_order_relaxed);
+  }
+
   /**
    * @brief Returns a device this buffer was allocated on
    * If the backend is CPUBackend, return -1
@@ -233,22 +280,7 @@ class Buffer {
 
   inline void reserve(size_t new_num_bytes) {
     if (new_num_bytes <= num_bytes_) return;
-
-    // re-allocating: get the device
-    if (std::is_same<Backend, GPUBackend>::value) {
-      CUDA_CALL(cudaGetDevice(&device_));
-    } else {
-      device_ = -1;
-    }
-
-    DALI_ENFORCE(!shares_data_,
-                 "Cannot reallocate Buffer if it is sharing data. "
-                 "Clear the status by `Reset()` first.");
-    data_.reset();
-    data_.reset(Backend::New(new_num_bytes, pinned_),
-                std::bind(FreeMemory, std::placeholders::_1, new_num_bytes, device_, pinned_));
-
-    num_bytes_ = new_num_bytes;
+    Reallocate(new_num_bytes);
   }
 
   void reset() {
@@ -268,6 +300,13 @@ class Buffer {
     return shares_data_;
   }
 
+  /**
+   * @brief Returns the pointer to the underlying storage, which keeps it alive
+   */
+  inline const shared_ptr<void> &get_data_ptr() const {
+    return data_;
+  }
+
   DISABLE_COPY_MOVE_ASSIGN(Buffer);
 
  protected:
@@ -277,6 +316,49 @@ class Buffer {
     Backend::Delete(ptr, bytes, pinned);
   }
 
+  // Replaces the underlying allocation with one of `new_num_bytes` bytes
+  inline void Reallocate(size_t new_num_bytes) {
+    // re-allocating: get the device
+    if (std::is_same<Backend, GPUBackend>::value) {
+      CUDA_CALL(cudaGetDevice(&device_));
+    } else {
+      device_ = -1;
+    }
+
+    DALI_ENFORCE(!shares_data_,
+                 "Cannot reallocate Buffer if it is sharing data. "
+                 "Clear the status by `Reset()` first.");
+    if (data_)
+      num_reallocs_.fetch_add(1, std::memory_order_relaxed);
+    low_use_count_ = 0;
+    data_.reset();
+    data_.reset(Backend::New(new_num_bytes, pinned_),
+                std::bind(FreeMemory, std::placeholders::_1, new_num_bytes, device_, pinned_));
+
+    num_bytes_ = new_num_bytes;
+  }
+
+  // Shrinks the allocation if it's been underused for long enough, as dictated by the policy
+  inline void ShrinkIfUnderused(size_t new_num_bytes) {
+    const auto &policy = growth_policy_;
+    if (policy.shrink_after <= 0 || shares_data_ || !data_)
+      return;
+    if (new_num_bytes >= num_bytes_ * policy.shrink_threshold) {
+      low_use_count_ = 0;
+      return;
+    }
+    if (++low_use_count_ < policy.shrink_after)
+      return;
+    size_t fit = std::max(RoundUp(new_num_bytes), policy.min_reservation);
+    if (fit < num_bytes_)
+      Reallocate(fit);
+    low_use_count_ = 0;
+  }
+
+  static inline size_t RoundUp(size_t bytes) {
+    return (bytes + kPaddding - 1) & ~(kPaddding - 1);
+  }
+
   // Helper to resize the underlying allocation
   inline void ResizeHelper(Index new_size) {
     DALI_ENFORCE(new_size >= 0, "Input size less than zero not supported.");
@@ -304,14 +386,16 @@ class Buffer {
     }
 
     if (new_num_bytes > num_bytes_) {
-      size_t grow = num_bytes_ * kAllocMult;
+      size_t grow = num_bytes_ * growth_policy_.growth_factor;
+      grow = std::max(grow, growth_policy_.min_reservation);
       grow = (grow + kPaddding) & ~(kPaddding - 1);
       if (grow > new_num_bytes) new_num_bytes = grow;
       reserve(new_num_bytes);
+    } else {
+      ShrinkIfUnderused(new_num_bytes);
     }
   }
 
-  const double kAllocMult = 1.0;
   // round to 1kB
   static constexpr size_t kPaddding = 1024;
 
@@ -324,6 +408,11 @@ class Buffer {
   int device_ = -1;                  // device the buffer was allocated on
   bool shares_data_ = false;         // Whether we aren't using our own allocation
   bool pinned_ = true;               // Whether the allocation uses pinned memory
+  BufferGrowthPolicy growth_policy_;
+  // Number of times an existing allocation was replaced; atomic, so that it can be
+  // read by a thread other than the one resizing the buffer
+  std::atomic<size_t> num_reallocs_{0};
+  int low_use_count_ = 0;            // Consecutive resizes below the shrink threshold
 };
 
 // Macro so we don't have to list these in all
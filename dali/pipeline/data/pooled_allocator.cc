@@ -0,0 +1,339 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/data/pooled_allocator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/operators/op_schema.h"
+
+namespace dali {
+
+DALI_SCHEMA(PooledCPUAllocator)
+  .DocStr(R"code(Caching CPU allocator with size classes and per-thread magazines.)code")
+  .AddOptionalArg("max_cached_bytes",
+      R"code(Maximum total size of free blocks kept for reuse.)code", 1 << 30)
+  .AddOptionalArg("max_block_size",
+      R"code(Allocations larger than this are passed directly to the underlying allocator.)code",
+      64 << 20)
+  .AddOptionalArg("magazine_size",
+      R"code(Number of free blocks of each size class kept in a per-thread magazine.
+0 disables the magazines.)code", 4)
+  .MakeInternal();
+
+DALI_SCHEMA(PooledPinnedCPUAllocator)
+  .DocStr(R"code(Caching pinned CPU allocator with size classes and per-thread magazines.)code")
+  .AddParent("PooledCPUAllocator")
+  .MakeInternal();
+
+namespace {
+
+constexpr int kMinBlockLog2 = 12;
+constexpr size_t kMinBlockSize = size_t(1) << kMinBlockLog2;
+constexpr int kClassesPerOctave = 4;
+// Larger blocks are always returned to the shared depot
+constexpr size_t kMaxMagazineBlockSize = 1 << 20;
+
+inline int ilog2(size_t x) {
+  int l = -1;
+  for (; x; x >>= 1)
+    l++;
+  return l;
+}
+
+/// Index of the smallest size class that can hold `bytes` bytes
+inline int SizeClass(size_t bytes) {
+  if (bytes <= kMinBlockSize)
+    return 0;
+  int msb = ilog2(bytes - 1);
+  size_t base = size_t(1) << msb;
+  size_t step = base / kClassesPerOctave;
+  int k = (bytes - base + step - 1) / step;
+  return (msb - kMinBlockLog2) * kClassesPerOctave + k;
+}
+
+inline size_t ClassSize(int cls) {
+  if (cls == 0)
+    return kMinBlockSize;
+  int octave = (cls - 1) / kClassesPerOctave;
+  int k = cls - octave * kClassesPerOctave;
+  size_t base = kMinBlockSize << octave;
+  return base + k * (base / kClassesPerOctave);
+}
+
+}  // namespace
+
+struct PooledCPUAllocator::Pool : std::enable_shared_from_this<Pool> {
+  struct Magazine {
+    std::mutex mutex;
+    std::vector<std::vector<void *>> blocks;
+    bool in_use = false;
+  };
+
+  Pool(std::unique_ptr<CPUAllocator> upstream,
+       size_t max_cached_bytes, size_t max_block_size, int magazine_size)
+  : upstream(std::move(upstream))
+  , max_cached_bytes(max_cached_bytes)
+  , num_classes(SizeClass(max_block_size) + 1)
+  , magazine_size(magazine_size)
+  , num_magazine_classes(std::min(SizeClass(kMaxMagazineBlockSize) + 1, num_classes))
+  , depot(num_classes) {
+    static std::atomic<uint64_t> next_id(0);
+    id = next_id++;
+  }
+
+  ~Pool() {
+    for (auto &mag : magazines)
+      for (int cls = 0; cls < static_cast<int>(mag->blocks.size()); cls++)
+        Free(mag->blocks[cls], ClassSize(cls));
+    for (int cls = 0; cls < num_classes; cls++)
+      Free(depot[cls], ClassSize(cls));
+  }
+
+  void Free(std::vector<void *> &blocks, size_t size) {
+    for (void *ptr : blocks) {
+      try {
+        upstream->Delete(ptr, size);
+      } catch (...) {
+        // the underlying allocator may be unusable at shutdown - nothing to be done about it
+      }
+    }
+    blocks.clear();
+  }
+
+  bool UseMagazine(int cls) const {
+    return cls < num_magazine_classes && magazine_size > 0;
+  }
+
+  /**
+   * @brief Magazines of the current thread, one per pool
+   *
+   * When the thread exits, the blocks are handed back to the pools' depots.
+   */
+  struct ThreadMagazines {
+    struct Ref {
+      std::weak_ptr<Pool> pool;
+      Magazine *magazine;
+    };
+
+    ~ThreadMagazines() {
+      for (auto &r : refs)
+        if (auto pool = r.second.pool.lock())
+          pool->FlushMagazine(r.second.magazine, true);
+    }
+
+    std::unordered_map<uint64_t, Ref> refs;
+  };
+
+  Magazine *GetMagazine();
+
+  /// Moves the blocks from the magazine to the depot, optionally making it available
+  /// to other threads
+  void FlushMagazine(Magazine *mag, bool release) {
+    std::lock_guard<std::mutex> mag_lock(mag->mutex);
+    std::lock_guard<std::mutex> depot_lock(depot_mutex);
+    for (int cls = 0; cls < static_cast<int>(mag->blocks.size()); cls++) {
+      auto &blocks = mag->blocks[cls];
+      depot[cls].insert(depot[cls].end(), blocks.begin(), blocks.end());
+      blocks.clear();
+    }
+    if (release)
+      mag->in_use = false;
+  }
+
+  std::unique_ptr<CPUAllocator> upstream;
+  const size_t max_cached_bytes;
+  const int num_classes;
+  const int magazine_size;
+  const int num_magazine_classes;
+  uint64_t id;
+
+  std::mutex depot_mutex;
+  std::vector<std::vector<void *>> depot;
+  std::vector<std::unique_ptr<Magazine>> magazines;  // guarded by depot_mutex
+
+  std::atomic<int64_t> hits{0}, misses{0}, bytes_cached{0}, bytes_allocated{0};
+};
+
+PooledCPUAllocator::Pool::Magazine *PooledCPUAllocator::Pool::GetMagazine() {
+  static thread_local ThreadMagazines thread_magazines;
+  auto &refs = thread_magazines.refs;
+  auto it = refs.find(id);
+  if (it != refs.end())
+    return it->second.magazine;
+
+  // forget the magazines of pools that no longer exist
+  for (auto r = refs.begin(); r != refs.end(); ) {
+    if (r->second.pool.expired())
+      r = refs.erase(r);
+    else
+      ++r;
+  }
+
+  Magazine *mag = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(depot_mutex);
+    for (auto &m : magazines) {
+      if (!m->in_use) {
+        mag = m.get();
+        break;
+      }
+    }
+    if (!mag) {
+      magazines.emplace_back(new Magazine());
+      mag = magazines.back().get();
+      mag->blocks.resize(num_magazine_classes);
+    }
+    mag->in_use = true;
+  }
+  refs[id] = { shared_from_this(), mag };
+  return mag;
+}
+
+PooledCPUAllocator::PooledCPUAllocator(const OpSpec &spec)
+: PooledCPUAllocator(spec, std::unique_ptr<CPUAllocator>(new CPUAllocator(spec))) {}
+
+PooledCPUAllocator::PooledCPUAllocator(const OpSpec &spec,
+                                       std::unique_ptr<CPUAllocator> upstream)
+: CPUAllocator(spec) {
+  int64_t max_cached_bytes = spec.GetArgument<int64_t>("max_cached_bytes");
+  int64_t max_block_size = spec.GetArgument<int64_t>("max_block_size");
+  int magazine_size = spec.GetArgument<int>("magazine_size");
+  DALI_ENFORCE(max_cached_bytes >= 0, "`max_cached_bytes` must not be negative");
+  DALI_ENFORCE(max_block_size >= 0, "`max_block_size` must not be negative");
+  DALI_ENFORCE(magazine_size >= 0, "`magazine_size` must not be negative");
+  pool_ = std::make_shared<Pool>(std::move(upstream), max_cached_bytes, max_block_size,
+                                 magazine_size);
+}
+
+PooledCPUAllocator::~PooledCPUAllocator() = default;
+
+size_t PooledCPUAllocator::BlockSize(size_t bytes) const {
+  int cls = SizeClass(bytes);
+  return cls < pool_->num_classes ? ClassSize(cls) : bytes;
+}
+
+void PooledCPUAllocator::New(void **ptr, size_t bytes) {
+  Pool &pool = *pool_;
+  int cls = SizeClass(bytes);
+  if (cls >= pool.num_classes) {
+    pool.upstream->New(ptr, bytes);
+    pool.misses++;
+    pool.bytes_allocated += bytes;
+    return;
+  }
+  size_t size = ClassSize(cls);
+
+  void *block = nullptr;
+  if (pool.UseMagazine(cls)) {
+    auto *mag = pool.GetMagazine();
+    std::lock_guard<std::mutex> lock(mag->mutex);
+    auto &blocks = mag->blocks[cls];
+    if (!blocks.empty()) {
+      block = blocks.back();
+      blocks.pop_back();
+    }
+  }
+  if (!block) {
+    std::lock_guard<std::mutex> lock(pool.depot_mutex);
+    auto &blocks = pool.depot[cls];
+    if (!blocks.empty()) {
+      block = blocks.back();
+      blocks.pop_back();
+    }
+  }
+
+  if (block) {
+    pool.hits++;
+    pool.bytes_cached -= size;
+    *ptr = block;
+  } else {
+    pool.upstream->New(ptr, size);
+    pool.misses++;
+    pool.bytes_allocated += size;
+  }
+}
+
+void PooledCPUAllocator::Delete(void *ptr, size_t bytes) {
+  if (!ptr)
+    return;
+  Pool &pool = *pool_;
+  int cls = SizeClass(bytes);
+  if (cls >= pool.num_classes) {
+    pool.upstream->Delete(ptr, bytes);
+    pool.bytes_allocated -= bytes;
+    return;
+  }
+  int64_t size = ClassSize(cls);
+
+  if (pool.bytes_cached.fetch_add(size) + size > static_cast<int64_t>(pool.max_cached_bytes)) {
+    pool.bytes_cached -= size;
+    pool.upstream->Delete(ptr, size);
+    pool.bytes_allocated -= size;
+    return;
+  }
+
+  if (pool.UseMagazine(cls)) {
+    auto *mag = pool.GetMagazine();
+    std::lock_guard<std::mutex> lock(mag->mutex);
+    auto &blocks = mag->blocks[cls];
+    if (static_cast<int>(blocks.size()) < pool.magazine_size) {
+      blocks.push_back(ptr);
+      return;
+    }
+  }
+  std::lock_guard<std::mutex> lock(pool.depot_mutex);
+  pool.depot[cls].push_back(ptr);
+}
+
+PooledCPUAllocator::Stats PooledCPUAllocator::GetStats() const {
+  Stats stats;
+  stats.hits = pool_->hits;
+  stats.misses = pool_->misses;
+  stats.bytes_cached = pool_->bytes_cached;
+  stats.bytes_allocated = pool_->bytes_allocated;
+  return stats;
+}
+
+void PooledCPUAllocator::ResetStats() {
+  pool_->hits = 0;
+  pool_->misses = 0;
+}
+
+void PooledCPUAllocator::ReleaseCached() {
+  Pool &pool = *pool_;
+  if (pool.magazine_size > 0)
+    pool.FlushMagazine(pool.GetMagazine(), false);
+
+  std::lock_guard<std::mutex> lock(pool.depot_mutex);
+  // Magazines of threads that exited are already in the depot.
+  for (int cls = 0; cls < pool.num_classes; cls++) {
+    int64_t size = ClassSize(cls);
+    int64_t n = pool.depot[cls].size();
+    pool.Free(pool.depot[cls], size);
+    pool.bytes_cached -= n * size;
+    pool.bytes_allocated -= n * size;
+  }
+}
+
+PooledPinnedCPUAllocator::PooledPinnedCPUAllocator(const OpSpec &spec)
+: PooledCPUAllocator(spec, std::unique_ptr<CPUAllocator>(new PinnedCPUAllocator(spec))) {}
+
+}  // namespace dali
@@ -0,0 +1,98 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_DATA_POOLED_ALLOCATOR_H_
+#define DALI_PIPELINE_DATA_POOLED_ALLOCATOR_H_
+
+#include <cstdint>
+#include <memory>
+#include "dali/core/common.h"
+#include "dali/pipeline/data/allocator.h"
+#include "dali/pipeline/operators/op_spec.h"
+
+namespace dali {
+
+/**
+ * @brief Caching CPU allocator with size classes and per-thread magazines
+ *
+ * Requested sizes are rounded up to a size class (4 classes per power of two,
+ * at least `min_block_size`). Freed blocks are not returned to the underlying
+ * allocator, but kept for reuse by subsequent allocations of the same class:
+ * small blocks go to a magazine of the freeing thread first, so that steady-state
+ * reallocations don't contend on a lock; larger blocks and magazine overflow go to
+ * a shared depot.
+ *
+ * Blocks larger than `max_block_size` are not cached. When caching a block would
+ * exceed `max_cached_bytes`, the block is freed instead.
+ *
+ * `Delete` must be called with the same number of bytes that was passed to `New`.
+ */
+class DLL_PUBLIC PooledCPUAllocator : public CPUAllocator {
+ public:
+  struct Stats {
+    /// Allocations served from the cache
+    int64_t hits;
+    /// Allocations that reached the underlying allocator
+    int64_t misses;
+    /// Bytes held in free blocks, available for reuse
+    int64_t bytes_cached;
+    /// Bytes currently obtained from the underlying allocator, including the cached ones
+    int64_t bytes_allocated;
+  };
+
+  explicit PooledCPUAllocator(const OpSpec &spec);
+  ~PooledCPUAllocator() override;
+
+  void New(void **ptr, size_t bytes) override;
+
+  void Delete(void *ptr, size_t bytes) override;
+
+  Stats GetStats() const;
+
+  void ResetStats();
+
+  /**
+   * @brief Returns all free blocks (except those in other threads' magazines)
+   *        to the underlying allocator
+   */
+  void ReleaseCached();
+
+  /**
+   * @brief Size of a block that is actually allocated for a request of `bytes` bytes
+   */
+  size_t BlockSize(size_t bytes) const;
+
+ protected:
+  PooledCPUAllocator(const OpSpec &spec, std::unique_ptr<CPUAllocator> upstream);
+
+ private:
+  struct Pool;
+  std::shared_ptr<Pool> pool_;
+};
+
+/**
+ * @brief PooledCPUAllocator backed by pinned memory
+ *
+ * Caching makes a particular difference here, as each allocation from the underlying
+ * allocator is a costly `cudaMallocHost` call.
+ */
+class DLL_PUBLIC PooledPinnedCPUAllocator : public PooledCPUAllocator {
+ public:
+  explicit PooledPinnedCPUAllocator(const OpSpec &spec);
+  ~PooledPinnedCPUAllocator() override = default;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_DATA_POOLED_ALLOCATOR_H_
@@ -0,0 +1,136 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "dali/pipeline/data/pooled_allocator.h"
+
+namespace dali {
+
+TEST(PooledCPUAllocator, SizeClasses) {
+  PooledCPUAllocator alloc(OpSpec("PooledCPUAllocator"));
+  EXPECT_EQ(alloc.BlockSize(1), 4096u);
+  EXPECT_EQ(alloc.BlockSize(4096), 4096u);
+  EXPECT_EQ(alloc.BlockSize(4097), 5120u);
+  EXPECT_EQ(alloc.BlockSize(8192), 8192u);
+  EXPECT_EQ(alloc.BlockSize(8193), 10240u);
+  EXPECT_EQ(alloc.BlockSize(1000000), 1048576u);
+  // no more than 25% overhead above the minimum block size
+  for (size_t bytes = 4096; bytes < (64 << 20); bytes = bytes * 9 / 8 + 1) {
+    EXPECT_GE(alloc.BlockSize(bytes), bytes);
+    EXPECT_LE(alloc.BlockSize(bytes), bytes * 5 / 4);
+  }
+  // not cached - the size is not rounded
+  EXPECT_EQ(alloc.BlockSize((64 << 20) + 1), (64u << 20) + 1);
+}
+
+TEST(PooledCPUAllocator, ReuseAndStats) {
+  PooledCPUAllocator alloc(OpSpec("PooledCPUAllocator"));
+  void *p1 = nullptr, *p2 = nullptr;
+  alloc.New(&p1, 100000);
+  ASSERT_NE(p1, nullptr);
+  auto stats = alloc.GetStats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.hits, 0);
+  EXPECT_EQ(stats.bytes_cached, 0);
+  EXPECT_EQ(stats.bytes_allocated, static_cast<int64_t>(alloc.BlockSize(100000)));
+
+  alloc.Delete(p1, 100000);
+  EXPECT_EQ(alloc.GetStats().bytes_cached, static_cast<int64_t>(alloc.BlockSize(100000)));
+
+  // a different size within the same class reuses the block
+  alloc.New(&p2, 99000);
+  EXPECT_EQ(p2, p1);
+  stats = alloc.GetStats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.bytes_cached, 0);
+  alloc.Delete(p2, 99000);
+
+  // large blocks go through the shared depot
+  alloc.New(&p1, 10 << 20);
+  alloc.Delete(p1, 10 << 20);
+  alloc.New(&p2, 10 << 20);
+  EXPECT_EQ(p2, p1);
+  alloc.Delete(p2, 10 << 20);
+
+  alloc.ReleaseCached();
+  stats = alloc.GetStats();
+  EXPECT_EQ(stats.bytes_cached, 0);
+  EXPECT_EQ(stats.bytes_allocated, 0);
+
+  alloc.ResetStats();
+  EXPECT_EQ(alloc.GetStats().hits, 0);
+  EXPECT_EQ(alloc.GetStats().misses, 0);
+}
+
+TEST(PooledCPUAllocator, CacheLimits) {
+  PooledCPUAllocator alloc(OpSpec("PooledCPUAllocator")
+                           .AddArg("max_cached_bytes", 1 << 20)
+                           .AddArg("max_block_size", 1 << 20));
+  void *p = nullptr;
+  // too large to be cached
+  alloc.New(&p, 2 << 20);
+  alloc.Delete(p, 2 << 20);
+  EXPECT_EQ(alloc.GetStats().bytes_cached, 0);
+  EXPECT_EQ(alloc.GetStats().bytes_allocated, 0);
+
+  std::vector<void *> blocks(3);
+  for (auto &b : blocks)
+    alloc.New(&b, 512 << 10);
+  for (auto b : blocks)
+    alloc.Delete(b, 512 << 10);
+  auto stats = alloc.GetStats();
+  EXPECT_EQ(stats.bytes_cached, 1 << 20);
+  EXPECT_EQ(stats.bytes_allocated, 1 << 20);
+}
+
+TEST(PooledCPUAllocator, CrossThread) {
+  PooledCPUAllocator alloc(OpSpec("PooledCPUAllocator"));
+  const size_t size = 200000;
+  void *p = nullptr;
+  alloc.New(&p, size);
+  // freed in a thread which then exits - the block is handed over to the shared depot
+  std::thread t([&]() {
+    alloc.Delete(p, size);
+  });
+  t.join();
+  void *q = nullptr;
+  alloc.New(&q, size);
+  EXPECT_EQ(q, p);
+  EXPECT_EQ(alloc.GetStats().hits, 1);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (int iter = 0; iter < 1000; iter++) {
+        void *ptr = nullptr;
+        size_t bytes = 1000 + (iter * 7919) % 300000;
+        alloc.New(&ptr, bytes);
+        static_cast<char *>(ptr)[bytes - 1] = 1;
+        alloc.Delete(ptr, bytes);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  alloc.Delete(q, size);
+  auto stats = alloc.GetStats();
+  EXPECT_EQ(stats.hits + stats.misses, 4002);
+  EXPECT_EQ(stats.bytes_cached, stats.bytes_allocated);
+}
+
+}  // namespace dali
@@ -187,27 +187,16 @@ class DLL_PUBLIC TensorList : public Buffer<Backend> {
   }
 
   /**
-   * @brief Wraps the raw allocation. The input pointer must not be nullptr.
-   * if the size of the allocation is zero, the TensorList is reset to
-   * a default state and is NOT marked as sharing data.
-   *
-   * After wrapping the allocation, the TensorLists size is set to 0,
-   * and its type is reset to NoType.
-   * After calling this function any following call to `set_type` and `Resize`
-   * must match the total size of underlying allocation (`num_bytes_`) of
-   * shared data or the call will fail.
-   * Size can be set to 0 and type to NoType as intermediate step.
+   * @brief Wraps the allocation pointed to by `ptr`, see `ShareData(void *, size_t)`.
    *
-   * The TensorList object assumes no ownership of the input allocation,
-   * and will not de-allocate it when it is done using it. It is up to
-   * the user to manage the lifetime of the allocation such that it
-   * persist while it is in use by the Tensor.
+   * Unlike with a raw pointer, the TensorList keeps a reference to the allocation,
+   * as does every Tensor or TensorList that shares data with this one.
    */
-  DLL_PUBLIC inline void ShareData(void *ptr, size_t bytes) {
+  DLL_PUBLIC inline void ShareData(const shared_ptr<void> &ptr, size_t bytes) {
     DALI_ENFORCE(ptr != nullptr, "Input pointer must not be nullptr.");
 
     // Save our new pointer and bytes. Reset our type, shape, and size
-    data_.reset(ptr, [](void *) {});
+    data_ = ptr;
     num_bytes_ = bytes;
     type_ = TypeInfo::Create<NoType>();
     shape_ = kernels::TensorListShape<>();
@@ -223,6 +212,27 @@ class DLL_PUBLIC TensorList : public Buffer<Backend> {
     shares_data_ = num_bytes_ > 0 ? true : false;
   }
 
+  /**
+   * @brief Wraps the raw allocation. The input pointer must not be nullptr.
+   * if the size of the allocation is zero, the TensorList is reset to
+   * a default state and is NOT marked as sharing data.
+   *
+   * After wrapping the allocation, the TensorLists size is set to 0,
+   * and its type is reset to NoType.
+   * After calling this function any following call to `set_type` and `Resize`
+   * must match the total size of underlying allocation (`num_bytes_`) of
+   * shared data or the call will fail.
+   * Size can be set to 0 and type to NoType as intermediate step.
+   *
+   * The TensorList object assumes no ownership of the input allocation,
+   * and will not de-allocate it when it is done using it. It is up to
+   * the user to manage the lifetime of the allocation such that it
+   * persist while it is in use by the Tensor.
+   */
+  DLL_PUBLIC inline void ShareData(void *ptr, size_t bytes) {
+    ShareData(shared_ptr<void>(ptr, [](void *) {}), bytes);
+  }
+
   DLL_PUBLIC void Reset() {
     reset();  // free the underlying buffer
     shape_ = {};
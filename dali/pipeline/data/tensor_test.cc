@@ -582,4 +582,53 @@ TYPED_TEST(TensorTest, TestSubspaceTensor) {
   }
 }
 
+TYPED_TEST(TensorTest, TestGrowthPolicy) {
+  Tensor<TypeParam> t;
+  BufferGrowthPolicy policy;
+  policy.growth_factor = 2.0;
+  policy.min_reservation = 4096;
+  t.set_growth_policy(policy);
+  t.template mutable_data<uint8_t>();
+
+  t.Resize({100});
+  EXPECT_GE(t.capacity(), 4096u);
+  EXPECT_EQ(t.num_reallocs(), 0u);
+
+  t.Resize({6000});
+  size_t capacity = t.capacity();
+  EXPECT_GE(capacity, 8192u);
+  EXPECT_EQ(t.num_reallocs(), 1u);
+
+  // slowly increasing size does not reallocate each time
+  for (int size = 6001; size < 8192; size += 100)
+    t.Resize({size});
+  EXPECT_EQ(t.capacity(), capacity);
+  EXPECT_EQ(t.num_reallocs(), 1u);
+}
+
+TYPED_TEST(TensorTest, TestShrinkPolicy) {
+  Tensor<TypeParam> t;
+  BufferGrowthPolicy policy;
+  policy.shrink_threshold = 0.25;
+  policy.shrink_after = 3;
+  t.set_growth_policy(policy);
+  t.template mutable_data<uint8_t>();
+
+  t.Resize({1 << 20});
+  size_t big = t.capacity();
+
+  // above the threshold - no shrinking
+  for (int i = 0; i < 5; i++)
+    t.Resize({1 << 19});
+  EXPECT_EQ(t.capacity(), big);
+
+  t.Resize({1000});
+  t.Resize({1000});
+  EXPECT_EQ(t.capacity(), big);
+  t.Resize({1000});
+  EXPECT_LT(t.capacity(), big);
+  EXPECT_GE(t.capacity(), 1000u);
+  EXPECT_EQ(t.num_reallocs(), 1u);
+}
+
 }  // namespace dali
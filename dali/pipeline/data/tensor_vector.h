@@ -168,6 +168,23 @@ class TensorVector {
     return pinned_;
   }
 
+  inline void set_growth_policy(const BufferGrowthPolicy &policy) {
+    growth_policy_ = policy;
+    tl_->set_growth_policy(policy);
+    for (auto &t : tensors_) {
+      t->set_growth_policy(policy);
+    }
+  }
+
+  /// @brief Total number of reallocations of the underlying buffers
+  inline size_t num_reallocs() const {
+    size_t n = tl_->num_reallocs();
+    for (auto &t : tensors_) {
+      n += t->num_reallocs();
+    }
+    return n;
+  }
+
   /// @brief Reserve as contiguous tensor list internally
   inline void reserve(size_t total_bytes) {
     state_ = State::contiguous;
@@ -215,6 +232,7 @@ class TensorVector {
     for (auto &t : tensors_) {
       t = std::make_shared<Tensor<Backend>>();
       t->set_pinned(pinned_);
+      t->set_growth_policy(growth_policy_);
       if (IsValidType(type_)) {
         t->set_type(type_);
       }
@@ -244,6 +262,7 @@ class TensorVector {
   // pinned status and type info should be uniform
   bool pinned_ = true;
   TypeInfo type_ = TypeInfo();
+  BufferGrowthPolicy growth_policy_;
 };
 
 }  // namespace dali
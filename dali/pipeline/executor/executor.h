@@ -15,6 +15,7 @@
 #ifndef DALI_PIPELINE_EXECUTOR_EXECUTOR_H_
 #define DALI_PIPELINE_EXECUTOR_EXECUTOR_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <queue>
@@ -24,6 +25,7 @@
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
+#include "dali/pipeline/executor/executor_stats.h"
 #include "dali/pipeline/executor/queue_metadata.h"
 #include "dali/pipeline/executor/queue_policy.h"
 #include "dali/pipeline/executor/workspace_policy.h"
@@ -48,6 +50,37 @@ namespace detail {
 // pipeline run is finished
 static void gpu_finished_callback(cudaStream_t stream, cudaError_t status, void *userData);
 
+template <typename Backend>
+int64_t DataBytes(const Tensor<Backend> &t) {
+  return t.nbytes();
+}
+
+template <typename Backend>
+int64_t DataBytes(const TensorList<Backend> &tl) {
+  return tl.nbytes();
+}
+
+template <typename Backend>
+int64_t DataBytes(const TensorVector<Backend> &tv) {
+  int64_t bytes = 0;
+  for (size_t i = 0; i < tv.size(); i++)
+    bytes += tv[i].nbytes();
+  return bytes;
+}
+
+// Total size of the outputs of an operator
+template <typename Workspace>
+int64_t OutputBytes(const Workspace &ws) {
+  int64_t bytes = 0;
+  for (int i = 0; i < ws.NumOutput(); i++) {
+    if (ws.template OutputIsType<CPUBackend>(i))
+      bytes += DataBytes(ws.template OutputRef<CPUBackend>(i));
+    else
+      bytes += DataBytes(ws.template OutputRef<GPUBackend>(i));
+  }
+  return bytes;
+}
+
 }  // namespace detail
 
 class DLL_PUBLIC ExecutorBase {
@@ -63,6 +96,12 @@ class DLL_PUBLIC ExecutorBase {
   DLL_PUBLIC virtual void ShareOutputs(DeviceWorkspace *ws) = 0;
   DLL_PUBLIC virtual void ReleaseOutputs() = 0;
   DLL_PUBLIC virtual void SetCompletionCallback(ExecutorCallback cb) = 0;
+  DLL_PUBLIC virtual void SetDepthFirstCPU(bool enabled) = 0;
+  DLL_PUBLIC virtual OperatorTimings GetOperatorTimings() const = 0;
+  DLL_PUBLIC virtual ExecutorStats GetStats() const = 0;
+  DLL_PUBLIC virtual void ResetStats() = 0;
+  DLL_PUBLIC virtual void SetBufferGrowthPolicy(const BufferGrowthPolicy &policy) = 0;
+  DLL_PUBLIC virtual size_t GetReallocationCount() const = 0;
 
  protected:
   // virtual to allow the TestPruneWholeGraph test in gcc
@@ -110,6 +149,51 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   DLL_PUBLIC void ReleaseOutputs() override;
   DLL_PUBLIC void SetCompletionCallback(ExecutorCallback cb) override;
 
+  /**
+   * @brief Enables depth-first execution of the CPU stage.
+   *
+   * Consecutive CPU operators that can run per sample are grouped into chains. Each sample
+   * is pushed through a whole chain by a single thread pool task and the stage waits
+   * for the pool only once per chain, instead of once per operator.
+   */
+  DLL_PUBLIC void SetDepthFirstCPU(bool enabled) override {
+    depth_first_cpu_ = enabled;
+  }
+
+  /**
+   * @brief Returns the batch makespan and output size of every operator run on a whole batch.
+   * Chains run depth-first are reported under the names of their ops joined with '+'.
+   */
+  DLL_PUBLIC OperatorTimings GetOperatorTimings() const override {
+    return op_timings_.Get();
+  }
+
+  /**
+   * @brief Returns the timings of all the operators, as in GetOperatorTimings(),
+   * and the waiting times and queue occupancy of the stages.
+   */
+  DLL_PUBLIC ExecutorStats GetStats() const override {
+    return op_timings_.GetStats();
+  }
+
+  DLL_PUBLIC void ResetStats() override {
+    op_timings_.Reset();
+  }
+
+  /**
+   * @brief Sets the growth policy of all output buffers. Must be called before Build.
+   */
+  DLL_PUBLIC void SetBufferGrowthPolicy(const BufferGrowthPolicy &policy) override {
+    DALI_ENFORCE(graph_ == nullptr, "Buffer growth policy must be set before Build()");
+    buffer_growth_policy_ = policy;
+  }
+
+  /**
+   * @brief Returns the total number of times the output buffers were reallocated
+   * (after their first allocation), as of the last finished run of each stage.
+   */
+  DLL_PUBLIC size_t GetReallocationCount() const override;
+
   DLL_PUBLIC void ShutdownQueue() {
     QueuePolicy::SignalStop();
   }
@@ -138,8 +222,40 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   void PresizeData(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
                    const OpGraph &graph);
 
+  void SetGrowthPolicy(std::vector<tensor_data_store_queue_t> &tensor_to_store_queue,
+                       const OpGraph &graph);
+
+  void RecordReallocations(OpType stage, QueueIdxs idxs);
+
   void SetupOutputQueuesForGraph();
 
+  void RunCPUBreadthFirst(QueueIdxs cpu_idxs);
+
+  void RunCPUDepthFirst(QueueIdxs cpu_idxs);
+
+  void RunCPUChain(const std::vector<OpNode *> &chain, QueueIdxs cpu_idxs);
+
+  /**
+   * @brief Acquires the queue indices for a stage, recording the wait and the queue occupancy
+   */
+  QueueIdxs AcquireStageIdxs(OpType stage) {
+    int ready = QueuePolicy::ReadyCount(stage);
+    auto start = OperatorTimingCollector::clock::now();
+    DALI_TRACE_SCOPE("[Executor] Wait for " + to_string(stage) + " stage");
+    auto idxs = QueuePolicy::AcquireIdxs(stage);
+    op_timings_.RecordStage(to_string(stage), ready, start, OperatorTimingCollector::clock::now());
+    return idxs;
+  }
+
+  template <typename Workspace>
+  void RunOp(OpNode &op_node, Workspace &ws) {
+    OperatorBase &op = *op_node.op;
+    auto start = OperatorTimingCollector::clock::now();
+    op.Run(&ws);
+    op_timings_.Record(op_node.instance_name, start, OperatorTimingCollector::clock::now(),
+                       detail::OutputBytes(ws), op.LastRunWaitTime());
+  }
+
   class EventList {
    public:
     inline EventList() {}
@@ -198,8 +314,15 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   std::vector<std::string> errors_;
   std::mutex errors_mutex_;
   bool exec_error_;
+  bool depth_first_cpu_ = false;
+  OperatorTimingCollector op_timings_;
+  BufferGrowthPolicy buffer_growth_policy_;
   QueueSizes queue_sizes_;
   std::vector<tensor_data_store_queue_t> tensor_to_store_queue_;
+  // TensorNodeId -> index in the store queue -> reallocations of that buffer.
+  // Updated by the stage that produces the tensor at the end of its run, so that
+  // GetReallocationCount doesn't touch the buffers while they are being resized.
+  std::vector<std::vector<std::atomic<size_t>>> realloc_counts_;
   cudaStream_t mixed_op_stream_, gpu_op_stream_;
   // MixedOpId -> queue_idx -> cudaEvent_t
   // To introduce dependency from MIXED to GPU Ops
@@ -260,6 +383,12 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
 
   PrepinData(tensor_to_store_queue_, *graph_);
 
+  SetGrowthPolicy(tensor_to_store_queue_, *graph_);
+  realloc_counts_.clear();
+  for (int queue_size : queue_sizes) {
+    realloc_counts_.emplace_back(queue_size);
+  }
+
   // Presize the workspaces based on the hint
   PresizeData(tensor_to_store_queue_, *graph_);
 
@@ -281,7 +410,7 @@ template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::RunCPU() {
   TimeRange tr("[Executor] RunCPU");
 
-  auto support_idxs = QueuePolicy::AcquireIdxs(OpType::SUPPORT);
+  auto support_idxs = AcquireStageIdxs(OpType::SUPPORT);
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(support_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::SUPPORT, support_idxs);
     return;
@@ -293,13 +422,12 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPU() {
   try {
     for (int i = 0; i < graph_->NumOp(OpType::SUPPORT); ++i) {
       OpNode &op_node = graph_->Node(OpType::SUPPORT, i);
-      OperatorBase &op = *op_node.op;
       // SupportWorkspace &ws = GetWorkspace<OpType::SUPPORT>(queue_idx, i);
       typename WorkspacePolicy::template ws_t<OpType::SUPPORT> ws =
           WorkspacePolicy::template GetWorkspace<OpType::SUPPORT>(support_idxs, *graph_, i);
       TimeRange tr("[Executor] Run Support op " + op_node.instance_name,
           TimeRange::kCyan);
-      op.Run(&ws);
+      RunOp(op_node, ws);
     }
   } catch (std::exception &e) {
     HandleError(e.what());
@@ -307,14 +435,28 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPU() {
     HandleError();
   }
 
+  RecordReallocations(OpType::SUPPORT, support_idxs);
   QueuePolicy::ReleaseIdxs(OpType::SUPPORT, support_idxs);
 
-  auto cpu_idxs = QueuePolicy::AcquireIdxs(OpType::CPU);
+  auto cpu_idxs = AcquireStageIdxs(OpType::CPU);
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(cpu_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
     return;
   }
 
+  if (depth_first_cpu_) {
+    RunCPUDepthFirst(cpu_idxs);
+  } else {
+    RunCPUBreadthFirst(cpu_idxs);
+  }
+
+  RecordReallocations(OpType::CPU, cpu_idxs);
+  // Pass the work to the mixed stage
+  QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunCPUBreadthFirst(QueueIdxs cpu_idxs) {
   // Run the cpu-ops in the thread
   // Process each CPU Op in batch
   for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU); ++cpu_op_id) {
@@ -322,19 +464,85 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPU() {
     typename WorkspacePolicy::template ws_t<OpType::CPU> ws =
         WorkspacePolicy::template GetWorkspace<OpType::CPU>(cpu_idxs, *graph_, cpu_op_id);
     TimeRange tr("[Executor] Run CPU op " + op_node->instance_name, TimeRange::kBlue1);
-    OperatorBase &op = *op_node->op;
 
     try {
-      op.Run(&ws);
+      RunOp(*op_node, ws);
     } catch (std::exception &e) {
       HandleError(e.what());
     } catch (...) {
       HandleError();
     }
   }
+}
 
-  // Pass the work to the mixed stage
-  QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunCPUDepthFirst(QueueIdxs cpu_idxs) {
+  // Gather consecutive per-sample operators into chains. Operators that need the whole
+  // batch (e.g. readers) end the current chain and are run on their own.
+  std::vector<OpNode *> chain;
+  for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU); ++cpu_op_id) {
+    OpNode *op_node = &graph_->Node(OpType::CPU, cpu_op_id);
+    if (op_node->op->CanRunPerSample()) {
+      chain.push_back(op_node);
+      continue;
+    }
+    RunCPUChain(chain, cpu_idxs);
+    chain.clear();
+
+    typename WorkspacePolicy::template ws_t<OpType::CPU> ws =
+        WorkspacePolicy::template GetWorkspace<OpType::CPU>(cpu_idxs, *graph_, cpu_op_id);
+    TimeRange tr("[Executor] Run CPU op " + op_node->instance_name, TimeRange::kBlue1);
+    try {
+      RunOp(*op_node, ws);
+    } catch (std::exception &e) {
+      HandleError(e.what());
+    } catch (...) {
+      HandleError();
+    }
+  }
+  RunCPUChain(chain, cpu_idxs);
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunCPUChain(const std::vector<OpNode *> &chain,
+                                                         QueueIdxs cpu_idxs) {
+  if (chain.empty())
+    return;
+  TimeRange tr("[Executor] Run CPU chain of " + std::to_string(chain.size()) + " ops",
+               TimeRange::kBlue1);
+
+  std::vector<HostWorkspace> workspaces;
+  workspaces.reserve(chain.size());
+  std::string chain_name;
+  for (OpNode *op_node : chain) {
+    workspaces.push_back(WorkspacePolicy::template GetWorkspace<OpType::CPU>(
+        cpu_idxs, *graph_, op_node->partition_index));
+    chain_name += (chain_name.empty() ? "" : "+") + op_node->instance_name;
+  }
+
+  try {
+    auto start = OperatorTimingCollector::clock::now();
+    // The cost of a sample is estimated by the head of the chain
+    std::vector<int64_t> costs(batch_size_);
+    for (int data_idx = 0; data_idx < batch_size_; ++data_idx) {
+      costs[data_idx] = chain[0]->op->EstimateSampleCost(&workspaces[0], data_idx);
+    }
+    thread_pool_.DoWorkLargestFirst(costs, [&chain, &workspaces](int64_t data_idx, int tid) {
+      DALI_TRACE_SCOPE("[Executor] CPU chain sample " + std::to_string(data_idx));
+      for (size_t i = 0; i < chain.size(); ++i) {
+        chain[i]->op->RunSample(&workspaces[i], data_idx, tid);
+      }
+    });
+    thread_pool_.WaitForWork();
+    int64_t bytes = 0;
+    for (auto &ws : workspaces)
+      bytes += detail::OutputBytes(ws);
+    op_timings_.Record(chain_name, start, OperatorTimingCollector::clock::now(), bytes);
+  } catch (std::exception &e) {
+    HandleError(e.what());
+  } catch (...) {
+    HandleError();
+  }
 }
 
 template <typename WorkspacePolicy, typename QueuePolicy>
@@ -342,7 +550,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixed() {
   TimeRange tr("[Executor] RunMixed");
   DeviceGuard g(device_id_);
 
-  auto mixed_idxs = QueuePolicy::AcquireIdxs(OpType::MIXED);
+  auto mixed_idxs = AcquireStageIdxs(OpType::MIXED);
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(mixed_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::MIXED, mixed_idxs);
     return;
@@ -351,12 +559,11 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixed() {
   try {
     for (int i = 0; i < graph_->NumOp(OpType::MIXED); ++i) {
       OpNode &op_node = graph_->Node(OpType::MIXED, i);
-      OperatorBase &op = *op_node.op;
       typename WorkspacePolicy::template ws_t<OpType::MIXED> ws =
           WorkspacePolicy::template GetWorkspace<OpType::MIXED>(mixed_idxs, *graph_, i);
       TimeRange tr("[Executor] Run Mixed op " + op_node.instance_name,
           TimeRange::kOrange);
-      op.Run(&ws);
+      RunOp(op_node, ws);
       if (ws.has_stream() && ws.has_event()) {
         CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
       }
@@ -367,6 +574,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixed() {
     HandleError();
   }
 
+  RecordReallocations(OpType::MIXED, mixed_idxs);
+
   if (callback_) {
     // Record event that will allow to call the callback after whole run of this pipeline is
     // finished.
@@ -380,7 +589,7 @@ template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::RunGPU() {
   TimeRange tr("[Executor] RunGPU");
 
-  auto gpu_idxs = QueuePolicy::AcquireIdxs(OpType::GPU);
+  auto gpu_idxs = AcquireStageIdxs(OpType::GPU);
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(gpu_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::GPU, gpu_idxs);
     return;
@@ -400,7 +609,6 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPU() {
   try {
     for (int i = 0; i < graph_->NumOp(OpType::GPU); ++i) {
       OpNode &op_node = graph_->Node(OpType::GPU, i);
-      OperatorBase &op = *op_node.op;
       typename WorkspacePolicy::template ws_t<OpType::GPU> ws =
           WorkspacePolicy::template GetWorkspace<OpType::GPU>(gpu_idxs, *graph_, i);
       auto parent_events = ws.ParentEvents();
@@ -411,7 +619,7 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPU() {
 
       TimeRange tr("[Executor] Run GPU op " + op_node.instance_name,
           TimeRange::knvGreen);
-      op.Run(&ws);
+      RunOp(op_node, ws);
       if (ws.has_event()) {
         CUDA_CALL(cudaEventRecord(ws.event(), ws.stream()));
       }
@@ -455,6 +663,8 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunGPU() {
                                     static_cast<void *>(&callback_), 0));
   }
 
+  RecordReallocations(OpType::GPU, gpu_idxs);
+
   // We do not release, but handle to used outputs
   QueuePolicy::QueueOutputIdxs(gpu_idxs, gpu_op_stream_);
 
@@ -487,7 +697,14 @@ void Executor<WorkspacePolicy, QueuePolicy>::ShareOutputs(DeviceWorkspace *ws) {
     throw std::runtime_error(error);
   }
 
+  int ready = QueuePolicy::ReadyOutputCount();
+  auto start = OperatorTimingCollector::clock::now();
+  tracing::TraceScope output_wait;
+  if (tracing::Enabled())
+    output_wait.Begin("[Executor] Wait for outputs");
   auto output_idx = QueuePolicy::UseOutputIdxs();
+  output_wait.End();
+  op_timings_.RecordStage("outputs", ready, start, OperatorTimingCollector::clock::now());
 
   if (exec_error_ || QueuePolicy::IsStopSignaled()) {
     std::lock_guard<std::mutex> errors_lock(errors_mutex_);
@@ -676,6 +893,67 @@ void Executor<WorkspacePolicy, QueuePolicy>::PresizeData(
   }
 }
 
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetGrowthPolicy(
+    std::vector<tensor_data_store_queue_t> &tensor_to_store_queue, const OpGraph &graph) {
+  for (int i = 0; i < graph.NumTensor(); i++) {
+    auto &tensor = graph.Tensor(i);
+    auto op_type = graph.Node(tensor.producer.node).op_type;
+    VALUE_SWITCH(op_type, op_type_static,
+        (OpType::SUPPORT, OpType::CPU, OpType::MIXED, OpType::GPU),
+    (
+      if (tensor.producer.storage_device == StorageDevice::CPU) {
+        for (auto storage : get_queue<op_type_static, StorageDevice::CPU>(
+                                tensor_to_store_queue[tensor.id])) {
+          storage->set_growth_policy(buffer_growth_policy_);
+        }
+      } else {
+        for (auto storage : get_queue<op_type_static, StorageDevice::GPU>(
+                                tensor_to_store_queue[tensor.id])) {
+          storage->set_growth_policy(buffer_growth_policy_);
+        }
+      }
+    ), DALI_FAIL("Invalid op type"));  // NOLINT(whitespace/parens)
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RecordReallocations(OpType stage, QueueIdxs idxs) {
+  for (int i = 0; i < graph_->NumTensor(); i++) {
+    auto &tensor = graph_->Tensor(i);
+    if (graph_->Node(tensor.producer.node).op_type != stage)
+      continue;
+    auto &counts = realloc_counts_[tensor.id];
+    // Unbuffered queues hold a single element, used by every iteration
+    int queue_idx = counts.size() > 1 ? idxs[stage] : 0;
+    VALUE_SWITCH(stage, op_type_static,
+        (OpType::SUPPORT, OpType::CPU, OpType::MIXED, OpType::GPU),
+    (
+      if (tensor.producer.storage_device == StorageDevice::CPU) {
+        auto &queue = get_queue<op_type_static, StorageDevice::CPU>(
+            tensor_to_store_queue_[tensor.id]);
+        counts[queue_idx].store(queue[queue_idx]->num_reallocs(), std::memory_order_relaxed);
+      } else {
+        auto &queue = get_queue<op_type_static, StorageDevice::GPU>(
+            tensor_to_store_queue_[tensor.id]);
+        counts[queue_idx].store(queue[queue_idx]->num_reallocs(), std::memory_order_relaxed);
+      }
+    ), DALI_FAIL("Invalid op type"));  // NOLINT(whitespace/parens)
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+size_t Executor<WorkspacePolicy, QueuePolicy>::GetReallocationCount() const {
+  DALI_ENFORCE(graph_ != nullptr, "The executor must be built to count reallocations");
+  size_t count = 0;
+  for (auto &tensor_counts : realloc_counts_) {
+    for (auto &c : tensor_counts) {
+      count += c.load(std::memory_order_relaxed);
+    }
+  }
+  return count;
+}
+
 template <typename WorkspacePolicy, typename QueuePolicy>
 std::vector<int> Executor<WorkspacePolicy, QueuePolicy>::GetMemoryHints(const OpNode &node) {
   std::vector<int> hints;
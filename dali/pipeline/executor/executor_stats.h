@@ -0,0 +1,142 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_EXECUTOR_STATS_H_
+#define DALI_PIPELINE_EXECUTOR_EXECUTOR_STATS_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "dali/core/common.h"
+
+namespace dali {
+
+/**
+ * @brief Wall time spent by an operator on whole batches, i.e. the batch makespan,
+ * and the size of the data it produced
+ *
+ * For mixed and GPU operators the time is the time of issuing the work.
+ */
+struct OperatorTiming {
+  int64_t run_count = 0;
+  double total_ms = 0;
+  double max_ms = 0;
+  double last_ms = 0;
+  /// Total size of the outputs, after each run
+  int64_t bytes_produced = 0;
+  /// Part of total_ms spent waiting for data prepared outside of the graph,
+  /// e.g. readers waiting for the prefetching thread
+  double wait_ms = 0;
+
+  void Add(double ms, int64_t bytes = 0, double wait = 0) {
+    run_count++;
+    total_ms += ms;
+    max_ms = std::max(max_ms, ms);
+    last_ms = ms;
+    bytes_produced += bytes;
+    wait_ms += wait;
+  }
+};
+
+// Instance name -> timing
+using OperatorTimings = std::map<std::string, OperatorTiming>;
+
+/**
+ * @brief Time spent by a pipeline stage waiting for a batch to work on,
+ * and the occupancy of its queue
+ *
+ * The occupancy is the number of batches ready for the stage when it asks for one:
+ * a stage that always finds its queue empty waits for the previous stage, while
+ * a full queue means that the stage itself is the bottleneck.
+ * For the first stage, the ready batches are the free buffers.
+ */
+struct StageStats {
+  int64_t acquire_count = 0;
+  double total_wait_ms = 0;
+  double max_wait_ms = 0;
+  int64_t total_ready = 0;
+  int max_ready = 0;
+
+  double mean_ready() const {
+    return acquire_count ? static_cast<double>(total_ready) / acquire_count : 0;
+  }
+
+  void Add(double wait_ms, int ready) {
+    acquire_count++;
+    total_wait_ms += wait_ms;
+    max_wait_ms = std::max(max_wait_ms, wait_ms);
+    total_ready += ready;
+    max_ready = std::max(max_ready, ready);
+  }
+};
+
+// Stage name ("support", "cpu", "mixed", "gpu" or "outputs") -> stats
+using StageStatsMap = std::map<std::string, StageStats>;
+
+/**
+ * @brief Statistics of all the operators and stages of an executor
+ */
+struct ExecutorStats {
+  OperatorTimings operators;
+  StageStatsMap stages;
+};
+
+/**
+ * @brief Thread-safe collection of ExecutorStats
+ */
+class OperatorTimingCollector {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  void Record(const std::string &name, clock::time_point start, clock::time_point end,
+              int64_t bytes = 0, double wait_ms = 0) {
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.operators[name].Add(ms, bytes, wait_ms);
+  }
+
+  void RecordStage(const std::string &stage, int ready,
+                   clock::time_point start, clock::time_point end) {
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.stages[stage].Add(ms, ready);
+  }
+
+  OperatorTimings Get() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.operators;
+  }
+
+  ExecutorStats GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = {};
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  ExecutorStats stats_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_EXECUTOR_STATS_H_
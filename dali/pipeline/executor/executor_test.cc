@@ -496,6 +496,71 @@ TYPED_TEST(ExecutorTest, TestRunBasicGraphWithCB) {
   ASSERT_TRUE(ws.OutputIsType<CPUBackend>(0));
 }
 
+TYPED_TEST(ExecutorTest, TestRunDepthFirstCPU) {
+  TensorList<CPUBackend> tl;
+  this->MakeJPEGBatch(&tl, this->batch_size_);
+
+  // Runs decoder -> resize chain in the given CPU execution mode and returns the output
+  auto run = [&](bool depth_first, TensorList<CPUBackend> *out) {
+    auto exe = this->GetExecutor(this->batch_size_, this->num_threads_, 0, 1);
+    exe->SetDepthFirstCPU(depth_first);
+    exe->Init();
+
+    OpGraph graph;
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("ExternalSource")
+            .AddArg("device", "cpu")
+            .AddOutput("data", "cpu")), "");
+
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("ImageDecoder")
+            .AddArg("device", "cpu")
+            .AddInput("data", "cpu")
+            .AddOutput("images", "cpu")), "");
+
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("Resize")
+            .AddArg("device", "cpu")
+            .AddArg("resize_x", 64.f)
+            .AddArg("resize_y", 48.f)
+            .AddInput("images", "cpu")
+            .AddOutput("resized", "cpu")), "");
+
+    graph.AddOp(this->PrepareSpec(
+            OpSpec("MakeContiguous")
+            .AddArg("device", "mixed")
+            .AddInput("resized", "cpu")
+            .AddOutput("final_images", "cpu")), "");
+
+    vector<string> outputs = {"final_images_cpu"};
+    exe->Build(&graph, outputs);
+
+    auto *src_op =
+        dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+    ASSERT_NE(src_op, nullptr);
+    src_op->SetDataSource(tl);
+
+    exe->RunCPU();
+    exe->RunMixed();
+    exe->RunGPU();
+
+    DeviceWorkspace ws;
+    exe->Outputs(&ws);
+    ASSERT_EQ(ws.NumOutput(), 1);
+    ASSERT_TRUE(ws.OutputIsType<CPUBackend>(0));
+    out->Copy(ws.Output<CPUBackend>(0), 0);
+  };
+
+  TensorList<CPUBackend> breadth_first, depth_first;
+  run(false, &breadth_first);
+  run(true, &depth_first);
+
+  ASSERT_EQ(breadth_first.shape(), depth_first.shape());
+  ASSERT_EQ(breadth_first.nbytes(), depth_first.nbytes());
+  EXPECT_EQ(0, std::memcmp(breadth_first.raw_data(), depth_first.raw_data(),
+                           breadth_first.nbytes()));
+}
+
 // This test does not work with Async Executors
 TYPED_TEST(ExecutorSyncTest, TestPrefetchedExecution) {
   int batch_size = this->batch_size_ / 2;
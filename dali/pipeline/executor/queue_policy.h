@@ -48,6 +48,10 @@ namespace dali {
 //   void SignalStop();
 //   // Returns true if we signaled stop previously
 //   bool IsStopSignaled();
+//   // Number of batches that given stage can acquire without waiting (for statistics)
+//   int ReadyCount(OpType stage);
+//   // Number of outputs ready to be used (for statistics)
+//   int ReadyOutputCount();
 // };
 
 
@@ -177,6 +181,20 @@ struct UniformQueuePolicy {
     return ready_stop_;
   }
 
+  int ReadyCount(OpType stage) {
+    if (stage == OpType::SUPPORT) {
+      std::lock_guard<std::mutex> lock(free_mutex_);
+      return free_queue_.size();
+    }
+    std::lock_guard<std::mutex> lock(stage_work_mutex_[static_cast<int>(stage)]);
+    return stage_work_queue_[static_cast<int>(stage)].size();
+  }
+
+  int ReadyOutputCount() {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    return ready_queue_.size();
+  }
+
  private:
   std::queue<int> ready_queue_, free_queue_, in_use_queue_;
   std::mutex ready_mutex_, free_mutex_;
@@ -372,6 +390,22 @@ struct SeparateQueuePolicy {
     return ready_stop_;
   }
 
+  int ReadyCount(OpType stage) {
+    int current_stage = static_cast<int>(stage);
+    if (HasPreviousStage(stage)) {
+      int previous_stage = static_cast<int>(PreviousStage(stage));
+      std::lock_guard<std::mutex> lock(stage_ready_mutex_[previous_stage]);
+      return stage_ready_[previous_stage].size();
+    }
+    std::lock_guard<std::mutex> lock(stage_free_mutex_[current_stage]);
+    return stage_free_[current_stage].size();
+  }
+
+  int ReadyOutputCount() {
+    std::lock_guard<std::mutex> lock(ready_output_mutex_);
+    return ready_output_queue_.size();
+  }
+
  private:
   friend void detail::release_callback(cudaStream_t stream, cudaError_t status, void *userData);
 
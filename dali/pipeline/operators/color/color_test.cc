@@ -20,7 +20,7 @@ template <typename ImgType>
 class ColorTest : public GenericMatchingTest<ImgType> {
 };
 
-typedef ::testing::Types<RGB> Types;
+typedef ::testing::Types<RGB, Gray> Types;
 TYPED_TEST_SUITE(ColorTest, Types);
 
 TYPED_TEST(ColorTest, Brightness) {
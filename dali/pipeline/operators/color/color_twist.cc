@@ -14,6 +14,7 @@
 
 #include "dali/pipeline/operators/color/color_twist.h"
 #include "dali/image/transform.h"
+#include "dali/kernels/imgproc/color_twist_cpu.h"
 
 namespace dali {
 
@@ -129,7 +130,17 @@ void ColorTwistBase<CPUBackend>::RunImpl(SampleWorkspace *ws, const int idx) {
       (*augments_[j])(m);
     }
 
-    MakeColorTransformation(pImgInp, H, W, C, m, pImgOut);
+    kernels::ColorTwistParams params;
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < nDim; j++)
+        params.matrix[i][j] = matrix[i][j];
+
+    kernels::InTensorCPU<uint8_t, 3> in_view = { pImgInp, { H, W, C } };
+    kernels::OutTensorCPU<uint8_t, 3> out_view = { pImgOut, { H, W, C } };
+    kernels::ColorTwistCPU<uint8_t> kernel;
+    kernels::KernelContext ctx;
+    kernel.Setup(ctx, in_view, params);
+    kernel.Run(ctx, out_view, in_view, params);
   } else {
     memcpy(pImgOut, pImgInp, H * W * C);
   }
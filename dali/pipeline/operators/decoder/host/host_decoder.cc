@@ -36,6 +36,12 @@ void HostDecoder::RunImpl(SampleWorkspace *ws, const int idx) {
     img = ImageFactory::CreateImage(input.data<uint8>(), input.size(), output_type_);
     img->SetCropWindowGenerator(GetCropWindowGenerator(ws->data_idx()));
     img->SetUseFastIdct(use_fast_idct_);
+    img->SetMinDecodeSize(min_decode_size_);
+    // decode straight to the output tensor
+    img->SetOutputAllocator([&output](size_t h, size_t w, size_t c) {
+      output.Resize({static_cast<int>(h), static_cast<int>(w), static_cast<int>(c)});
+      return output.mutable_data<uint8_t>();
+    });
     img->Decode();
   } catch (std::exception &e) {
     DALI_FAIL(e.what() + "File: " + file_name);
@@ -48,7 +54,8 @@ void HostDecoder::RunImpl(SampleWorkspace *ws, const int idx) {
 
   output.Resize({static_cast<int>(h), static_cast<int>(w), static_cast<int>(c)});
   unsigned char *out_data = output.mutable_data<unsigned char>();
-  std::memcpy(out_data, decoded.get(), h * w * c);
+  if (decoded.get() != out_data)
+    std::memcpy(out_data, decoded.get(), h * w * c);
 }
 
 DALI_SCHEMA(HostDecoder)
@@ -28,8 +28,10 @@ class HostDecoder : public Operator<CPUBackend> {
       Operator<CPUBackend>(spec),
       output_type_(spec.GetArgument<DALIImageType>("output_type")),
       c_(IsColor(output_type_) ? 3 : 1),
-      use_fast_idct_(spec.GetArgument<bool>("use_fast_idct"))
-  {}
+      use_fast_idct_(spec.GetArgument<bool>("use_fast_idct")),
+      min_decode_size_(spec.GetArgument<int>("min_decode_size")) {
+    DALI_ENFORCE(min_decode_size_ >= 0, "`min_decode_size` must not be negative");
+  }
 
   inline ~HostDecoder() override = default;
   DISABLE_COPY_MOVE_ASSIGN(HostDecoder);
@@ -44,6 +46,7 @@ class HostDecoder : public Operator<CPUBackend> {
   DALIImageType output_type_;
   int c_;
   bool use_fast_idct_ = false;
+  int min_decode_size_ = 0;
 };
 
 }  // namespace dali
@@ -54,6 +54,14 @@ in runtime. Ignored when `split_stages` is false.)code",
 According to libjpeg-turbo documentation, decompression performance is improved by 4-14% with very little
 loss in quality.)code",
       false)
+  .AddOptionalArg("min_decode_size",
+      R"code(**`cpu` backend only** Allows JPEG images to be decoded at 1/2, 1/4 or 1/8 of their
+resolution, using libjpeg-turbo's scaled IDCT, as long as the shorter side of the decoded
+(and cropped) image is at least `min_decode_size` pixels. Intended for pipelines that resize
+the images down anyway - set it to the size of the shorter side after the resize.
+The crop window is chosen in the coordinates of the full image and scaled accordingly.
+0 disables the downscaling.)code",
+      0)
   .AddParent("CachedDecoderAttr");
 
 // Fused
@@ -0,0 +1,134 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/operators/fused/resize_crop_mirror_normalize.h"
+#include "dali/pipeline/data/views.h"
+
+namespace dali {
+
+DALI_SCHEMA(ResizeCropMirrorNormalize)
+  .DocStr(R"code(Perform a fused resize, crop, mirror and normalize operation.
+Produces the same result as `Resize` followed by `CropMirrorNormalize`, but only the pixels
+inside the crop window are resampled and the output is written directly as normalized
+floating point data in the requested layout.
+
+Normalization takes the resized image and produces output using formula:
+
+  output = (input - mean) / std
+)code")
+  .NumInput(1)
+  .NumOutput(1)
+  .AllowMultipleInputSets()
+  .AddOptionalArg("output_dtype",
+    R"code(Output data type. Supported types: `FLOAT` and `FLOAT16`.)code", DALI_FLOAT)
+  .AddOptionalArg("output_layout",
+    R"code(Output tensor data layout. Supported layouts: `NCHW` and `NHWC`.)code", DALI_NCHW)
+  .AddOptionalArg("mean",
+    R"code(Mean pixel values for image normalization.)code",
+    std::vector<float>{0.0f})
+  .AddOptionalArg("std",
+    R"code(Standard deviation values for image normalization.)code",
+    std::vector<float>{1.0f})
+  .AddParent("CropAttr")
+  .AddParent("ResizeCropMirrorAttr")
+  .AddParent("ResamplingFilterAttr")
+  .EnforceInputLayout(DALI_NHWC);
+
+DALI_REGISTER_OPERATOR(ResizeCropMirrorNormalize, ResizeCropMirrorNormalize, CPU);
+
+ResizeCropMirrorNormalize::ResizeCropMirrorNormalize(const OpSpec &spec)
+    : Operator<CPUBackend>(spec)
+    , ResizeCropMirrorAttr(spec)
+    , ResamplingFilterAttr(spec)
+    , output_type_(spec.GetArgument<DALIDataType>("output_dtype"))
+    , output_layout_(spec.GetArgument<DALITensorLayout>("output_layout")) {
+  DALI_ENFORCE(!IsWholeImage(), "ResizeCropMirrorNormalize requires the crop window size");
+  DALI_ENFORCE(output_type_ == DALI_FLOAT || output_type_ == DALI_FLOAT16,
+    "Unsupported output type: " + std::to_string(output_type_));
+  DALI_ENFORCE(output_layout_ == DALI_NCHW || output_layout_ == DALI_NHWC,
+    "Unsupported output layout: " + std::to_string(output_layout_));
+
+  if (!spec.TryGetRepeatedArgument(mean_vec_, "mean")) {
+    mean_vec_ = { spec.GetArgument<float>("mean") };
+  }
+
+  if (!spec.TryGetRepeatedArgument(inv_std_vec_, "std")) {
+    inv_std_vec_ = { spec.GetArgument<float>("std") };
+  }
+
+  // Inverse the std-deviation
+  for (auto &element : inv_std_vec_) {
+    element = 1.f / element;
+  }
+
+  kmgr_.Resize(num_threads_, num_threads_);
+  per_thread_args_.resize(num_threads_);
+}
+
+kernels::ResampleCropMirrorNormalizeArgs
+ResizeCropMirrorNormalize::GetKernelArgs(const TransformMeta &meta, int data_idx) const {
+  kernels::ResampleCropMirrorNormalizeArgs args;
+  args.resample[0].output_size = meta.rsz_h;
+  args.resample[1].output_size = meta.rsz_w;
+  args.resample[0].min_filter = args.resample[1].min_filter = min_filter_;
+  args.resample[0].mag_filter = args.resample[1].mag_filter = mag_filter_;
+  args.crop_anchor = {{ meta.crop.first, meta.crop.second }};
+  args.crop_shape = {{ crop_height_[data_idx], crop_width_[data_idx] }};
+  args.mirror = meta.mirror != 0;
+  args.planar = output_layout_ == DALI_NCHW;
+  args.mean = mean_vec_;
+  args.inv_stddev = inv_std_vec_;
+  return args;
+}
+
+void ResizeCropMirrorNormalize::SetupSharedSampleParams(SampleWorkspace *ws) {
+  CropAttr::ProcessArguments(ws);
+  const int thread_idx = ws->thread_idx();
+  per_thread_args_[thread_idx] = GetKernelArgs(GetTransfomMeta(ws, spec_), ws->data_idx());
+}
+
+template <typename OutputType>
+void ResizeCropMirrorNormalize::RunKernel(Tensor<CPUBackend> &output,
+                                          const Tensor<CPUBackend> &input,
+                                          int thread_idx) {
+  using Kernel = kernels::ResampleCropMirrorNormalizeCPU<OutputType, uint8_t>;
+  const auto &args = per_thread_args_[thread_idx];
+  kmgr_.CreateOrGet<Kernel>(thread_idx);
+
+  auto in_view = view<const uint8_t, 3>(input);
+  kernels::KernelContext context;
+  auto &req = kmgr_.Setup<Kernel>(thread_idx, context, in_view, args);
+
+  output.set_type(TypeInfo::Create<OutputType>());
+  output.SetLayout(output_layout_);
+  output.Resize(req.output_shapes[0][0].shape.to_vector());
+  auto out_view = view<OutputType, 3>(output);
+  kmgr_.Run<Kernel>(thread_idx, thread_idx, context, out_view, in_view, args);
+}
+
+void ResizeCropMirrorNormalize::RunImpl(SampleWorkspace *ws, const int idx) {
+  const auto &input = ws->Input<CPUBackend>(idx);
+  auto &output = ws->Output<CPUBackend>(idx);
+
+  DALI_ENFORCE(IsType<uint8>(input.type()), "Expected input data as uint8.");
+  DALI_ENFORCE(input.ndim() == 3, "Operator expects 3-dimensional image input.");
+
+  if (output_type_ == DALI_FLOAT16) {
+    RunKernel<float16_cpu>(output, input, ws->thread_idx());
+  } else {
+    RunKernel<float>(output, input, ws->thread_idx());
+  }
+}
+
+}  // namespace dali
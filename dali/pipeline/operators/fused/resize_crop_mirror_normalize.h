@@ -0,0 +1,70 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATORS_FUSED_RESIZE_CROP_MIRROR_NORMALIZE_H_
+#define DALI_PIPELINE_OPERATORS_FUSED_RESIZE_CROP_MIRROR_NORMALIZE_H_
+
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/core/error_handling.h"
+#include "dali/kernels/imgproc/resample/resample_crop_normalize_cpu.h"
+#include "dali/kernels/kernel_manager.h"
+#include "dali/pipeline/operators/fused/resize_crop_mirror.h"
+#include "dali/pipeline/operators/operator.h"
+#include "dali/pipeline/operators/resize/resize_base.h"
+
+namespace dali {
+
+/**
+ * @brief Performs fused resize+crop+mirror+normalize on CPU
+ *
+ * Equivalent to Resize followed by CropMirrorNormalize, but only the pixels inside
+ * the crop window are resampled and the normalized output is written directly
+ * in the requested layout.
+ */
+class ResizeCropMirrorNormalize : public Operator<CPUBackend>
+                                , protected ResizeCropMirrorAttr
+                                , protected ResamplingFilterAttr {
+ public:
+  explicit ResizeCropMirrorNormalize(const OpSpec &spec);
+
+  ~ResizeCropMirrorNormalize() override = default;
+
+ protected:
+  void SetupSharedSampleParams(SampleWorkspace *ws) override;
+
+  void RunImpl(SampleWorkspace *ws, const int idx) override;
+
+  kernels::ResampleCropMirrorNormalizeArgs GetKernelArgs(const TransformMeta &meta,
+                                                         int data_idx) const;
+
+  template <typename OutputType>
+  void RunKernel(Tensor<CPUBackend> &output, const Tensor<CPUBackend> &input, int thread_idx);
+
+  DALIDataType output_type_;
+  DALITensorLayout output_layout_;
+  std::vector<float> mean_vec_, inv_std_vec_;
+
+  // per-thread kernel instances and arguments
+  kernels::KernelManager kmgr_;
+  std::vector<kernels::ResampleCropMirrorNormalizeArgs> per_thread_args_;
+
+  USE_OPERATOR_MEMBERS();
+  using Operator<CPUBackend>::RunImpl;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_FUSED_RESIZE_CROP_MIRROR_NORMALIZE_H_
@@ -0,0 +1,114 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "dali/pipeline/pipeline.h"
+#include "dali/test/dali_test.h"
+
+namespace dali {
+
+class ResizeCropMirrorNormalizeTest : public DALITest {
+ protected:
+  /// Runs the fused operator and Resize + CropMirrorNormalize on the same images
+  /// and compares the outputs
+  void RunTest(DALITensorLayout layout, bool mirror) {
+    const int batch_size = 4;
+    const std::vector<float> mean = { 0.485f * 255, 0.456f * 255, 0.406f * 255 };
+    const std::vector<float> std = { 0.229f * 255, 0.224f * 255, 0.225f * 255 };
+
+    Pipeline pipe(batch_size, 2, 0);
+    pipe.AddExternalInput("data");
+    pipe.AddOperator(OpSpec("ImageDecoder")
+      .AddArg("device", "cpu")
+      .AddArg("output_type", DALI_RGB)
+      .AddInput("data", "cpu")
+      .AddOutput("images", "cpu"));
+
+    pipe.AddOperator(OpSpec("Resize")
+      .AddArg("device", "cpu")
+      .AddArg("resize_shorter", 256.f)
+      .AddInput("images", "cpu")
+      .AddOutput("resized", "cpu"));
+
+    pipe.AddOperator(OpSpec("CropMirrorNormalize")
+      .AddArg("device", "cpu")
+      .AddArg("crop", std::vector<float>{ 224, 224 })
+      .AddArg("crop_pos_x", 0.3f)
+      .AddArg("crop_pos_y", 0.7f)
+      .AddArg("mirror", static_cast<int>(mirror))
+      .AddArg("mean", mean)
+      .AddArg("std", std)
+      .AddArg("output_layout", layout)
+      .AddInput("resized", "cpu")
+      .AddOutput("reference", "cpu"));
+
+    pipe.AddOperator(OpSpec("ResizeCropMirrorNormalize")
+      .AddArg("device", "cpu")
+      .AddArg("resize_shorter", 256.f)
+      .AddArg("crop", std::vector<float>{ 224, 224 })
+      .AddArg("crop_pos_x", 0.3f)
+      .AddArg("crop_pos_y", 0.7f)
+      .AddArg("mirror", static_cast<int>(mirror))
+      .AddArg("mean", mean)
+      .AddArg("std", std)
+      .AddArg("output_layout", layout)
+      .AddInput("images", "cpu")
+      .AddOutput("fused", "cpu"));
+
+    std::vector<std::pair<std::string, std::string>> outputs = {
+      { "reference", "cpu" }, { "fused", "cpu" }
+    };
+    pipe.Build(outputs);
+
+    TensorList<CPUBackend> data;
+    MakeJPEGBatch(&data, batch_size);
+    pipe.SetExternalInput("data", data);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    DeviceWorkspace ws;
+    pipe.Outputs(&ws);
+
+    auto &ref = ws.Output<CPUBackend>(0);
+    auto &fused = ws.Output<CPUBackend>(1);
+    ASSERT_EQ(ref.shape(), fused.shape());
+    EXPECT_EQ(fused.GetLayout(), layout);
+    for (int i = 0; i < batch_size; i++) {
+      const float *ref_data = ref.tensor<float>(i);
+      const float *fused_data = fused.tensor<float>(i);
+      auto n = volume(ref.tensor_shape(i));
+      for (Index j = 0; j < n; j++) {
+        // The crop window is resampled with a different origin, which can flip rounding
+        // of the resized pixel - one normalized intensity level of difference is allowed.
+        ASSERT_NEAR(fused_data[j], ref_data[j], 1.0f / (0.224f * 255) + 1e-4f)
+          << "sample " << i << " at " << j;
+      }
+    }
+  }
+};
+
+TEST_F(ResizeCropMirrorNormalizeTest, MatchesResizeAndCropMirrorNormalize_NCHW) {
+  RunTest(DALI_NCHW, false);
+}
+
+TEST_F(ResizeCropMirrorNormalizeTest, MatchesResizeAndCropMirrorNormalize_NHWC) {
+  RunTest(DALI_NHWC, false);
+}
+
+TEST_F(ResizeCropMirrorNormalizeTest, MatchesResizeAndCropMirrorNormalize_Mirror) {
+  RunTest(DALI_NCHW, true);
+}
+
+}  // namespace dali
@@ -123,6 +123,38 @@ class DLL_PUBLIC OperatorBase {
     DALI_FAIL(name() + " is not a support operator!");
   }
 
+  /**
+   * @brief Returns true if the operator processes every sample of the batch
+   * independently, so the executor may run it on a single sample with RunSample().
+   */
+  DLL_PUBLIC virtual bool CanRunPerSample() const {
+    return false;
+  }
+
+  /**
+   * @brief Executes the operator on the sample `data_idx` of the batch in `ws`.
+   * Valid only if CanRunPerSample() returns true.
+   */
+  DLL_PUBLIC virtual void RunSample(HostWorkspace *ws, int data_idx, int thread_idx) {
+    DALI_FAIL(name() + " cannot be executed per sample!");
+  }
+
+  /**
+   * @brief Estimated cost of processing the sample `data_idx` of the batch in `ws`.
+   * CPU operators start the most expensive samples first; equal costs keep the index order.
+   */
+  DLL_PUBLIC virtual int64_t EstimateSampleCost(HostWorkspace *ws, int data_idx) {
+    return 0;
+  }
+
+  /**
+   * @brief Time, in milliseconds, the last Run() spent waiting for data prepared outside
+   * of the pipeline graph, e.g. by the prefetching thread of a reader.
+   */
+  DLL_PUBLIC virtual double LastRunWaitTime() const {
+    return 0;
+  }
+
   /**
    * @brief returns the name of the operator. By default returns
    * the name of the op as specified by the OpSpec it was constructed
@@ -225,6 +257,36 @@ class Operator<CPUBackend> : public OperatorBase {
     ws->GetThreadPool().WaitForWork();
   }
 
+  /**
+   * @brief Operators built on the per-sample API can be chained sample by sample.
+   * RunSample only calls the SampleWorkspace overloads of SetupSharedSampleParams and
+   * RunImpl, so ops that override Run, RunImpl or SetupSharedSampleParams for the whole
+   * HostWorkspace must return false here.
+   */
+  bool CanRunPerSample() const override {
+    return true;
+  }
+
+  /**
+   * @brief By default the size of the first input: the encoded size for decoders
+   * and the image volume for most of the image processing ops.
+   */
+  int64_t EstimateSampleCost(HostWorkspace *ws, int data_idx) override {
+    if (spec_.NumRegularInput() == 0)
+      return 0;
+    return ws->Input<CPUBackend>(0, data_idx).size();
+  }
+
+  void RunSample(HostWorkspace *ws, int data_idx, int thread_idx) override {
+    SampleWorkspace sample;
+    ws->GetSample(&sample, data_idx, thread_idx);
+    CheckInputLayouts(&sample, spec_);
+    for (int i = 0; i < input_sets_; ++i) {
+      SetupSharedSampleParams(&sample);
+      RunImpl(&sample, i);
+    }
+  }
+
   /**
    * @brief Legacy implementation of CPU operator using per-sample approach
    *
@@ -240,15 +302,17 @@ class Operator<CPUBackend> : public OperatorBase {
     // This is implemented, as a default, using the RunImpl that accepts SampleWorkspace,
     // allowing for fallback to old per-sample implementations.
 
+    std::vector<int64_t> costs(batch_size_);
     for (int data_idx = 0; data_idx < batch_size_; ++data_idx) {
-      auto &thread_pool = ws->GetThreadPool();
-      thread_pool.DoWorkWithID([this, ws, data_idx, idx](int tid) {
-        SampleWorkspace sample;
-        ws->GetSample(&sample, data_idx, tid);
-        this->SetupSharedSampleParams(&sample);
-        this->RunImpl(&sample, idx);
-      });
+      costs[data_idx] = EstimateSampleCost(ws, data_idx);
     }
+    ws->GetThreadPool().DoWorkLargestFirst(costs, [this, ws, idx](int64_t data_idx, int tid) {
+      DALI_TRACE_SCOPE(this->name() + " sample " + to_string(data_idx));
+      SampleWorkspace sample;
+      ws->GetSample(&sample, data_idx, tid);
+      this->SetupSharedSampleParams(&sample);
+      this->RunImpl(&sample, idx);
+    });
   }
 
   /**
@@ -261,6 +325,8 @@ class Operator<CPUBackend> : public OperatorBase {
 
   /**
    * @brief Shared param setup
+   *
+   * Not called when the op is run per sample - see CanRunPerSample.
    */
   virtual void SetupSharedSampleParams(HostWorkspace *ws) {}
 };
@@ -26,9 +26,10 @@ Tensor (`m` * `[x, y, w, h] or `m` * [left, top, right, bottom]`) and labels as
   .AddArg("file_root",
       R"code(Path to a directory containing data files.)code",
       DALI_STRING)
-  .AddArg("annotations_file",
-      R"code(List of paths to the JSON annotations files.)code",
-      DALI_STRING_VEC)
+  .AddOptionalArg("annotations_file",
+      R"code(List of paths to the JSON annotations files.
+Required, unless `preprocessed_annotations` is used.)code",
+      std::vector<std::string>())
   .AddOptionalArg("file_list",
       R"code(Path to the file with a list of pairs ``file label``
 (leave empty to traverse the `file_root` directory to obtain files and labels))code",
@@ -50,6 +51,15 @@ object will be skipped during reading. It is represented as absolute value.)code
   .AddOptionalArg("save_img_ids",
       R"code(If true, image IDs will also be returned.)code",
       false)
+  .AddOptionalArg("save_preprocessed_annotations",
+      R"code(If not empty, the annotations parsed from `annotations_file` are saved to this path
+in a binary format, which can be passed as `preprocessed_annotations` to skip parsing the JSON.)code",
+      std::string())
+  .AddOptionalArg("preprocessed_annotations",
+      R"code(Path to the annotations saved with `save_preprocessed_annotations`, used instead
+of `annotations_file`. The file is memory-mapped; `ltrb`, `ratio` and `size_threshold` must match
+the ones used when it was saved.)code",
+      std::string())
   .AddOptionalArg("shuffle_after_epoch",
       R"code(If true, reader shuffles whole dataset after each epoch.)code",
       false)
@@ -16,7 +16,6 @@
 #define DALI_PIPELINE_OPERATORS_READER_COCO_READER_OP_H_
 
 #include <fstream>
-#include <map>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -48,9 +47,9 @@ class COCOReader : public DataReader<CPUBackend, ImageLabelWrapper> {
     else
       loader_ = InitLoader<CocoLoader>(
         spec,
-        annotations_multimap_,
+        annotations_,
         shuffle_after_epoch);
-    parser_.reset(new COCOParser(spec, annotations_multimap_));
+    parser_.reset(new COCOParser(spec, annotations_));
   }
 
   void RunImpl(SampleWorkspace* ws, const int i) override {
@@ -58,7 +57,7 @@ class COCOReader : public DataReader<CPUBackend, ImageLabelWrapper> {
   }
 
  protected:
-  AnnotationMap annotations_multimap_;
+  CocoAnnotations annotations_;
 
   USE_READER_OPERATOR_MEMBERS(CPUBackend, ImageLabelWrapper);
 };
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
 
 #include "dali/test/dali_test_config.h"
 #include "dali/pipeline/pipeline.h"
@@ -26,10 +29,14 @@ class CocoReaderTest : public ::testing::Test {
   }
 
   OpSpec CocoReaderOpSpec() {
+    return CocoReaderBaseOpSpec()
+          .AddArg("annotations_file", annotations_filename_);
+  }
+
+  OpSpec CocoReaderBaseOpSpec() {
     return OpSpec("COCOReader")
           .AddArg("device", "cpu")
           .AddArg("file_root", file_root_)
-          .AddArg("annotations_file", annotations_filename_)
           .AddArg("save_img_ids", true)
           .AddOutput("images", "cpu")
           .AddOutput("boxes", "cpu")
@@ -252,6 +259,58 @@ TEST_F(CocoReaderTest, IncludeEmpty) {
   this->CheckInstances(ws);
 }
 
+TEST_F(CocoReaderTest, PreprocessedAnnotations) {
+  char name[] = "/tmp/dali_coco_annotations_XXXXXX";
+  int fd = mkstemp(name);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  std::string preprocessed = name;
+
+  {
+    Pipeline pipe(this->SmallCocoSize(), 1, 0);
+    pipe.AddOperator(
+      this->CocoReaderOpSpec()
+      .AddArg("save_preprocessed_annotations", preprocessed),
+      "coco_reader");
+    pipe.Build(this->Outputs());
+  }
+
+  for (bool skip_empty : { false, true }) {
+    int expected_size = this->SmallCocoSize() - (skip_empty ? this->EmptyImages() : 0);
+    Pipeline pipe(expected_size, 1, 0);
+    pipe.AddOperator(
+      this->CocoReaderBaseOpSpec()
+      .AddArg("preprocessed_annotations", preprocessed)
+      .AddArg("skip_empty", skip_empty),
+      "coco_reader");
+    pipe.Build(this->Outputs());
+
+    ASSERT_EQ(pipe.EpochSize()["coco_reader"], expected_size);
+
+    DeviceWorkspace ws;
+    pipe.RunCPU();
+    pipe.RunGPU();
+    pipe.Outputs(&ws);
+
+    auto ids = this->CopyIds(ws);
+    for (int id = 0; id < expected_size; ++id) {
+      ASSERT_EQ(ids[id], id);
+    }
+    if (!skip_empty)
+      this->CheckInstances(ws);
+  }
+
+  // the options used to preprocess the annotations must match
+  Pipeline pipe(this->SmallCocoSize(), 1, 0);
+  pipe.AddOperator(
+    this->CocoReaderBaseOpSpec()
+    .AddArg("preprocessed_annotations", preprocessed)
+    .AddArg("ltrb", true));
+  EXPECT_THROW(pipe.Build(this->Outputs()), std::runtime_error);
+
+  std::remove(preprocessed.c_str());
+}
+
 TEST_F(CocoReaderTest, BigSizeThreshold) {
   Pipeline pipe(this->ImagesWithBigObjects(), 1, 0);
 
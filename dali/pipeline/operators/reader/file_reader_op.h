@@ -20,6 +20,7 @@
 #include <vector>
 #include "dali/pipeline/operators/reader/reader_op.h"
 #include "dali/pipeline/operators/reader/loader/file_loader.h"
+#include "dali/pipeline/operators/reader/parser/parser.h"
 
 namespace dali {
 
@@ -37,19 +38,15 @@ class FileReader : public DataReader<CPUBackend, ImageLabelWrapper> {
 
     const auto& image_label = GetSample(idx);
 
-    // copy from raw_data -> outputs directly
+    // pass the encoded image to the output without copying, if possible
     auto &image_output = ws->Output<CPUBackend>(0);
     auto &label_output = ws->Output<CPUBackend>(1);
 
     Index image_size = image_label.image.size();
 
-    image_output.Resize({image_size});
-    image_output.mutable_data<uint8_t>();
     label_output.Resize({1});
 
-    std::memcpy(image_output.raw_mutable_data(),
-                image_label.image.raw_data(),
-                image_size);
+    ShareOrCopyBytes(image_output, image_label.image, 0, image_size);
     image_output.SetSourceInfo(image_label.image.GetSourceInfo());
 
     label_output.mutable_data<int>()[0] = image_label.label;
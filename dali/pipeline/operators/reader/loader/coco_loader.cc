@@ -17,9 +17,18 @@
 #include <rapidjson/reader.h>
 #include <rapidjson/document.h>
 
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <map>
 #include <unordered_map>
 
+#include "dali/util/file.h"
+
 RAPIDJSON_DIAG_PUSH
 #ifdef __GNUC__
 RAPIDJSON_DIAG_OFF(effc++)
@@ -289,152 +298,369 @@ int LookaheadParser::PeekType() {
 
 namespace dali {
 
+constexpr int CocoAnnotations::kBboxSize;
+
 namespace detail {
 
-void ParseAnnotationFilesHelper(std::vector<std::string> &annotations_filename,
-                                AnnotationMap &annotations_multimap,
-                                std::vector<std::pair<std::string, int>> &image_id_pairs,
-                                bool ltrb, bool ratio, float size_threshold, bool skip_empty) {
-  for (auto& file_name : annotations_filename) {
-    // Loading raw json into the RAM
-    std::ifstream f(file_name);
-    DALI_ENFORCE(f, "Could not open JSON annotations file: " + file_name);
-    f.seekg(0, std::ios::end);
-    size_t file_size = f.tellg();
-    std::unique_ptr<char, std::function<void(char*)>> buff(new char[file_size + 1],
-                                                           [](char* data) {delete [] data;});
-    f.seekg(0, std::ios::beg);
-    f.read(buff.get(), file_size);
-    buff.get()[file_size] = '\0';
-
-    LookaheadParser r(buff.get());
-
-    // mapping each image_id to its WH dimension
-    std::unordered_map<int, std::pair<int, int> > image_id_to_wh;
-
-    // mapping each category_id to its actual category
-    std::map<int, int> category_ids;
-    int current_id = 1;
-
-    RAPIDJSON_ASSERT(r.PeekType() == kObjectType);
-    r.EnterObject();
-    while (const char* key = r.NextObjectKey()) {
-      if (0 == strcmp(key, "images")) {
-        RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
-        r.EnterArray();
-        int id;
-        string image_file_name;
-        int width;
-        int height;
-        while (r.NextArrayValue()) {
-          if (r.PeekType() != kObjectType) {
-            continue;
-          }
-          r.EnterObject();
-          while (const char* internal_key = r.NextObjectKey()) {
-            if (0 == strcmp(internal_key, "id")) {
-                id = r.GetInt();
-            } else if (0 == strcmp(internal_key, "width")) {
-                width = r.GetInt();
-            } else if (0 == strcmp(internal_key, "height")) {
-                height = r.GetInt();
-            } else if (0 == strcmp(internal_key, "file_name")) {
-                image_file_name = r.GetString();
-            } else {
-              r.SkipValue();
-            }
-          }
-          image_id_pairs.push_back(std::make_pair(image_file_name, id));
-          image_id_to_wh.insert(std::make_pair(id, std::make_pair(width, height)));
+namespace {
+
+struct ImageInfo {
+  int id;
+  std::string file_name;
+  int width, height;
+};
+
+struct ObjectInfo {
+  int image_id;
+  int category_id;
+  std::array<float, 4> bbox;
+};
+
+void ParseAnnotationFile(const std::string &file_name,
+                         std::vector<ImageInfo> &images,
+                         std::vector<ObjectInfo> &objects,
+                         const CocoAnnotationOptions &options) {
+  // Loading raw json into the RAM
+  std::ifstream f(file_name);
+  DALI_ENFORCE(f, "Could not open JSON annotations file: " + file_name);
+  f.seekg(0, std::ios::end);
+  size_t file_size = f.tellg();
+  std::unique_ptr<char, std::function<void(char*)>> buff(new char[file_size + 1],
+                                                         [](char* data) {delete [] data;});
+  f.seekg(0, std::ios::beg);
+  f.read(buff.get(), file_size);
+  buff.get()[file_size] = '\0';
+
+  LookaheadParser r(buff.get());
+
+  // mapping each category_id to its actual category
+  std::map<int, int> category_ids;
+  int current_id = 1;
+  size_t first_object = objects.size();
+
+  RAPIDJSON_ASSERT(r.PeekType() == kObjectType);
+  r.EnterObject();
+  while (const char* key = r.NextObjectKey()) {
+    if (0 == strcmp(key, "images")) {
+      RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
+      r.EnterArray();
+      ImageInfo image = {};
+      while (r.NextArrayValue()) {
+        if (r.PeekType() != kObjectType) {
+          continue;
         }
-      } else if (0 == strcmp(key, "categories")) {
-        RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
-        r.EnterArray();
-        int id;
-        while (r.NextArrayValue()) {
-          if (r.PeekType() != kObjectType) {
-            continue;
-          }
-          id = -1;
-          r.EnterObject();
-          while (const char* internal_key = r.NextObjectKey()) {
-            if (0 == strcmp(internal_key, "id")) {
-              id = r.GetInt();
-            } else {
-              r.SkipValue();
-            }
+        r.EnterObject();
+        while (const char* internal_key = r.NextObjectKey()) {
+          if (0 == strcmp(internal_key, "id")) {
+              image.id = r.GetInt();
+          } else if (0 == strcmp(internal_key, "width")) {
+              image.width = r.GetInt();
+          } else if (0 == strcmp(internal_key, "height")) {
+              image.height = r.GetInt();
+          } else if (0 == strcmp(internal_key, "file_name")) {
+              image.file_name = r.GetString();
+          } else {
+            r.SkipValue();
           }
-          DALI_ENFORCE(id != -1, "Missing category ID in the JSON annotations file");
-          category_ids.insert(std::make_pair(id, current_id));
-          current_id++;
         }
-      } else if (0 == strcmp(key, "annotations")) {
-        RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
-        r.EnterArray();
-        int image_id;
-        int category_id;
-        std::array<float, 4> bbox = {0, };
-        while (r.NextArrayValue()) {
-          if (r.PeekType() != kObjectType) {
-            continue;
+        images.push_back(image);
+      }
+    } else if (0 == strcmp(key, "categories")) {
+      RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
+      r.EnterArray();
+      int id;
+      while (r.NextArrayValue()) {
+        if (r.PeekType() != kObjectType) {
+          continue;
+        }
+        id = -1;
+        r.EnterObject();
+        while (const char* internal_key = r.NextObjectKey()) {
+          if (0 == strcmp(internal_key, "id")) {
+            id = r.GetInt();
+          } else {
+            r.SkipValue();
           }
-          r.EnterObject();
-          while (const char* internal_key = r.NextObjectKey()) {
-            if (0 == strcmp(internal_key, "image_id")) {
-              image_id = r.GetInt();
-            } else if (0 == strcmp(internal_key, "category_id")) {
-              category_id = r.GetInt();
-            } else if (0 == strcmp(internal_key, "bbox")) {
-              RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
-              r.EnterArray();
-              int i = 0;
-              while (r.NextArrayValue()) {
-                bbox[i] = r.GetDouble();
-                ++i;
-              }
-            } else {
-              r.SkipValue();
+        }
+        DALI_ENFORCE(id != -1, "Missing category ID in the JSON annotations file");
+        category_ids.insert(std::make_pair(id, current_id));
+        current_id++;
+      }
+    } else if (0 == strcmp(key, "annotations")) {
+      RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
+      r.EnterArray();
+      ObjectInfo object = {};
+      while (r.NextArrayValue()) {
+        if (r.PeekType() != kObjectType) {
+          continue;
+        }
+        r.EnterObject();
+        while (const char* internal_key = r.NextObjectKey()) {
+          if (0 == strcmp(internal_key, "image_id")) {
+            object.image_id = r.GetInt();
+          } else if (0 == strcmp(internal_key, "category_id")) {
+            object.category_id = r.GetInt();
+          } else if (0 == strcmp(internal_key, "bbox")) {
+            RAPIDJSON_ASSERT(r.PeekType() == kArrayType);
+            r.EnterArray();
+            int i = 0;
+            while (r.NextArrayValue()) {
+              object.bbox[i] = r.GetDouble();
+              ++i;
             }
+          } else {
+            r.SkipValue();
           }
-          if (bbox[2] < size_threshold || bbox[3] < size_threshold) {
-            continue;
-          }
-
-          if (ltrb) {
-            bbox[2] += bbox[0];
-            bbox[3] += bbox[1];
-          }
+        }
+        if (object.bbox[2] < options.size_threshold || object.bbox[3] < options.size_threshold) {
+          continue;
+        }
 
-          annotations_multimap.insert(
-            std::make_pair(image_id,
-              Annotation(bbox[0], bbox[1], bbox[2], bbox[3], category_id)));
+        if (options.ltrb) {
+          object.bbox[2] += object.bbox[0];
+          object.bbox[3] += object.bbox[1];
         }
-      } else {
-        r.SkipValue();
+        objects.push_back(object);
       }
+    } else {
+      r.SkipValue();
     }
-    for (auto &elm : annotations_multimap) {
-      elm.second.category_id = category_ids[elm.second.category_id];
+  }
+  // categories may be listed after the annotations
+  for (size_t i = first_object; i < objects.size(); i++) {
+    auto it = category_ids.find(objects[i].category_id);
+    objects[i].category_id = it != category_ids.end() ? it->second : 0;
+  }
+  f.close();
+}
+
+}  // namespace
+
+CocoAnnotations ParseAnnotationFiles(const std::vector<std::string> &annotations_filename,
+                                     const CocoAnnotationOptions &options) {
+  std::vector<ImageInfo> images;
+  std::vector<ObjectInfo> objects;
+  for (auto& file_name : annotations_filename) {
+    ParseAnnotationFile(file_name, images, objects, options);
+  }
+
+  // the first image with a given id; it also provides the size used with `ratio`
+  std::unordered_map<int, int64_t> image_idx;
+  image_idx.reserve(images.size());
+  for (size_t i = 0; i < images.size(); i++)
+    image_idx.emplace(images[i].id, i);
+
+  // Counting sort of the objects by image, which keeps their order within an image
+  int64_t num_images = images.size();
+  std::vector<int64_t> offsets(num_images + 1, 0);
+  std::vector<int64_t> object_image(objects.size(), -1);
+  for (size_t i = 0; i < objects.size(); i++) {
+    auto it = image_idx.find(objects[i].image_id);
+    if (it == image_idx.end())
+      continue;
+    object_image[i] = it->second;
+    offsets[it->second + 1]++;
+  }
+  for (int64_t i = 0; i < num_images; i++)
+    offsets[i + 1] += offsets[i];
+
+  int64_t num_objects = offsets[num_images];
+  std::vector<float> boxes(num_objects * CocoAnnotations::kBboxSize);
+  std::vector<int> labels(num_objects);
+  std::vector<int64_t> next(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < objects.size(); i++) {
+    int64_t idx = object_image[i];
+    if (idx < 0)
+      continue;
+    int64_t pos = next[idx]++;
+    auto bbox = objects[i].bbox;
+    if (options.ratio) {
+      bbox[0] /= static_cast<float>(images[idx].width);
+      bbox[1] /= static_cast<float>(images[idx].height);
+      bbox[2] /= static_cast<float>(images[idx].width);
+      bbox[3] /= static_cast<float>(images[idx].height);
     }
-    if (skip_empty) {
-      std::vector<std::pair<std::string, int>> non_empty_ids;
-      non_empty_ids.reserve(image_id_pairs.size());
-      for (const auto &id_pair : image_id_pairs)
-        if (annotations_multimap.count(id_pair.second) > 0)
-          non_empty_ids.push_back(id_pair);
-      image_id_pairs = std::move(non_empty_ids);
+    std::copy(bbox.begin(), bbox.end(), &boxes[pos * CocoAnnotations::kBboxSize]);
+    labels[pos] = objects[i].category_id;
+  }
+
+  if (image_idx.size() < images.size()) {
+    // An image id listed more than once (e.g. in several annotation files) - every
+    // occurrence gets all the objects annotated with that id
+    std::vector<int64_t> all_offsets(num_images + 1, 0);
+    for (int64_t i = 0; i < num_images; i++) {
+      int64_t first = image_idx[images[i].id];
+      all_offsets[i + 1] = all_offsets[i] + offsets[first + 1] - offsets[first];
     }
-    if (ratio) {
-      for (auto& elm : annotations_multimap) {
-        const auto& wh = image_id_to_wh[elm.first];
-        elm.second.bbox[0] /= static_cast<float>(wh.first);
-        elm.second.bbox[1] /= static_cast<float>(wh.second);
-        elm.second.bbox[2] /= static_cast<float>(wh.first);
-        elm.second.bbox[3] /= static_cast<float>(wh.second);
-      }
+    std::vector<float> all_boxes(all_offsets[num_images] * CocoAnnotations::kBboxSize);
+    std::vector<int> all_labels(all_offsets[num_images]);
+    for (int64_t i = 0; i < num_images; i++) {
+      int64_t first = image_idx[images[i].id];
+      std::copy(boxes.begin() + offsets[first] * CocoAnnotations::kBboxSize,
+                boxes.begin() + offsets[first + 1] * CocoAnnotations::kBboxSize,
+                all_boxes.begin() + all_offsets[i] * CocoAnnotations::kBboxSize);
+      std::copy(labels.begin() + offsets[first], labels.begin() + offsets[first + 1],
+                all_labels.begin() + all_offsets[i]);
     }
-    f.close();
+    offsets = std::move(all_offsets);
+    boxes = std::move(all_boxes);
+    labels = std::move(all_labels);
+  }
+
+  std::vector<int> image_ids(num_images);
+  std::vector<int64_t> name_offsets(num_images + 1, 0);
+  std::vector<char> file_names;
+  for (int64_t i = 0; i < num_images; i++) {
+    image_ids[i] = images[i].id;
+    file_names.insert(file_names.end(), images[i].file_name.begin(), images[i].file_name.end());
+    name_offsets[i + 1] = file_names.size();
   }
+
+  return CocoAnnotations(std::move(offsets), std::move(image_ids), std::move(boxes),
+                         std::move(labels), std::move(name_offsets), std::move(file_names));
+}
+
+namespace {
+
+/**
+ * Layout of the preprocessed annotations file; all the arrays start at multiples of 8 bytes:
+ *
+ *   PreprocessedHeader
+ *   int64   offsets[num_images + 1]
+ *   int32   image_ids[num_images]
+ *   float   boxes[num_objects * 4]
+ *   int32   labels[num_objects]
+ *   int64   name_offsets[num_images + 1]
+ *   char    file_names[file_names_size]
+ *
+ * The file is written in the native byte order.
+ */
+struct PreprocessedHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t ltrb;
+  uint32_t ratio;
+  float size_threshold;
+  int64_t num_images;
+  int64_t num_objects;
+  int64_t file_names_size;
+};
+
+const char kPreprocessedMagic[8] = {'D', 'A', 'L', 'I', 'C', 'O', 'C', 'O'};
+const uint32_t kPreprocessedVersion = 1;
+
+inline size_t AlignedSize(size_t size) {
+  return (size + 7) & ~size_t(7);
+}
+
+template <typename T>
+void WriteArray(std::ofstream &f, const T *data, int64_t count) {
+  size_t size = count * sizeof(T);
+  f.write(reinterpret_cast<const char *>(data), size);
+  const char padding[8] = {0};
+  f.write(padding, AlignedSize(size) - size);
+}
+
+template <typename T>
+const T *MapArray(const char *&ptr, int64_t count) {
+  auto *ret = reinterpret_cast<const T *>(ptr);
+  ptr += AlignedSize(count * sizeof(T));
+  return ret;
+}
+
+/// Checks that `offsets` start at 0, do not decrease and end at `total`
+bool ValidOffsets(const int64_t *offsets, int64_t count, int64_t total) {
+  if (offsets[0] != 0 || offsets[count] != total)
+    return false;
+  for (int64_t i = 0; i < count; i++) {
+    if (offsets[i + 1] < offsets[i])
+      return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void SavePreprocessedAnnotations(const std::string &path, const CocoAnnotations &annotations,
+                                 const CocoAnnotationOptions &options) {
+  PreprocessedHeader header = {};
+  std::copy(kPreprocessedMagic, kPreprocessedMagic + 8, header.magic);
+  header.version = kPreprocessedVersion;
+  header.ltrb = options.ltrb;
+  header.ratio = options.ratio;
+  header.size_threshold = options.size_threshold;
+  header.num_images = annotations.num_images();
+  header.num_objects = annotations.num_objects();
+  header.file_names_size = header.num_images ? annotations.name_offsets()[header.num_images] : 0;
+
+  // write to a temporary file first, so that concurrent readers never see a partial file
+  std::string tmp_path = path + ".tmp" + std::to_string(getpid());
+  std::ofstream f(tmp_path, std::ios::binary);
+  DALI_ENFORCE(f.good(), "Could not open " + tmp_path + " for writing.");
+  WriteArray(f, &header, 1);
+  std::vector<int64_t> empty_offsets(1, 0);
+  const int64_t *offsets = header.num_images ? annotations.offsets() : empty_offsets.data();
+  const int64_t *name_offsets =
+      header.num_images ? annotations.name_offsets() : empty_offsets.data();
+  WriteArray(f, offsets, header.num_images + 1);
+  WriteArray(f, annotations.image_ids(), header.num_images);
+  WriteArray(f, annotations.boxes(), header.num_objects * CocoAnnotations::kBboxSize);
+  WriteArray(f, annotations.labels(), header.num_objects);
+  WriteArray(f, name_offsets, header.num_images + 1);
+  WriteArray(f, annotations.file_names(), header.file_names_size);
+  f.close();
+  DALI_ENFORCE(f.good(), "Could not write preprocessed annotations to " + tmp_path + ".");
+  DALI_ENFORCE(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+    "Could not rename " + tmp_path + " to " + path + ": " + std::strerror(errno));
+}
+
+CocoAnnotations LoadPreprocessedAnnotations(const std::string &path,
+                                            const CocoAnnotationOptions &options) {
+  auto file = FileStream::Open(path, false);
+  size_t size = file->Size();
+  DALI_ENFORCE(size >= sizeof(PreprocessedHeader),
+    path + " is not a preprocessed COCO annotations file.");
+  std::shared_ptr<void> data = file->Get(size);
+  file->Close();
+  DALI_ENFORCE(data != nullptr, "Could not read " + path);
+
+  const char *ptr = static_cast<const char *>(data.get());
+  auto &header = *MapArray<PreprocessedHeader>(ptr, 1);
+  DALI_ENFORCE(std::equal(kPreprocessedMagic, kPreprocessedMagic + 8, header.magic),
+    path + " is not a preprocessed COCO annotations file.");
+  DALI_ENFORCE(header.version == kPreprocessedVersion,
+    "Unsupported version of the preprocessed COCO annotations file " + path + ": " +
+    std::to_string(header.version));
+  DALI_ENFORCE(static_cast<bool>(header.ltrb) == options.ltrb &&
+               static_cast<bool>(header.ratio) == options.ratio &&
+               header.size_threshold == options.size_threshold,
+    "Preprocessed annotations in " + path + " were saved with different `ltrb`, `ratio` "
+    "or `size_threshold` options.");
+
+  size_t expected_size = sizeof(PreprocessedHeader) +
+      2 * AlignedSize((header.num_images + 1) * sizeof(int64_t)) +
+      AlignedSize(header.num_images * sizeof(int)) +
+      AlignedSize(header.num_objects * CocoAnnotations::kBboxSize * sizeof(float)) +
+      AlignedSize(header.num_objects * sizeof(int)) +
+      AlignedSize(header.file_names_size);
+  DALI_ENFORCE(header.num_images >= 0 && header.num_objects >= 0 &&
+               header.file_names_size >= 0 && size == expected_size,
+    "Preprocessed COCO annotations file " + path + " is corrupted.");
+
+  int64_t num_images = header.num_images;
+  int64_t num_objects = header.num_objects;
+  auto *offsets = MapArray<int64_t>(ptr, num_images + 1);
+  auto *image_ids = MapArray<int>(ptr, num_images);
+  auto *boxes = MapArray<float>(ptr, num_objects * CocoAnnotations::kBboxSize);
+  auto *labels = MapArray<int>(ptr, num_objects);
+  auto *name_offsets = MapArray<int64_t>(ptr, num_images + 1);
+  auto *file_names = MapArray<char>(ptr, header.file_names_size);
+  DALI_ENFORCE(ValidOffsets(offsets, num_images, num_objects) &&
+               ValidOffsets(name_offsets, num_images, header.file_names_size),
+    "Preprocessed COCO annotations file " + path + " is corrupted.");
+
+  return CocoAnnotations(std::move(data), num_images, offsets, image_ids, boxes, labels,
+                         name_offsets, file_names);
 }
 
 }  // namespace detail
@@ -28,40 +28,79 @@
 
 namespace dali {
 
+struct CocoAnnotationOptions {
+  bool ltrb = false;
+  bool ratio = false;
+  float size_threshold = 0;
+};
+
 namespace detail {
 
-void ParseAnnotationFilesHelper(
-  std::vector<std::string> &annotations_filename,
-  AnnotationMap &annotations_multimap,
-  std::vector<std::pair<std::string, int>> &image_id_pairs,
-  bool ltrb, bool ratio, float size_threshold, bool skip_empty);
+/**
+ * @brief Parses the JSON annotation files into the CSR layout
+ *
+ * Annotations are attached to the image with a matching id; annotations of unknown
+ * images are dropped.
+ */
+CocoAnnotations ParseAnnotationFiles(const std::vector<std::string> &annotations_filename,
+                                     const CocoAnnotationOptions &options);
+
+/**
+ * @brief Writes annotations in a binary format, which LoadPreprocessedAnnotations
+ *        maps into memory without any parsing
+ */
+void SavePreprocessedAnnotations(const std::string &path, const CocoAnnotations &annotations,
+                                 const CocoAnnotationOptions &options);
+
+/**
+ * @brief Maps a file written by SavePreprocessedAnnotations
+ *
+ * The options must match the ones the file was written with.
+ */
+CocoAnnotations LoadPreprocessedAnnotations(const std::string &path,
+                                            const CocoAnnotationOptions &options);
 
-}
+}  // namespace detail
 
 class CocoLoader : public FileLoader {
  public:
   explicit inline CocoLoader(
     const OpSpec& spec,
-    AnnotationMap &annotations_multimap,
+    CocoAnnotations &annotations,
     bool shuffle_after_epoch = false) :
       FileLoader(spec, std::vector<std::pair<string, int>>(), shuffle_after_epoch),
-      annotations_multimap_(annotations_multimap),
+      annotations_(annotations),
       annotations_filename_(spec.GetRepeatedArgument<std::string>("annotations_file")),
-      ltrb_(spec.GetArgument<bool>("ltrb")),
-      ratio_(spec.GetArgument<bool>("ratio")),
-      size_threshold_(spec.GetArgument<float>("size_threshold")),
-      skip_empty_(spec.GetArgument<bool>("skip_empty")) {}
+      preprocessed_annotations_(spec.GetArgument<std::string>("preprocessed_annotations")),
+      save_preprocessed_annotations_(
+        spec.GetArgument<std::string>("save_preprocessed_annotations")),
+      skip_empty_(spec.GetArgument<bool>("skip_empty")) {
+    options_.ltrb = spec.GetArgument<bool>("ltrb");
+    options_.ratio = spec.GetArgument<bool>("ratio");
+    options_.size_threshold = spec.GetArgument<float>("size_threshold");
+    DALI_ENFORCE(!annotations_filename_.empty() || !preprocessed_annotations_.empty(),
+      "Either `annotations_file` or `preprocessed_annotations` must be provided.");
+  }
 
  protected:
   void PrepareMetadataImpl() override {
-    detail::ParseAnnotationFilesHelper(
-      annotations_filename_,
-      annotations_multimap_,
-      image_label_pairs_,
-      ltrb_,
-      ratio_,
-      size_threshold_,
-      skip_empty_);
+    if (!preprocessed_annotations_.empty()) {
+      annotations_ = detail::LoadPreprocessedAnnotations(preprocessed_annotations_, options_);
+    } else {
+      annotations_ = detail::ParseAnnotationFiles(annotations_filename_, options_);
+      if (!save_preprocessed_annotations_.empty())
+        detail::SavePreprocessedAnnotations(save_preprocessed_annotations_, annotations_,
+                                            options_);
+    }
+
+    // the label of each image is its index in `annotations_`
+    image_label_pairs_.clear();
+    image_label_pairs_.reserve(annotations_.num_images());
+    for (int64_t idx = 0; idx < annotations_.num_images(); idx++) {
+      if (skip_empty_ && annotations_.num_objects(idx) == 0)
+        continue;
+      image_label_pairs_.emplace_back(annotations_.file_name(idx), static_cast<int>(idx));
+    }
 
     DALI_ENFORCE(Size() > 0, "No files found.");
     if (shuffle_) {
@@ -73,11 +112,11 @@ class CocoLoader : public FileLoader {
     Reset(true);
   }
 
-  AnnotationMap &annotations_multimap_;
+  CocoAnnotations &annotations_;
   std::vector<std::string> annotations_filename_;
-  bool ltrb_;
-  bool ratio_;
-  float size_threshold_;
+  std::string preprocessed_annotations_;
+  std::string save_preprocessed_annotations_;
+  CocoAnnotationOptions options_;
   bool skip_empty_;
 };
 
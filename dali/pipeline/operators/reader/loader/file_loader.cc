@@ -95,6 +95,12 @@ void FileLoader::PrepareEmpty(ImageLabelWrapper &image_label) {
 }
 
 void FileLoader::ReadSample(ImageLabelWrapper &image_label) {
+  auto read = ReadSampleDeferred(image_label);
+  if (read)
+    read();
+}
+
+FileLoader::ReadWork FileLoader::ReadSampleDeferred(ImageLabelWrapper &image_label) {
   auto image_pair = image_label_pairs_[current_index_++];
 
   // handle wrap-around
@@ -113,32 +119,33 @@ void FileLoader::ReadSample(ImageLabelWrapper &image_label) {
     image_label.image.SetMeta(meta);
     image_label.image.set_type(TypeInfo::Create<uint8_t>());
     image_label.image.Resize({0});
-    return;
+    return {};
   }
 
-  auto current_image = FileStream::Open(file_root_ + "/" + image_pair.first, read_ahead_);
-  Index image_size = current_image->Size();
-
-  if (copy_read_data_) {
-    if (image_label.image.shares_data()) {
-      image_label.image.Reset();
+  // Opening and reading the file is independent of the loader state
+  return [this, &image_label, meta, path = file_root_ + "/" + image_pair.first]() {
+    auto current_image = FileStream::Open(path, read_ahead_, !dont_use_mmap_, use_o_direct_);
+    Index image_size = current_image->Size();
+
+    if (copy_read_data_) {
+      if (image_label.image.shares_data()) {
+        image_label.image.Reset();
+      }
+      image_label.image.Resize({image_size});
+      // copy the image
+      current_image->Read(image_label.image.mutable_data<uint8_t>(), image_size);
+    } else {
+      auto p = current_image->Get(image_size);
+      // Wrap the raw data in the Tensor object.
+      image_label.image.ShareData(p, image_size, {image_size});
+      image_label.image.set_type(TypeInfo::Create<uint8_t>());
     }
-    image_label.image.Resize({image_size});
-    // copy the image
-    current_image->Read(image_label.image.mutable_data<uint8_t>(), image_size);
-  } else {
-    auto p = current_image->Get(image_size);
-    // Wrap the raw data in the Tensor object.
-    image_label.image.ShareData(p, image_size, {image_size});
-    image_label.image.set_type(TypeInfo::Create<uint8_t>());
-  }
 
-  // close the file handle
-  current_image->Close();
+    // close the file handle
+    current_image->Close();
 
-  // copy the label
-  image_label.label = image_pair.second;
-  image_label.image.SetMeta(meta);
+    image_label.image.SetMeta(meta);
+  };
 }
 
 Index FileLoader::SizeImpl() {
@@ -76,13 +76,19 @@ class FileLoader : public Loader<CPUBackend, ImageLabelWrapper> {
       if (shuffle_after_epoch_) {
         stick_to_shard_ = true;
       }
+    // the mappings are kept by the samples in the buffer and by the ones in flight,
+    // whose images the reader passes to its outputs without copying
     mmap_reserver = FileStream::FileStreamMappinReserver(
-        static_cast<unsigned int>(initial_buffer_fill_));
-    copy_read_data_ = !mmap_reserver.CanShareMappedData();
+        static_cast<unsigned int>(initial_buffer_fill_ + samples_in_flight_));
+    copy_read_data_ = dont_use_mmap_ || !mmap_reserver.CanShareMappedData();
   }
 
   void PrepareEmpty(ImageLabelWrapper &tensor) override;
+  void DetachBuffers(ImageLabelWrapper &tensor) override {
+    DetachTensorBuffer(tensor.image);
+  }
   void ReadSample(ImageLabelWrapper &tensor) override;
+  ReadWork ReadSampleDeferred(ImageLabelWrapper &tensor) override;
 
  protected:
   Index SizeImpl() override;
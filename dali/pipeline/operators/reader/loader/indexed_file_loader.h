@@ -23,6 +23,7 @@
 
 #include "dali/core/common.h"
 #include "dali/pipeline/operators/reader/loader/loader.h"
+#include "dali/pipeline/operators/reader/loader/sample_index.h"
 #include "dali/util/file.h"
 
 namespace dali {
@@ -37,11 +38,18 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     }
 
   void ReadSample(Tensor<CPUBackend>& tensor) override {
+    auto read = ReadSampleDeferred(tensor);
+    if (read)
+      read();
+  }
+
+  ReadWork ReadSampleDeferred(Tensor<CPUBackend>& tensor) override {
     MoveToNextShard(current_index_);
 
-    int64 seek_pos, size;
-    size_t file_index;
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    auto entry = indices_[current_index_];
+    int64 seek_pos = entry.offset;
+    int64 size = entry.size;
+    size_t file_index = entry.file_index;
     ++current_index_;
 
     std::string image_key = uris_[file_index] + " at index " + to_string(seek_pos);
@@ -49,65 +57,52 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     meta.SetSourceInfo(image_key);
     meta.SetSkipSample(false);
 
-    if (file_index != current_file_index_) {
-      current_file_->Close();
-      current_file_ = FileStream::Open(uris_[file_index], read_ahead_);
-      current_file_index_ = file_index;
-    }
-
     // if image is cached, skip loading
     if (ShouldSkipImage(image_key)) {
       meta.SetSkipSample(true);
-      should_seek_ = true;
       tensor.Reset();
       tensor.SetMeta(meta);
       tensor.set_type(TypeInfo::Create<uint8_t>());
       tensor.Resize({0});
-      return;
+      return {};
     }
 
-    if (should_seek_) {
-      current_file_->Seek(seek_pos);
-      should_seek_ = false;
-    }
-
-    if (!copy_read_data_) {
-      auto p = current_file_->Get(size);
-      DALI_ENFORCE(p != nullptr, "Error reading from a file " + uris_[current_file_index_]);
-      // Wrap the raw data in the Tensor object.
-      tensor.ShareData(p, size, {size});
-      tensor.set_type(TypeInfo::Create<uint8_t>());
-    } else {
-      if (tensor.shares_data()) {
-        tensor.Reset();
+    std::shared_ptr<FileStream> file = OpenFile(file_index);
+    return [this, &tensor, file, seek_pos, size, file_index, meta]() {
+      if (!copy_read_data_) {
+        auto p = file->GetAt(size, seek_pos);
+        DALI_ENFORCE(p != nullptr, "Error reading from a file " + uris_[file_index]);
+        // Wrap the raw data in the Tensor object.
+        tensor.ShareData(p, size, {size});
+        tensor.set_type(TypeInfo::Create<uint8_t>());
+      } else {
+        if (tensor.shares_data()) {
+          tensor.Reset();
+        }
+        tensor.set_type(TypeInfo::Create<uint8_t>());
+        tensor.Resize({size});
+
+        int64 n_read = file->ReadAt(reinterpret_cast<uint8_t*>(tensor.raw_mutable_data()),
+                                    size, seek_pos);
+        DALI_ENFORCE(n_read == size, "Error reading from a file " + uris_[file_index]);
       }
-      tensor.set_type(TypeInfo::Create<uint8_t>());
-      tensor.Resize({size});
-
-      int64 n_read = current_file_->Read(reinterpret_cast<uint8_t*>(tensor.raw_mutable_data()),
-                          size);
-      DALI_ENFORCE(n_read == size, "Error reading from a file " + uris_[current_file_index_]);
-    }
-
-    tensor.SetMeta(meta);
-    return;
-  }
-
-  ~IndexedFileLoader() override {
-    if (current_file_ != nullptr) {
-      current_file_->Close();
-    }
+      tensor.SetMeta(meta);
+    };
   }
 
   virtual void ReadIndexFile(const std::vector<std::string>& index_uris) {
     DALI_ENFORCE(index_uris.size() == uris_.size(),
         "Number of index files needs to match the number of data files");
     for (size_t i = 0; i < index_uris.size(); ++i) {
+      if (SampleIndex::IsBinaryIndexFile(index_uris[i])) {
+        indices_.AddBinaryIndexFile(index_uris[i], i);
+        continue;
+      }
       std::ifstream fin(index_uris[i]);
       DALI_ENFORCE(fin.good(), "Failed to open file " + index_uris[i]);
       int64 pos, size;
       while (fin >> pos >> size) {
-        indices_.push_back(std::make_tuple(pos, size, i));
+        indices_.push_back(pos, size, i);
       }
       fin.close();
     }
@@ -126,37 +121,41 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     Reset(true);
 
     mmap_reserver = FileStream::FileStreamMappinReserver(uris_.size());
-    copy_read_data_ = !mmap_reserver.CanShareMappedData();
+    copy_read_data_ = dont_use_mmap_ || !mmap_reserver.CanShareMappedData();
   }
 
   void Reset(bool wrap_to_shard) override {
-    int64 seek_pos, size;
-    size_t file_index;
     if (wrap_to_shard) {
       current_index_ = start_index(shard_id_, num_shards_, Size());
     } else {
       current_index_ = 0;
     }
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+  }
+
+  /**
+   * @brief Returns the stream of the file `file_index`, which stays open until
+   *        a sample from another file is read
+   *
+   * The reads are positional, so the deferred reads of a batch share the stream,
+   * and keep it alive after the loader moves on to the next file.
+   */
+  std::shared_ptr<FileStream> OpenFile(size_t file_index) {
     if (file_index != current_file_index_) {
-      if (current_file_index_ != static_cast<size_t>(INVALID_INDEX)) {
-        current_file_->Close();
-      }
-      current_file_ = FileStream::Open(uris_[file_index], read_ahead_);
+      current_file_ = FileStream::Open(uris_[file_index],
+                                       read_ahead_, !dont_use_mmap_, use_o_direct_);
       current_file_index_ = file_index;
     }
-    current_file_->Seek(seek_pos);
+    return current_file_;
   }
 
   std::vector<std::string> uris_;
   std::vector<std::string> index_uris_;
-  std::vector<std::tuple<int64, int64, size_t>> indices_;
+  SampleIndex indices_;
   size_t current_index_;
   size_t current_file_index_;
-  std::unique_ptr<FileStream> current_file_;
+  std::shared_ptr<FileStream> current_file_;
   FileStream::FileStreamMappinReserver mmap_reserver;
   static constexpr int INVALID_INDEX = -1;
-  bool should_seek_ = false;
 };
 
 }  // namespace dali
@@ -38,9 +38,24 @@ accuracy in some cases)code", false)
       R"code(Whether accessed data should be read ahead. In case of big files like LMDB,
 RecordIO or TFRecord it will slow down first access but will decrease the time of all following
 accesses.)code", false)
+  .AddOptionalArg("dont_use_mmap",
+      R"code(If set to true, files are read with positional reads straight into the sample buffers instead of
+being memory-mapped. This avoids synchronous page faults when the data is accessed and, together with
+`num_prefetch_threads`, allows the reads of a whole batch to be in flight at once.)code", false)
+  .AddOptionalArg("use_o_direct",
+      R"code(If set to true, files are opened with O_DIRECT, so reading them doesn't pollute the page cache.
+Useful for datasets larger than the RAM. Requires `dont_use_mmap`.)code", false)
   .AddOptionalArg("prefetch_queue_depth",
       R"code(Specifies the number of batches prefetched by the internal Loader. To be increased when pipeline
 processing is CPU stage-bound, trading memory consumption for better interleaving with the Loader thread.)code", 1)
+  .AddOptionalArg("prefetch_spin_count",
+      R"code(Number of times the prefetch thread and the consumer poll the prefetch queue before going
+to sleep when it is full or empty. Spinning lowers the batch handoff latency at the cost of CPU time.
+0 means that waiting threads go to sleep immediately.)code", 0)
+  .AddOptionalArg("num_prefetch_threads",
+      R"code(Number of threads used to read the samples of a prefetched batch in parallel. Samples are still
+selected sequentially, so their order for a given seed and shard does not depend on this value.
+Readers that do not support parallel reading ignore it.)code", 1)
   .AddOptionalArg("skip_cached_images",
       R"code(If set to true, loading data will be skipped when the sample is present in the decoder cache.
 In such case the output of the loader will be empty)code", false)
@@ -15,6 +15,7 @@
 #ifndef DALI_PIPELINE_OPERATORS_READER_LOADER_LOADER_H_
 #define DALI_PIPELINE_OPERATORS_READER_LOADER_LOADER_H_
 
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -30,6 +31,7 @@
 #include "dali/pipeline/operators/op_spec.h"
 #include "dali/pipeline/data/tensor.h"
 #include "dali/pipeline/operators/decoder/cache/image_cache_factory.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 namespace dali {
 
@@ -47,16 +49,21 @@ template <typename Backend, typename LoadTarget>
 class Loader {
  public:
   using LoadTargetPtr = std::unique_ptr<LoadTarget>;
+  // Deferred, thread-safe part of reading a sample, see ReadSampleDeferred
+  using ReadWork = std::function<void()>;
   explicit Loader(const OpSpec& options)
     : shuffle_(options.GetArgument<bool>("random_shuffle")),
       initial_buffer_fill_(shuffle_ ? options.GetArgument<int>("initial_fill") : 1),
       initial_empty_size_(2 * options.GetArgument<int>("prefetch_queue_depth")
                           * options.GetArgument<int>("batch_size")),
+      samples_in_flight_(SamplesInFlight(options)),
       tensor_init_bytes_(options.GetArgument<int>("tensor_init_bytes")),
       seed_(options.GetArgument<Index>("seed")),
       shard_id_(options.GetArgument<int>("shard_id")),
       num_shards_(options.GetArgument<int>("num_shards")),
       read_ahead_(options.GetArgument<bool>("read_ahead")),
+      dont_use_mmap_(options.GetArgument<bool>("dont_use_mmap")),
+      use_o_direct_(options.GetArgument<bool>("use_o_direct")),
       stick_to_shard_(options.GetArgument<bool>("stick_to_shard")),
       device_id_(options.GetArgument<int>("device_id")),
       skip_cached_images_(options.GetArgument<bool>("skip_cached_images")),
@@ -64,6 +71,7 @@ class Loader {
       loading_flag_(false) {
     DALI_ENFORCE(initial_empty_size_ > 0, "Batch size needs to be greater than 0");
     DALI_ENFORCE(num_shards_ > shard_id_, "num_shards needs to be greater than shard_id");
+    DALI_ENFORCE(!use_o_direct_ || dont_use_mmap_, "use_o_direct requires dont_use_mmap");
     // initialize a random distribution -- this will be
     // used to pick from our sample buffer
     dis = std::uniform_int_distribution<>(0, initial_buffer_fill_);
@@ -105,6 +113,97 @@ class Loader {
 
   // Get a random read sample
   LoadTargetPtr ReadOne() {
+    return ReadOneImpl(nullptr);
+  }
+
+  /**
+   * @brief Reads `n` samples and appends them to `batch`.
+   *
+   * The samples and their order are the same as for `n` consecutive ReadOne calls.
+   * If `thread_pool` is provided, only the sample selection is done sequentially,
+   * the reads returned by ReadSampleDeferred are executed in parallel on the pool.
+   */
+  void ReadBatch(std::vector<LoadTargetPtr> &batch, int n, ThreadPool *thread_pool) {
+    if (!thread_pool) {
+      for (int i = 0; i < n; ++i) {
+        batch.push_back(ReadOneImpl(nullptr));
+      }
+      return;
+    }
+    std::vector<ReadWork> pending_reads;
+    for (int i = 0; i < n; ++i) {
+      batch.push_back(ReadOneImpl(&pending_reads));
+    }
+    TimeRange tr("[Loader] Parallel reads", TimeRange::kGreen1);
+    // The reads target tensors that are owned either by `batch` or by the sample buffer,
+    // so all of them stay valid until the pool is done
+    thread_pool->DoWorkRange(0, pending_reads.size(), [&pending_reads](int64_t i, int) {
+      pending_reads[i]();
+    });
+    thread_pool->WaitForWork();
+  }
+
+  // Drops the buffers of a recycled target that are still referenced elsewhere,
+  // e.g. shared with the reader outputs by the parser, so that they are not overwritten
+  virtual void DetachBuffers(LoadTarget& tensor) {
+    DetachTensorBuffer(tensor);
+  }
+
+  template <typename T>
+  std::enable_if_t<std::is_same<T, Tensor<CPUBackend>>::value>
+  DetachTensorBuffer(T& tensor) {
+    if (!tensor.shares_data() && tensor.get_data_ptr().use_count() > 1)
+      tensor.Reset();
+  }
+
+  template <typename T>
+  std::enable_if_t<!std::is_same<T, Tensor<CPUBackend>>::value>
+  DetachTensorBuffer(T&) {}
+
+  // return a tensor to the empty pile
+  // called by multiple consumer threads
+  void RecycleTensor(LoadTargetPtr&& tensor_ptr) {
+    DetachBuffers(*tensor_ptr);
+    std::lock_guard<std::mutex> lock(empty_tensors_mutex_);
+    empty_tensors_.push_back(std::move(tensor_ptr));
+  }
+
+  // Read an actual sample from the FileStore,
+  // used to populate the sample buffer for "shuffled"
+  // reads.
+  virtual void ReadSample(LoadTarget& tensor) = 0;
+
+  /**
+   * @brief Performs the sequential part of ReadSample - picking the next sample and advancing
+   *        the internal cursor - and returns the rest of the work (typically the I/O),
+   *        which can be run concurrently with other reads.
+   *
+   * The returned work must only touch `tensor` and immutable loader state.
+   * Loaders that don't support parallel reading read synchronously and return an empty work.
+   */
+  virtual ReadWork ReadSampleDeferred(LoadTarget& tensor) {
+    ReadSample(tensor);
+    return {};
+  }
+
+  void PrepareMetadata() {
+    std::lock_guard<std::mutex> l(prepare_metadata_mutex_);
+    if (!loading_flag_) {
+      loading_flag_ = true;
+      PrepareMetadataImpl();
+    }
+  }
+
+  // Give the size of the data accessed through the Loader
+  Index Size() {
+    if (!loading_flag_) {
+      PrepareMetadata();
+    }
+    return SizeImpl();
+  }
+
+ protected:
+  LoadTargetPtr ReadOneImpl(std::vector<ReadWork> *pending_reads) {
     if (!loading_flag_) {
       PrepareMetadata();
     }
@@ -118,7 +217,7 @@ class Loader {
       for (int i = 0; i < initial_buffer_fill_; ++i) {
         auto tensor_ptr = LoadTargetPtr(new LoadTarget());
         PrepareEmpty(*tensor_ptr);
-        ReadSample(*tensor_ptr);
+        ReadSampleInto(*tensor_ptr, pending_reads);
         sample_buffer_.push_back(std::move(tensor_ptr));
       }
 
@@ -152,41 +251,22 @@ class Loader {
       tensor_ptr = std::move(empty_tensors_.back());
       empty_tensors_.pop_back();
     }
-    ReadSample(*tensor_ptr);
+    ReadSampleInto(*tensor_ptr, pending_reads);
     sample_buffer_.push_back(std::move(tensor_ptr));
 
     return sample_ptr;
   }
 
-  // return a tensor to the empty pile
-  // called by multiple consumer threads
-  void RecycleTensor(LoadTargetPtr&& tensor_ptr) {
-    std::lock_guard<std::mutex> lock(empty_tensors_mutex_);
-    empty_tensors_.push_back(std::move(tensor_ptr));
-  }
-
-  // Read an actual sample from the FileStore,
-  // used to populate the sample buffer for "shuffled"
-  // reads.
-  virtual void ReadSample(LoadTarget& tensor) = 0;
-
-  void PrepareMetadata() {
-    std::lock_guard<std::mutex> l(prepare_metadata_mutex_);
-    if (!loading_flag_) {
-      loading_flag_ = true;
-      PrepareMetadataImpl();
-    }
-  }
-
-  // Give the size of the data accessed through the Loader
-  Index Size() {
-    if (!loading_flag_) {
-      PrepareMetadata();
+  void ReadSampleInto(LoadTarget &tensor, std::vector<ReadWork> *pending_reads) {
+    if (!pending_reads) {
+      ReadSample(tensor);
+      return;
     }
-    return SizeImpl();
+    auto read = ReadSampleDeferred(tensor);
+    if (read)
+      pending_reads->push_back(std::move(read));
   }
 
- protected:
   virtual Index SizeImpl() = 0;
 
   virtual void PrepareMetadataImpl() {}
@@ -221,6 +301,19 @@ class Loader {
     return cache_ && cache_->IsCached(key);
   }
 
+  /**
+   * @brief Upper bound of the number of samples alive outside of the sample buffer: in the
+   *        batches prefetched by the reader, the one being parsed, and in the reader outputs
+   *        kept by the executor, which may reference the loader data without copying it
+   *        (see ShareOrCopyBytes)
+   */
+  static int SamplesInFlight(const OpSpec &options) {
+    int cpu_queue_depth = options.HasArgument("cpu_prefetch_queue_depth")
+                          ? options.GetArgument<int>("cpu_prefetch_queue_depth") : 1;
+    return options.GetArgument<int>("batch_size")
+           * (options.GetArgument<int>("prefetch_queue_depth") + 1 + cpu_queue_depth);
+  }
+
   std::vector<LoadTargetPtr> sample_buffer_;
 
   std::vector<LoadTargetPtr> empty_tensors_;
@@ -230,6 +323,9 @@ class Loader {
   bool shuffle_;
   const int initial_buffer_fill_;
   const int initial_empty_size_;
+  // upper bound of the samples taken out of the sample buffer and not yet dropped by
+  // the pipeline - see SamplesInFlight
+  const int samples_in_flight_;
   const int tensor_init_bytes_;
   bool initial_buffer_filled_ = false;
 
@@ -249,6 +345,10 @@ class Loader {
   bool copy_read_data_;
   // if accessed files should be loaded into memory in advance at the first access
   bool read_ahead_;
+  // if files should be read with pread instead of being memory-mapped
+  bool dont_use_mmap_;
+  // if pread should bypass the page cache
+  bool use_o_direct_;
   // if reader for the given GPU should read over and over the same shard or should go through
   // whole data set
   bool stick_to_shard_;
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/pipeline/data/backend.h"
@@ -23,6 +25,8 @@
 #include "dali/pipeline/operators/reader/loader/loader.h"
 #include "dali/pipeline/operators/reader/loader/file_loader.h"
 #include "dali/pipeline/operators/reader/loader/lmdb.h"
+#include "dali/pipeline/operators/reader/parser/parser.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 namespace dali {
 
@@ -76,6 +80,66 @@ TYPED_TEST(DataLoadStoreTest, LoaderTest) {
   return;
 }
 
+TYPED_TEST(DataLoadStoreTest, LoaderParallelReadTest) {
+  auto spec = OpSpec("FileReader")
+                  .AddArg("file_root", loader_test_image_folder)
+                  .AddArg("batch_size", 8)
+                  .AddArg("random_shuffle", true)
+                  .AddArg("initial_fill", 16)
+                  .AddArg("seed", static_cast<int64_t>(123))
+                  .AddArg("device_id", 0);
+  FileLoader serial(spec), parallel(spec);
+  serial.PrepareMetadata();
+  parallel.PrepareMetadata();
+  ThreadPool thread_pool(4, -1, false);
+
+  for (int iter = 0; iter < 5; ++iter) {
+    std::vector<FileLoader::LoadTargetPtr> batch;
+    parallel.ReadBatch(batch, 8, &thread_pool);
+    ASSERT_EQ(batch.size(), 8u);
+    for (auto &sample : batch) {
+      auto expected = serial.ReadOne();
+      EXPECT_EQ(sample->image.GetSourceInfo(), expected->image.GetSourceInfo());
+      EXPECT_EQ(sample->label, expected->label);
+      ASSERT_EQ(sample->image.size(), expected->image.size());
+      EXPECT_EQ(0, std::memcmp(sample->image.raw_data(), expected->image.raw_data(),
+                               sample->image.size()));
+      serial.RecycleTensor(std::move(expected));
+      parallel.RecycleTensor(std::move(sample));
+    }
+  }
+}
+
+TYPED_TEST(DataLoadStoreTest, RecycledSampleKeepsSharedOutput) {
+  // the images are read into loader-owned buffers, which the outputs may reference;
+  // the buffers fit any of the images, so a recycled one would be filled in place
+  FileLoader reader(OpSpec("FileReader")
+                    .AddArg("file_root", loader_test_image_folder)
+                    .AddArg("batch_size", 1)
+                    .AddArg("dont_use_mmap", true)
+                    .AddArg("tensor_init_bytes", 16 << 20)
+                    .AddArg("device_id", 0));
+  reader.PrepareMetadata();
+
+  auto sample = reader.ReadOne();
+  Tensor<CPUBackend> output;
+  output.set_pinned(false);
+  ShareOrCopyBytes(output, sample->image, 0, sample->image.size());
+  ASSERT_TRUE(output.shares_data());
+  std::vector<uint8_t> expected(output.data<uint8_t>(),
+                                output.data<uint8_t>() + output.size());
+
+  // the recycled tensor is the next one to be filled - it must not overwrite the output
+  reader.RecycleTensor(std::move(sample));
+  for (int i = 0; i < 3; ++i) {
+    auto next = reader.ReadOne();
+    EXPECT_NE(next->image.raw_data(), output.raw_data());
+    reader.RecycleTensor(std::move(next));
+  }
+  ASSERT_EQ(static_cast<size_t>(output.size()), expected.size());
+  EXPECT_EQ(0, std::memcmp(output.raw_data(), expected.data(), expected.size()));
+}
+
 TYPED_TEST(DataLoadStoreTest, LoaderTestFail) {
   shared_ptr<dali::FileLoader> reader(
       new FileLoader(OpSpec("FileReader")
@@ -34,10 +34,15 @@ class RecordIOLoader : public IndexedFileLoader {
   ~RecordIOLoader() override {}
 
   void ReadIndexFile(const std::vector<std::string>& index_uris) override {
+    // Binary indices describe every RecordIO file separately
+    if (!index_uris.empty() && SampleIndex::IsBinaryIndexFile(index_uris[0])) {
+      IndexedFileLoader::ReadIndexFile(index_uris);
+      return;
+    }
     std::vector<size_t> file_offsets;
     file_offsets.push_back(0);
     for (std::string& path : uris_) {
-      auto tmp = FileStream::Open(path, read_ahead_);
+      auto tmp = FileStream::Open(path, read_ahead_, !dont_use_mmap_, use_o_direct_);
       file_offsets.push_back(tmp->Size() + file_offsets.back());
       tmp->Close();
     }
@@ -61,26 +66,33 @@ class RecordIOLoader : public IndexedFileLoader {
       int64 size = temp[i + 1] - temp[i];
       // skip 0 sized images
       if (size) {
-        indices_.push_back(std::make_tuple(temp[i] - file_offsets[file_offset_index],
-                                          size, file_offset_index));
+        indices_.push_back(temp[i] - file_offsets[file_offset_index],
+                           size, file_offset_index);
       }
     }
     int64 size = file_offsets.back() - temp.back();
     // skip 0 sized images
     if (size) {
-      indices_.push_back(std::make_tuple(temp.back() - file_offsets[file_offset_index],
-                                        size, file_offset_index));
+      indices_.push_back(temp.back() - file_offsets[file_offset_index],
+                         size, file_offset_index);
     }
     index_file.close();
   }
 
   void ReadSample(Tensor<CPUBackend>& tensor) override {
+    auto read = ReadSampleDeferred(tensor);
+    if (read)
+      read();
+  }
+
+  ReadWork ReadSampleDeferred(Tensor<CPUBackend>& tensor) override {
     // if we moved to next shard wrap up
     MoveToNextShard(current_index_);
 
-    int64 seek_pos, size;
-    size_t file_index;
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    auto entry = indices_[current_index_];
+    int64 seek_pos = entry.offset;
+    int64 size = entry.size;
+    size_t file_index = entry.file_index;
 
     ++current_index_;
 
@@ -92,60 +104,41 @@ class RecordIOLoader : public IndexedFileLoader {
     // if image is cached, skip loading
     if (ShouldSkipImage(image_key)) {
       meta.SetSkipSample(true);
-      should_seek_ = true;
       tensor.Reset();
       tensor.SetMeta(meta);
       tensor.set_type(TypeInfo::Create<uint8_t>());
       tensor.Resize({0});
-      return;
-    }
-
-    if (should_seek_) {
-      current_file_->Seek(seek_pos);
-      should_seek_ = false;
+      return {};
     }
 
-    shared_ptr<void> p = nullptr;
-    int64 n_read = 0;
-    bool use_read = copy_read_data_;
-    if (use_read) {
-      tensor.Resize({size});
-    }
-    while (p == nullptr && n_read < size) {
-      if (!use_read) {
-        p = current_file_->Get(size);
-        // file is divided between two files, we need to fallback to read here
-        if (p == nullptr) {
-          if (tensor.shares_data()) {
-            tensor.Reset();
-          }
-          tensor.Resize({size});
-          tensor.set_type(TypeInfo::Create<uint8_t>());
-          use_read = true;
-        } else {
-          n_read = size;
-          // Wrap the raw data in the Tensor object.
-          tensor.ShareData(p, size, {size});
-          tensor.set_type(TypeInfo::Create<uint8_t>());
+    std::shared_ptr<FileStream> file = OpenFile(file_index);
+    return [this, &tensor, file, seek_pos, size, file_index, meta]() {
+      shared_ptr<void> p = copy_read_data_ ? nullptr : file->GetAt(size, seek_pos);
+      if (p != nullptr) {
+        // Wrap the raw data in the Tensor object.
+        tensor.ShareData(p, size, {size});
+        tensor.set_type(TypeInfo::Create<uint8_t>());
+      } else {
+        // record is copied or divided between two files
+        if (tensor.shares_data()) {
+          tensor.Reset();
+        }
+        tensor.set_type(TypeInfo::Create<uint8_t>());
+        tensor.Resize({size});
+        int64 n_read = file->ReadAt(tensor.mutable_data<uint8_t>(), size, seek_pos);
+        size_t next_file_index = file_index;
+        while (n_read < size) {
+          DALI_ENFORCE(next_file_index + 1 < uris_.size(),
+            "Incomplete or corrupted record files");
+          auto next_file = FileStream::Open(uris_[++next_file_index],
+                                            read_ahead_, !dont_use_mmap_, use_o_direct_);
+          n_read += next_file->Read(tensor.mutable_data<uint8_t>() + n_read, size - n_read);
+          next_file->Close();
         }
       }
-      if (use_read) {
-        n_read += current_file_->Read(tensor.mutable_data<uint8_t>() + n_read,
-                                      size - n_read);
-      }
-      if (p == nullptr && n_read < size) {
-        DALI_ENFORCE(current_file_index_ + 1 < uris_.size(),
-          "Incomplete or corrupted record files");
-        // Release previously opened file
-        current_file_ = FileStream::Open(uris_[++current_file_index_], read_ahead_);
-        continue;
-      }
-    }
-    tensor.SetMeta(meta);
+      tensor.SetMeta(meta);
+    };
   }
-
- private:
-  bool should_seek_ = false;
 };
 
 }  // namespace dali
@@ -0,0 +1,111 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "dali/pipeline/operators/reader/loader/sample_index.h"
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+bool SampleIndex::IsBinaryIndexFile(const std::string &path) {
+  std::ifstream f(path, std::ios::binary);
+  DALI_ENFORCE(f.good(), "Failed to open file " + path);
+  char magic[sizeof(kBinaryIndexMagic)] = {0, };
+  f.read(magic, sizeof(magic));
+  return f.gcount() == sizeof(magic) && std::memcmp(magic, kBinaryIndexMagic, sizeof(magic)) == 0;
+}
+
+void SampleIndex::push_back(int64 offset, int64 size, size_t file_index) {
+  if (segments_.empty() || segments_.back().mapping ||
+      segments_.back().file_index != file_index) {
+    segments_.emplace_back();
+    segments_.back().first = size_;
+    segments_.back().file_index = file_index;
+  }
+  auto &segment = segments_.back();
+  segment.owned_offsets.push_back(offset);
+  segment.owned_sizes.push_back(size);
+  segment.count++;
+  size_++;
+}
+
+void SampleIndex::AddBinaryIndexFile(const std::string &path, size_t file_index) {
+  int fd = open(path.c_str(), O_RDONLY);
+  DALI_ENFORCE(fd >= 0, "Failed to open file " + path + ": " + std::strerror(errno));
+  struct stat s;
+  if (fstat(fd, &s) < 0) {
+    close(fd);
+    DALI_FAIL("Failed to stat file " + path + ": " + std::strerror(errno));
+  }
+  size_t length = static_cast<size_t>(s.st_size);
+  if (length < sizeof(BinaryIndexHeader)) {
+    close(fd);
+    DALI_FAIL("Binary index file " + path + " is truncated");
+  }
+  // MAP_SHARED, so that the page cache is shared by all the processes reading the same index
+  void *p = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  DALI_ENFORCE(p != MAP_FAILED, "Failed to map file " + path + ": " + std::strerror(errno));
+  std::shared_ptr<void> mapping(p, [length](void *p) { munmap(p, length); });
+
+  const auto *header = static_cast<const BinaryIndexHeader *>(p);
+  DALI_ENFORCE(std::memcmp(header->magic, kBinaryIndexMagic, sizeof(kBinaryIndexMagic)) == 0,
+    "File " + path + " is not a binary index file");
+  DALI_ENFORCE(header->version == kBinaryIndexVersion,
+    "Unsupported binary index version " + to_string(header->version) + " in " + path);
+  DALI_ENFORCE(length == sizeof(BinaryIndexHeader) + 2 * header->count * sizeof(int64),
+    "Binary index file " + path + " is truncated or corrupted");
+
+  if (header->count == 0)
+    return;
+
+  segments_.emplace_back();
+  auto &segment = segments_.back();
+  segment.first = size_;
+  segment.count = header->count;
+  segment.file_index = file_index;
+  segment.offsets = reinterpret_cast<const int64 *>(header + 1);
+  segment.sizes = segment.offsets + header->count;
+  segment.mapping = std::move(mapping);
+  size_ += header->count;
+}
+
+const SampleIndex::Segment &SampleIndex::FindSegment(size_t idx) const {
+  DALI_ENFORCE(idx < size_, "Index entry out of range");
+  // segments are sorted by `first`; find the last one that starts at or before idx
+  auto it = std::upper_bound(segments_.begin(), segments_.end(), idx,
+                             [](size_t i, const Segment &s) { return i < s.first; });
+  return *(it - 1);
+}
+
+IndexEntry SampleIndex::operator[](size_t idx) const {
+  const auto &segment = FindSegment(idx);
+  size_t i = idx - segment.first;
+  if (segment.mapping) {
+    return { segment.offsets[i], segment.sizes[i], segment.file_index };
+  } else {
+    return { segment.owned_offsets[i], segment.owned_sizes[i], segment.file_index };
+  }
+}
+
+}  // namespace dali
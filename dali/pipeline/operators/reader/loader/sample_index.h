@@ -0,0 +1,108 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATORS_READER_LOADER_SAMPLE_INDEX_H_
+#define DALI_PIPELINE_OPERATORS_READER_LOADER_SAMPLE_INDEX_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+
+namespace dali {
+
+/**
+ * @brief Layout of the binary index file.
+ *
+ * The header is followed by `count` int64 offsets and then by `count` int64 sizes
+ * of the records in a single data file. All values are little-endian.
+ * Text index files can be converted with the `idx2bin` script distributed with DALI.
+ */
+struct BinaryIndexHeader {
+  char magic[8];
+  uint64_t version;
+  uint64_t count;
+};
+
+static constexpr char kBinaryIndexMagic[8] = {'D', 'A', 'L', 'I', 'I', 'D', 'X', '\0'};
+static constexpr uint64_t kBinaryIndexVersion = 1;
+
+/**
+ * @brief Position of a record inside one of the data files
+ */
+struct IndexEntry {
+  int64 offset;
+  int64 size;
+  size_t file_index;
+};
+
+/**
+ * @brief Record index of IndexedFileLoader, stored as structure of arrays.
+ *
+ * Entries parsed from text index files are kept in memory, binary index files
+ * are memory-mapped read-only and used in place, so the pages are shared
+ * between all processes reading the same dataset.
+ */
+class DLL_PUBLIC SampleIndex {
+ public:
+  /**
+   * @brief Checks if the file at `path` is a binary index
+   */
+  DLL_PUBLIC static bool IsBinaryIndexFile(const std::string &path);
+
+  /**
+   * @brief Appends a single entry kept in memory
+   */
+  DLL_PUBLIC void push_back(int64 offset, int64 size, size_t file_index);
+
+  /**
+   * @brief Maps the binary index file at `path`, describing records of the data file `file_index`
+   */
+  DLL_PUBLIC void AddBinaryIndexFile(const std::string &path, size_t file_index);
+
+  DLL_PUBLIC IndexEntry operator[](size_t idx) const;
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+ private:
+  // Consecutive entries that belong to the same data file
+  struct Segment {
+    size_t first = 0;
+    size_t count = 0;
+    size_t file_index = 0;
+    // either mapped...
+    std::shared_ptr<void> mapping;
+    const int64 *offsets = nullptr;
+    const int64 *sizes = nullptr;
+    // ...or owned
+    std::vector<int64> owned_offsets;
+    std::vector<int64> owned_sizes;
+  };
+
+  const Segment &FindSegment(size_t idx) const;
+
+  std::vector<Segment> segments_;
+  size_t size_ = 0;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_READER_LOADER_SAMPLE_INDEX_H_
@@ -0,0 +1,93 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/loader/sample_index.h"
+
+namespace dali {
+
+namespace {
+
+std::string TempFileName() {
+  char name[] = "/tmp/dali_index_test_XXXXXX";
+  int fd = mkstemp(name);
+  if (fd >= 0)
+    close(fd);
+  return name;
+}
+
+void WriteBinaryIndex(const std::string &path, const std::vector<int64> &offsets,
+                      const std::vector<int64> &sizes) {
+  BinaryIndexHeader header;
+  std::memcpy(header.magic, kBinaryIndexMagic, sizeof(header.magic));
+  header.version = kBinaryIndexVersion;
+  header.count = offsets.size();
+  std::ofstream f(path, std::ios::binary);
+  f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  f.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(int64));
+  f.write(reinterpret_cast<const char*>(sizes.data()), sizes.size() * sizeof(int64));
+}
+
+}  // namespace
+
+TEST(SampleIndexTest, MixedTextAndBinary) {
+  std::string binary = TempFileName();
+  std::string text = TempFileName();
+  WriteBinaryIndex(binary, {0, 100, 250}, {100, 150, 20});
+  {
+    std::ofstream f(text);
+    f << "0 10\n10 20\n";
+  }
+  EXPECT_TRUE(SampleIndex::IsBinaryIndexFile(binary));
+  EXPECT_FALSE(SampleIndex::IsBinaryIndexFile(text));
+
+  SampleIndex index;
+  index.push_back(0, 10, 0);
+  index.push_back(10, 20, 0);
+  index.AddBinaryIndexFile(binary, 1);
+  index.push_back(5, 7, 2);
+  ASSERT_EQ(index.size(), 6u);
+
+  std::vector<IndexEntry> expected = {
+    {0, 10, 0}, {10, 20, 0}, {0, 100, 1}, {100, 150, 1}, {250, 20, 1}, {5, 7, 2}
+  };
+  for (size_t i = 0; i < expected.size(); i++) {
+    auto entry = index[i];
+    EXPECT_EQ(entry.offset, expected[i].offset);
+    EXPECT_EQ(entry.size, expected[i].size);
+    EXPECT_EQ(entry.file_index, expected[i].file_index);
+  }
+  EXPECT_THROW(index[6], std::runtime_error);
+
+  std::remove(binary.c_str());
+  std::remove(text.c_str());
+}
+
+TEST(SampleIndexTest, TruncatedBinary) {
+  std::string binary = TempFileName();
+  WriteBinaryIndex(binary, {0, 100}, {100});
+  SampleIndex index;
+  EXPECT_THROW(index.AddBinaryIndexFile(binary, 0), std::runtime_error);
+  std::remove(binary.c_str());
+}
+
+}  // namespace dali
@@ -108,7 +108,7 @@ class SequenceLoader : public Loader<CPUBackend, TensorSequence> {
     DALI_ENFORCE(stride_ > 0, "Stride must be positive");
     mmap_reserver = FileStream::FileStreamMappinReserver(
         static_cast<unsigned int>(initial_buffer_fill_) * sequence_length_);
-    copy_read_data_ = !mmap_reserver.CanShareMappedData();
+    copy_read_data_ = dont_use_mmap_ || !mmap_reserver.CanShareMappedData();
     if (shuffle_) {
       // TODO(spanev) decide of a policy for multi-gpu here
       // seeded with hardcoded value to get
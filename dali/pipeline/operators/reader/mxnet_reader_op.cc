@@ -30,7 +30,9 @@ DALI_SCHEMA(MXNetReader)
       R"code(List (of length 1) containing a path to index (.idx) file.
 It is generated by the MXNet's `im2rec.py` script
 together with RecordIO file. It can also be
-generated using `rec2idx` script distributed with DALI.)code",
+generated using `rec2idx` script distributed with DALI.
+Alternatively, a list of binary index files (1 for every RecordIO file) created
+with `idx2bin --recordio` can be given, which are memory-mapped instead of parsed.)code",
       DALI_STRING_VEC)
   .AddParent("LoaderBase");
 
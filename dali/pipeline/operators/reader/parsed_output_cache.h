@@ -0,0 +1,112 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATORS_READER_PARSED_OUTPUT_CACHE_H_
+#define DALI_PIPELINE_OPERATORS_READER_PARSED_OUTPUT_CACHE_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/data/tensor.h"
+
+namespace dali {
+
+/**
+ * @brief Outputs of the parsed samples of a reader, keyed by the source info
+ *
+ * With `skip_cached_images`, the loader skips the samples whose images are cached
+ * by the decoder, and the reader returns the outputs stored here instead of parsing them.
+ *
+ * The entries are split into shards, each with its own lock, so that the threads parsing
+ * a batch rarely contend. The stored outputs are immutable and the locks are only held
+ * to look them up - copying happens outside.
+ */
+class ParsedOutputCache {
+ public:
+  using Outputs = std::vector<Tensor<CPUBackend>>;
+
+  explicit ParsedOutputCache(int num_shards = 64) : shards_(num_shards) {
+    DALI_ENFORCE(num_shards > 0, "The number of shards must be positive.");
+  }
+
+  /**
+   * @brief Returns the outputs stored for `key`, or null
+   */
+  std::shared_ptr<const Outputs> Get(const std::string &key) const {
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    return it != shard.entries.end() ? it->second : nullptr;
+  }
+
+  bool Contains(const std::string &key) const {
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.entries.count(key) > 0;
+  }
+
+  /**
+   * @brief Stores `outputs` for `key`, unless some were stored already
+   *
+   * @return false, if the key was already present
+   */
+  bool Add(const std::string &key, Outputs &&outputs) {
+    auto entry = std::make_shared<const Outputs>(std::move(outputs));
+    auto &shard = GetShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.entries.emplace(key, std::move(entry)).second;
+  }
+
+  size_t size() const {
+    size_t n = 0;
+    for (auto &shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      n += shard.entries.size();
+    }
+    return n;
+  }
+
+  void Clear() {
+    for (auto &shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.entries.clear();
+    }
+  }
+
+ private:
+  struct Shard {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const Outputs>> entries;
+  };
+
+  const Shard &GetShard(const std::string &key) const {
+    return shards_[std::hash<std::string>()(key) % shards_.size()];
+  }
+
+  Shard &GetShard(const std::string &key) {
+    return shards_[std::hash<std::string>()(key) % shards_.size()];
+  }
+
+  std::vector<Shard> shards_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_READER_PARSED_OUTPUT_CACHE_H_
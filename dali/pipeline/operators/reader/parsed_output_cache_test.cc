@@ -0,0 +1,88 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/parsed_output_cache.h"
+
+namespace dali {
+
+namespace {
+
+ParsedOutputCache::Outputs MakeOutputs(int label) {
+  ParsedOutputCache::Outputs outputs(2);
+  outputs[0].set_pinned(false);
+  outputs[0].Resize({1});
+  outputs[0].mutable_data<uint8_t>()[0] = 0;
+  outputs[1].set_pinned(false);
+  outputs[1].Resize({1});
+  outputs[1].mutable_data<int>()[0] = label;
+  return outputs;
+}
+
+}  // namespace
+
+TEST(ParsedOutputCacheTest, AddAndGet) {
+  ParsedOutputCache cache(4);
+  EXPECT_EQ(cache.Get("a.jpg"), nullptr);
+  EXPECT_FALSE(cache.Contains("a.jpg"));
+
+  EXPECT_TRUE(cache.Add("a.jpg", MakeOutputs(1)));
+  EXPECT_TRUE(cache.Add("b.jpg", MakeOutputs(2)));
+  // the outputs stored first are kept
+  EXPECT_FALSE(cache.Add("a.jpg", MakeOutputs(3)));
+  EXPECT_EQ(cache.size(), 2u);
+
+  auto a = cache.Get("a.jpg");
+  ASSERT_NE(a, nullptr);
+  ASSERT_EQ(a->size(), 2u);
+  EXPECT_EQ((*a)[1].data<int>()[0], 1);
+  EXPECT_EQ((*cache.Get("b.jpg"))[1].data<int>()[0], 2);
+
+  // the entries returned stay valid after clearing
+  cache.Clear();
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_FALSE(cache.Contains("a.jpg"));
+  EXPECT_EQ((*a)[1].data<int>()[0], 1);
+}
+
+TEST(ParsedOutputCacheTest, Concurrent) {
+  ParsedOutputCache cache;
+  const int kThreads = 8, kKeys = 500;
+  std::atomic<int> added{0}, mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < kKeys; i++) {
+        auto key = "sample_" + std::to_string(i);
+        if (!cache.Contains(key) && cache.Add(key, MakeOutputs(i)))
+          added++;
+        auto outputs = cache.Get(key);
+        if (!outputs || (*outputs)[1].data<int>()[0] != i)
+          mismatches++;
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  EXPECT_EQ(added, kKeys);
+  EXPECT_EQ(mismatches, 0);
+  EXPECT_EQ(cache.size(), static_cast<size_t>(kKeys));
+}
+
+}  // namespace dali
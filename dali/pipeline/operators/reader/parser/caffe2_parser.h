@@ -181,8 +181,8 @@ class Caffe2Parser : public Parser<Tensor<CPUBackend>> {
       num_labels_(spec.GetArgument<int>("num_labels")) {}
 
   void Parse(const Tensor<CPUBackend>& data, SampleWorkspace* ws) override {
-    caffe2::TensorProtos protos;
-
+    // Reused between the samples - see CaffeParser
+    caffe2::TensorProtos& protos = protos_[ws->thread_idx()];
     DALI_ENFORCE(protos.ParseFromArray(data.data<uint8_t>(), data.size()));
 
     auto& image = ws->Output<CPUBackend>(0);
@@ -257,7 +257,12 @@ class Caffe2Parser : public Parser<Tensor<CPUBackend>> {
     }
   }
 
+  void PrepareThreads(int num_threads) override {
+    protos_.Resize(num_threads);
+  }
+
  private:
+  PerThreadScratch<caffe2::TensorProtos> protos_;
   // Necessary for accounting purposes?
   int additional_inputs_;
   // Necessary for accounting purposes.
@@ -26,8 +26,9 @@ class CaffeParser : public Parser<Tensor<CPUBackend>> {
     Parser(spec) {}
 
   void Parse(const Tensor<CPUBackend>& data, SampleWorkspace* ws) override {
-    caffe::Datum datum;
-    // DALI_ENFORCE(datum.ParseFromString(string(reinterpret_cast<const char*>(data), size)));
+    // ParseFromArray clears the message first, which keeps the buffers of its fields,
+    // so after the first few samples the data is parsed without allocating
+    caffe::Datum& datum = datums_[ws->thread_idx()];
     DALI_ENFORCE(datum.ParseFromArray(data.raw_data(), data.size()));
 
     auto& image = ws->Output<CPUBackend>(0);
@@ -43,6 +44,13 @@ class CaffeParser : public Parser<Tensor<CPUBackend>> {
                 datum.data().size()*sizeof(uint8_t));
     image.SetSourceInfo(data.GetSourceInfo());
   }
+
+  void PrepareThreads(int num_threads) override {
+    datums_.Resize(num_threads);
+  }
+
+ private:
+  PerThreadScratch<caffe::Datum> datums_;
 };
 
 };  // namespace dali
@@ -15,38 +15,124 @@
 #ifndef DALI_PIPELINE_OPERATORS_READER_PARSER_COCO_PARSER_H_
 #define DALI_PIPELINE_OPERATORS_READER_PARSER_COCO_PARSER_H_
 
-#include <map>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <array>
+#include <utility>
+#include <vector>
 
 #include "dali/pipeline/operators/reader/parser/parser.h"
 
 namespace dali {
 
-struct Annotation {
-  /*
-   * Currently, only bboxes and labels are supported,
-   * while key points and segmentation masks need to be handled
-   * somehow in the future
+/**
+ * @brief Bounding boxes and labels of a COCO dataset, in a compressed sparse row layout
+ *
+ * Images are indexed densely, in the order in which they appear in the annotation files.
+ * The objects of the image `idx` occupy the range [offsets[idx], offsets[idx + 1]) of the
+ * bbox (4 floats per object) and label arrays.
+ *
+ * The arrays are either owned or reference memory kept alive by an owner - e.g. a
+ * memory-mapped file with preprocessed annotations.
+ */
+class CocoAnnotations {
+ public:
+  static constexpr int kBboxSize = 4;
+
+  CocoAnnotations() = default;
+
+  /**
+   * @param offsets      num_images + 1 offsets into `boxes` (in boxes) and `labels`
+   * @param file_names   concatenated file names of the images
+   * @param name_offsets num_images + 1 offsets into `file_names`
    */
-  Annotation(float x, float y, float w, float h, int category_id)
-    : bbox({x, y, w, h}),
-      category_id(category_id) {}
-
-  // bbox contains 5 values: x, y, W, H, category_id
-  std::array<float, 4> bbox;
-  int category_id;
-  friend std::ostream& operator<<(std::ostream& os, Annotation& an);
-};
+  CocoAnnotations(std::vector<int64_t> offsets, std::vector<int> image_ids,
+                  std::vector<float> boxes, std::vector<int> labels,
+                  std::vector<int64_t> name_offsets, std::vector<char> file_names)
+  : offsets_data_(std::move(offsets)), image_ids_data_(std::move(image_ids)),
+    boxes_data_(std::move(boxes)), labels_data_(std::move(labels)),
+    name_offsets_data_(std::move(name_offsets)), file_names_data_(std::move(file_names)) {
+    num_images_ = static_cast<int64_t>(image_ids_data_.size());
+    offsets_ = offsets_data_.data();
+    image_ids_ = image_ids_data_.data();
+    boxes_ = boxes_data_.data();
+    labels_ = labels_data_.data();
+    name_offsets_ = name_offsets_data_.data();
+    file_names_ = file_names_data_.data();
+  }
+
+  /**
+   * @brief References arrays laid out as above, which are kept alive by `owner`
+   */
+  CocoAnnotations(std::shared_ptr<void> owner, int64_t num_images,
+                  const int64_t *offsets, const int *image_ids,
+                  const float *boxes, const int *labels,
+                  const int64_t *name_offsets, const char *file_names)
+  : owner_(std::move(owner)), num_images_(num_images),
+    offsets_(offsets), image_ids_(image_ids), boxes_(boxes), labels_(labels),
+    name_offsets_(name_offsets), file_names_(file_names) {}
+
+  // moving the vectors keeps their buffers, so the pointers stay valid
+  CocoAnnotations(CocoAnnotations &&) = default;
+  CocoAnnotations &operator=(CocoAnnotations &&) = default;
+  CocoAnnotations(const CocoAnnotations &) = delete;
+  CocoAnnotations &operator=(const CocoAnnotations &) = delete;
 
-using AnnotationMap = std::multimap<int, Annotation>;
+  int64_t num_images() const { return num_images_; }
+
+  int64_t num_objects() const { return num_images_ ? offsets_[num_images_] : 0; }
+
+  int64_t num_objects(int64_t idx) const { return offsets_[idx + 1] - offsets_[idx]; }
+
+  int image_id(int64_t idx) const { return image_ids_[idx]; }
+
+  std::string file_name(int64_t idx) const {
+    return std::string(file_names_ + name_offsets_[idx], file_names_ + name_offsets_[idx + 1]);
+  }
+
+  /// @brief `num_objects(idx)` boxes of the image `idx`, `kBboxSize` floats each
+  const float *boxes(int64_t idx) const { return boxes_ + kBboxSize * offsets_[idx]; }
+
+  const int *labels(int64_t idx) const { return labels_ + offsets_[idx]; }
+
+  const int64_t *offsets() const { return offsets_; }
+  const int *image_ids() const { return image_ids_; }
+  const float *boxes() const { return boxes_; }
+  const int *labels() const { return labels_; }
+  const int64_t *name_offsets() const { return name_offsets_; }
+  const char *file_names() const { return file_names_; }
+
+ private:
+  std::vector<int64_t> offsets_data_;
+  std::vector<int> image_ids_data_;
+  std::vector<float> boxes_data_;
+  std::vector<int> labels_data_;
+  std::vector<int64_t> name_offsets_data_;
+  std::vector<char> file_names_data_;
+  std::shared_ptr<void> owner_;
+
+  int64_t num_images_ = 0;
+  const int64_t *offsets_ = nullptr;
+  const int *image_ids_ = nullptr;
+  const float *boxes_ = nullptr;
+  const int *labels_ = nullptr;
+  const int64_t *name_offsets_ = nullptr;
+  const char *file_names_ = nullptr;
+};
 
+/**
+ * @brief Outputs the image and its annotations
+ *
+ * The label of the image is its index in `annotations`. If no annotations were loaded
+ * (the images come from a file list), the label is used as the image id and no objects
+ * are returned.
+ */
 class COCOParser: public Parser<ImageLabelWrapper> {
  public:
   explicit COCOParser(
-    const OpSpec& spec, AnnotationMap& annotations_multimap)
+    const OpSpec& spec, const CocoAnnotations& annotations)
     : Parser<ImageLabelWrapper>(spec),
-    annotations_multimap_(annotations_multimap),
+    annotations_(annotations),
     save_img_ids_(spec.GetArgument<bool>("save_img_ids")) {}
 
   void Parse(const ImageLabelWrapper& image_label, SampleWorkspace* ws) override {
@@ -54,14 +140,12 @@ class COCOParser: public Parser<ImageLabelWrapper> {
     auto &image_output = ws->Output<CPUBackend>(0);
     auto &bbox_output = ws->Output<CPUBackend>(1);
     auto &label_output = ws->Output<CPUBackend>(2);
-    int image_id = image_label.label;
+    int64_t image_idx = image_label.label;
+    bool annotated = image_idx >= 0 && image_idx < annotations_.num_images();
 
-    auto range = annotations_multimap_.equal_range(image_id);
-    auto n_bboxes = std::distance(range.first, range.second);
+    int64_t n_bboxes = annotated ? annotations_.num_objects(image_idx) : 0;
 
-    image_output.Resize({image_size});
-    image_output.mutable_data<uint8_t>();
-    bbox_output.Resize({n_bboxes, 4});
+    bbox_output.Resize({n_bboxes, CocoAnnotations::kBboxSize});
     bbox_output.mutable_data<float>();
     label_output.Resize({n_bboxes, 1});
     label_output.mutable_data<int>();
@@ -70,30 +154,24 @@ class COCOParser: public Parser<ImageLabelWrapper> {
     if (save_img_ids_) {
       auto &image_id_output = ws->Output<CPUBackend>(3);
       image_id_output.Resize({1});
-      image_id_output.mutable_data<int>();
-      std::memcpy(image_id_output.raw_mutable_data(),
-                &image_label.label,
-                sizeof(int));
+      image_id_output.mutable_data<int>()[0] =
+          annotated ? annotations_.image_id(image_idx) : image_label.label;
     }
 
-    std::memcpy(image_output.raw_mutable_data(),
-                image_label.image.raw_data(),
-                image_size);
+    ShareOrCopyBytes(image_output, image_label.image, 0, image_size);
     image_output.SetSourceInfo(image_label.image.GetSourceInfo());
 
-    int stride = 0;
-    for (auto it = range.first; it != range.second; ++it) {
-      const Annotation& an = it->second;
-      int i = std::distance(range.first, it);
-      std::memcpy(
-          bbox_output.mutable_data<float>() + an.bbox.size() * i,
-          an.bbox.data(),
-          an.bbox.size() * sizeof (float));
-      label_output.mutable_data<int>()[i] = an.category_id;
+    if (n_bboxes > 0) {
+      std::memcpy(bbox_output.mutable_data<float>(),
+                  annotations_.boxes(image_idx),
+                  n_bboxes * CocoAnnotations::kBboxSize * sizeof(float));
+      std::memcpy(label_output.mutable_data<int>(),
+                  annotations_.labels(image_idx),
+                  n_bboxes * sizeof(int));
     }
   }
 
-  AnnotationMap& annotations_multimap_;
+  const CocoAnnotations& annotations_;
   const bool save_img_ids_;
 };
 
@@ -15,10 +15,61 @@
 #ifndef DALI_PIPELINE_OPERATORS_READER_PARSER_PARSER_H_
 #define DALI_PIPELINE_OPERATORS_READER_PARSER_PARSER_H_
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include "dali/pipeline/workspace/sample_workspace.h"
 
 namespace dali {
 
+/**
+ * @brief Sets `output` to `size` bytes of `input` starting at `offset`, without copying them
+ *
+ * `output` keeps the memory of `input` alive - e.g. a file mapping, or a buffer the loader
+ * detaches before reusing the tensor (see Loader::RecycleTensor). Pinned outputs are still
+ * filled by copying, as they are meant for fast transfers to the GPU.
+ */
+inline void ShareOrCopyBytes(Tensor<CPUBackend> &output, const Tensor<CPUBackend> &input,
+                             int64_t offset, int64_t size) {
+  if (!output.is_pinned() && size > 0) {
+    auto &base = input.get_data_ptr();
+    std::shared_ptr<void> ptr(base, static_cast<uint8_t *>(base.get()) + offset);
+    output.ShareData(ptr, size, {size});
+    output.set_type(TypeInfo::Create<uint8_t>());
+  } else {
+    if (output.shares_data())
+      output.Reset();
+    output.Resize({size});
+    std::memcpy(output.mutable_data<uint8_t>(), input.data<uint8_t>() + offset, size);
+  }
+}
+
+/**
+ * @brief Scratch space of a parser, with a separate object for each thread parsing a batch
+ *
+ * Resized in Parser::PrepareThreads, before the batch is dispatched, and indexed with
+ * SampleWorkspace::thread_idx() while parsing, so that no locking is needed.
+ */
+template <typename T>
+class PerThreadScratch {
+ public:
+  void Resize(int num_threads) {
+    while (static_cast<int>(scratch_.size()) < num_threads)
+      scratch_.emplace_back(new T());
+  }
+
+  T &operator[](int thread_idx) {
+    DALI_ENFORCE(thread_idx >= 0 && thread_idx < static_cast<int>(scratch_.size()),
+      "No parser scratch for thread " + std::to_string(thread_idx) +
+      " - Parser::PrepareThreads should be called before parsing.");
+    return *scratch_[thread_idx];
+  }
+
+ private:
+  std::vector<std::unique_ptr<T>> scratch_;
+};
+
 /**
  * @brief Base class for parsing data returned from a Loader
  *
@@ -38,6 +89,14 @@ class Parser {
    * entry
    */
   virtual void Parse(const ParseTarget& data, SampleWorkspace* ws) = 0;
+
+  /**
+   * @brief Called before the samples of a batch are parsed concurrently
+   *
+   * Parse is then called with SampleWorkspace::thread_idx() below `num_threads`;
+   * parsers keeping per-thread scratch (see PerThreadScratch) allocate it here.
+   */
+  virtual void PrepareThreads(int num_threads) {}
 };
 
 }  // namespace dali
@@ -23,6 +23,7 @@
 #include "dali/test/dali_test.h"
 #include "dali/pipeline/workspace/sample_workspace.h"
 #include "dali/pipeline/operators/reader/parser/parser.h"
+#include "dali/pipeline/operators/reader/parser/recordio_parser.h"
 
 namespace dali {
 
@@ -85,5 +86,148 @@ TYPED_TEST(ParserTest, BasicTest) {
   parser.Parse(ia_wrapper, &ws);
 }
 
+namespace {
+
+const uint32_t kRecordIOMagic = 0xced7230a;
+
+void AppendRecordPart(std::vector<uint8_t> &record, uint32_t cflag,
+                      const std::vector<uint8_t> &payload) {
+  auto append = [&](const void *data, size_t size) {
+    auto *bytes = static_cast<const uint8_t *>(data);
+    record.insert(record.end(), bytes, bytes + size);
+  };
+  uint32_t magic = kRecordIOMagic;
+  uint32_t length_flag = (cflag << 29U) | static_cast<uint32_t>(payload.size());
+  append(&magic, sizeof(magic));
+  append(&length_flag, sizeof(length_flag));
+  append(payload.data(), payload.size());
+  record.resize((record.size() + 3) / 4 * 4, 0);
+}
+
+/**
+ * @brief Header, labels and image of an MXNet image record
+ *
+ * Like the MXNet writer does, the payload is split into parts at occurrences
+ * of the magic number, which are removed.
+ */
+std::vector<uint8_t> MakeRecord(const std::vector<float> &labels,
+                                const std::vector<uint8_t> &image) {
+  ImageRecordIOHeader hdr = {};
+  hdr.flag = labels.size();
+  hdr.label = 42;
+  std::vector<uint8_t> payload(sizeof(hdr));
+  memcpy(payload.data(), &hdr, sizeof(hdr));
+  auto *label_bytes = reinterpret_cast<const uint8_t *>(labels.data());
+  payload.insert(payload.end(), label_bytes, label_bytes + labels.size() * sizeof(float));
+  payload.insert(payload.end(), image.begin(), image.end());
+
+  std::vector<std::vector<uint8_t>> parts(1);
+  for (size_t i = 0; i < payload.size(); i++) {
+    if (i + 4 <= payload.size() && !memcmp(&payload[i], &kRecordIOMagic, 4)) {
+      parts.emplace_back();
+      i += 3;
+    } else {
+      parts.back().push_back(payload[i]);
+    }
+  }
+
+  std::vector<uint8_t> record;
+  for (size_t i = 0; i < parts.size(); i++) {
+    uint32_t cflag = parts.size() == 1 ? 0 : i == 0 ? 1 : i + 1 == parts.size() ? 3 : 2;
+    AppendRecordPart(record, cflag, parts[i]);
+  }
+  return record;
+}
+
+void InsertMagic(std::vector<uint8_t> &data, size_t offset) {
+  memcpy(&data[offset], &kRecordIOMagic, 4);
+}
+
+}  // namespace
+
+class RecordIOParserTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    workspace_.GetSample(&ws_, 0, 0);
+    image_out_ = std::make_shared<Tensor<CPUBackend>>();
+    label_out_ = std::make_shared<Tensor<CPUBackend>>();
+    image_out_->set_pinned(false);
+    label_out_->set_pinned(false);
+    ws_.AddOutput(image_out_);
+    ws_.AddOutput(label_out_);
+    for (int i = 0; i < 37; i++)
+      image_.push_back(i * 7);
+  }
+
+  void Parse(const std::vector<uint8_t> &record_data) {
+    record_.Reset();
+    record_.set_pinned(false);
+    record_.Resize({static_cast<Index>(record_data.size())});
+    memcpy(record_.mutable_data<uint8_t>(), record_data.data(), record_data.size());
+    RecordIOParser parser(OpSpec("temp"));
+    parser.Parse(record_, &ws_);
+  }
+
+  void CheckOutputs(const std::vector<float> &labels) {
+    ASSERT_EQ(image_out_->size(), static_cast<Index>(image_.size()));
+    EXPECT_EQ(std::vector<uint8_t>(image_out_->data<uint8_t>(),
+                                   image_out_->data<uint8_t>() + image_.size()), image_);
+    if (labels.empty()) {
+      ASSERT_EQ(label_out_->size(), 1);
+      EXPECT_EQ(label_out_->data<float>()[0], 42);
+    } else {
+      ASSERT_EQ(label_out_->size(), static_cast<Index>(labels.size()));
+      for (size_t i = 0; i < labels.size(); i++)
+        EXPECT_EQ(label_out_->data<float>()[i], labels[i]);
+    }
+  }
+
+  HostWorkspace workspace_;
+  SampleWorkspace ws_;
+  std::shared_ptr<Tensor<CPUBackend>> image_out_, label_out_;
+  Tensor<CPUBackend> record_;
+  std::vector<uint8_t> image_;
+};
+
+TEST_F(RecordIOParserTest, SinglePartIsShared) {
+  std::vector<float> labels = { 1, 2, 3 };
+  Parse(MakeRecord(labels, image_));
+  CheckOutputs(labels);
+  EXPECT_TRUE(image_out_->shares_data());
+  const uint8_t *begin = record_.data<uint8_t>();
+  EXPECT_GE(image_out_->data<uint8_t>(), begin);
+  EXPECT_LT(image_out_->data<uint8_t>(), begin + record_.size());
+
+  // the output keeps the buffer alive
+  EXPECT_GT(record_.get_data_ptr().use_count(), 1);
+}
+
+TEST_F(RecordIOParserTest, PinnedOutputIsCopied) {
+  image_out_.reset(new Tensor<CPUBackend>());
+  image_out_->set_pinned(true);
+  ws_.SetOutput(0, image_out_);
+  Parse(MakeRecord({}, image_));
+  CheckOutputs({});
+  EXPECT_FALSE(image_out_->shares_data());
+}
+
+TEST_F(RecordIOParserTest, MultiPart) {
+  float magic_label;
+  memcpy(&magic_label, &kRecordIOMagic, sizeof(float));
+  // splits inside the labels and in the image, with unaligned part lengths
+  std::vector<float> labels = { 5, magic_label };
+  InsertMagic(image_, 13);
+  InsertMagic(image_, 22);
+  auto record = MakeRecord(labels, image_);
+  Parse(record);
+  CheckOutputs(labels);
+  EXPECT_FALSE(image_out_->shares_data());
+
+  // an output shared before can be reused for a multi-part record
+  Parse(MakeRecord({}, std::vector<uint8_t>(image_.begin(), image_.begin() + 10)));
+  EXPECT_TRUE(image_out_->shares_data());
+  Parse(MakeRecord({}, image_));
+  CheckOutputs({});
+}
 
 }  // namespace dali
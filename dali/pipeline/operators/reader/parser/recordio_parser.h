@@ -15,6 +15,7 @@
 #ifndef DALI_PIPELINE_OPERATORS_READER_PARSER_RECORDIO_PARSER_H_
 #define DALI_PIPELINE_OPERATORS_READER_PARSER_RECORDIO_PARSER_H_
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -37,11 +38,13 @@ class RecordIOParser : public Parser<Tensor<CPUBackend>> {
   void Parse(const Tensor<CPUBackend>& data, SampleWorkspace* ws) override {
     auto& image = ws->Output<CPUBackend>(0);
     auto& label = ws->Output<CPUBackend>(1);
-    ReadSingleImageRecordIO(image, label, data.data<uint8_t>());
+    ReadSingleImageRecordIO(image, label, data);
     image.SetSourceInfo(data.GetSourceInfo());
   }
 
  private:
+  static const uint32_t kMagic = 0xced7230a;
+
   inline uint32_t DecodeFlag(uint32_t rec) {
     return (rec >> 29U) & 7U;
   }
@@ -56,11 +59,38 @@ class RecordIOParser : public Parser<Tensor<CPUBackend>> {
     *in += sizeof(T);
   }
 
+  /**
+   * @brief Calls `process(ptr, size)` for the consecutive pieces of a record that was split
+   *        into parts, in order.
+   *
+   * The record was split at occurrences of the magic number, which are passed back
+   * in between the parts.
+   */
+  template <typename Process>
+  void ForEachRecordPart(const uint8_t* input, uint32_t cflag, uint32_t clength,
+                         int64_t data_size, Process&& process) {
+    static const uint32_t magic = kMagic;
+    process(input, data_size);
+    input += data_size;
+    while (cflag != 3) {
+      // parts are padded to a multiple of 4 bytes
+      input += (((clength + 3U) >> 2U) << 2U) - clength;
+      process(reinterpret_cast<const uint8_t*>(&magic), sizeof(magic));
+      uint32_t part_magic, length_flag;
+      ReadSingle(&input, &part_magic);
+      ReadSingle(&input, &length_flag);
+      cflag = DecodeFlag(length_flag);
+      clength = DecodeLength(length_flag);
+      process(input, clength);
+      input += clength;
+    }
+  }
+
   inline void ReadSingleImageRecordIO(Tensor<CPUBackend>& o_image,
                 Tensor<CPUBackend>& o_label,
-                const uint8_t* input) {
+                const Tensor<CPUBackend>& record) {
+    const uint8_t* input = record.data<uint8_t>();
     uint32_t magic;
-    const uint32_t kMagic = 0xced7230a;
     ReadSingle<uint32_t>(&input, &magic);
     DALI_ENFORCE(magic == kMagic, "Invalid RecordIO: wrong magic number");
 
@@ -81,47 +111,39 @@ class RecordIOParser : public Parser<Tensor<CPUBackend>> {
 
     int64_t data_size = clength - sizeof(ImageRecordIOHeader);
     int64_t label_size = hdr.flag * sizeof(float);
-    int64_t image_size = data_size - label_size;
     if (cflag == 0) {
-      o_image.Resize({image_size});
-      uint8_t* data = o_image.mutable_data<uint8_t>();
-      memcpy(data, input + label_size, image_size);
+      // the encoded image is contiguous in the record - pass it on without copying
+      int64_t image_offset = input + label_size - record.data<uint8_t>();
+      ShareOrCopyBytes(o_image, record, image_offset, data_size - label_size);
       if (hdr.flag > 0) {
         float * label = o_label.mutable_data<float>();
         memcpy(label, input, label_size);
       }
     } else {
-      std::vector<uint8_t> temp_vec(data_size);
-      memcpy(&temp_vec[0], input, data_size);
-      input += data_size;
-
-      while (true) {
-        size_t pad = clength - (((clength + 3U) >> 2U) << 2U);
-        input += pad;
-
-        if (cflag != 3) {
-          size_t s = temp_vec.size();
-          temp_vec.resize(static_cast<int64_t>(s + sizeof(kMagic)));
-          memcpy(&temp_vec[s], &kMagic, sizeof(kMagic));
-        } else {
-          break;
+      // the parts are assembled directly in the outputs; the labels come first
+      int64_t total_size = 0;
+      ForEachRecordPart(input, cflag, clength, data_size,
+                        [&](const uint8_t*, int64_t size) { total_size += size; });
+      DALI_ENFORCE(total_size >= label_size, "Invalid RecordIO: record shorter than its labels");
+
+      if (o_image.shares_data())
+        o_image.Reset();
+      o_image.Resize({total_size - label_size});
+      uint8_t* image = o_image.mutable_data<uint8_t>();
+      uint8_t* label = reinterpret_cast<uint8_t*>(o_label.mutable_data<float>());
+      int64_t pos = 0;
+      ForEachRecordPart(input, cflag, clength, data_size,
+                        [&](const uint8_t* part, int64_t size) {
+        if (pos < label_size) {
+          int64_t n = std::min(size, label_size - pos);
+          memcpy(label + pos, part, n);
+          part += n;
+          size -= n;
+          pos += n;
         }
-        ReadSingle(&input, &magic);
-        ReadSingle(&input, &length_flag);
-        cflag = DecodeFlag(length_flag);
-        clength = DecodeLength(length_flag);
-        size_t s = temp_vec.size();
-        temp_vec.resize(static_cast<int64_t>(s + clength));
-        memcpy(&temp_vec[s], input, clength);
-        input += clength;
-      }
-      o_image.Resize({static_cast<Index>(temp_vec.size() - label_size)});
-      uint8_t* data = o_image.mutable_data<uint8_t>();
-      memcpy(data, (&temp_vec[0]) + label_size, temp_vec.size() - label_size);
-      if (hdr.flag > 0) {
-        float * label = o_label.mutable_data<float>();
-        memcpy(label, &temp_vec[0], label_size);
-      }
+        memcpy(image + pos - label_size, part, size);
+        pos += size;
+      });
     }
   }
 };
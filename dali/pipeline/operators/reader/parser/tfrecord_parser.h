@@ -17,17 +17,19 @@
 
 #ifdef DALI_BUILD_PROTO3
 
-#include <vector>
-#include <string>
 #include <exception>
 #include <functional>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/pipeline/operators/argument.h"
 #include "dali/pipeline/operators/op_spec.h"
 #include "dali/pipeline/operators/reader/parser/parser.h"
 #include "dali/pipeline/operators/reader/parser/tf_feature.h"
-#include "dali/pipeline/operators/reader/parser/example.pb.h"
+#include "dali/pipeline/operators/reader/parser/tfrecord_scanner.h"
 
 namespace dali {
 
@@ -46,21 +48,24 @@ class TFRecordParser : public Parser<Tensor<CPUBackend>> {
         "No features provided");
   }
 
+  /**
+   * @brief Extracts the features straight from the serialized tf.Example
+   *
+   * The Example is not deserialized - only the requested features are located and their
+   * values decoded into the outputs. Bytes features reference the record, when possible.
+   */
   void Parse(const Tensor<CPUBackend>& data, SampleWorkspace* ws) override {
-    tensorflow::Example example;
-
-    uint64_t length;
-    uint32_t crc;
-
-    const uint8_t* raw_data = data.data<uint8_t>();
-
-    std::memcpy(&length, raw_data, sizeof(length));
-
-    // Omit length and crc
-    raw_data = raw_data + sizeof(length) + sizeof(crc);
+    auto record = span<const uint8_t>(data.data<uint8_t>(), data.size());
+    auto &scratch = scratch_[ws->thread_idx()];
+    auto &encoded_features = scratch.encoded_features;
+    auto &found = scratch.found;
+    if (encoded_features.empty()) {
+      encoded_features.resize(features_.size());
+      found.reset(new bool[features_.size()]);
+    }
     try {
-      DALI_ENFORCE(example.ParseFromArray(raw_data, length),
-          "Error in parsing - invalid TFRecord file!");
+      auto example = tfrecord::CheckFraming(record);
+      tfrecord::FindFeatures(example, feature_names_, encoded_features.data(), found.get());
     } catch (std::exception& e) {
       std::string str = "Error while parsing TFRecord: " + std::string(e.what());
       DALI_FAIL(str);
@@ -70,49 +75,58 @@ class TFRecordParser : public Parser<Tensor<CPUBackend>> {
       auto& output = ws->Output<CPUBackend>(i);
       Feature& f = features_[i];
       std::string& name = feature_names_[i];
-      auto& encoded_feature = example.features().feature().at(name);
-      if (f.HasShape() && f.GetType() != FeatureType::string) {
-        if (f.Shape().empty()) {
-          output.Resize({1});
-        } else {
-          output.Resize(f.Shape());
-        }
-      }
+      DALI_ENFORCE(found[i], "Feature \"" + name + "\" not found in the TFRecord.");
+      tfrecord::FeatureValues values(encoded_features[i]);
       switch (f.GetType()) {
         case FeatureType::int64:
-          if (!f.HasShape()) {
-            output.Resize(InferShape(f, encoded_feature.int64_list().value().size()));
-          }
-          std::memcpy(output.mutable_data<int64_t>(),
-              encoded_feature.int64_list().value().data(),
-              encoded_feature.int64_list().value().size()*sizeof(int64_t));
+          output.Resize(GetShape(f, name, values.count(tfrecord::ListKind::int64)));
+          values.CopyInt64(output.mutable_data<int64_t>());
           break;
-        case FeatureType::string:
-          if (!f.HasShape() || volume(f.Shape()) > 1) {
-            DALI_FAIL("Tensors of strings are not supported.");
+        case FeatureType::string: {
+            if (!f.HasShape() || volume(f.Shape()) > 1) {
+              DALI_FAIL("Tensors of strings are not supported.");
+            }
+            DALI_ENFORCE(values.count(tfrecord::ListKind::bytes) > 0,
+                "Feature \"" + name + "\" holds no bytes.");
+            auto bytes = values.FirstBytes();
+            ShareOrCopyBytes(output, data, bytes.data() - record.data(), bytes.size());
           }
-          output.Resize({static_cast<Index>(encoded_feature.bytes_list().value(0).size())});
-          std::memcpy(output.mutable_data<uint8_t>(),
-              encoded_feature.bytes_list().value(0).c_str(),
-              encoded_feature.bytes_list().value(0).size()*sizeof(uint8_t));
           break;
         case FeatureType::float32:
-          if (!f.HasShape()) {
-            output.Resize(InferShape(f, encoded_feature.float_list().value().size()));
-          }
-          std::memcpy(output.mutable_data<float>(),
-              encoded_feature.float_list().value().data(),
-              encoded_feature.float_list().value().size()*sizeof(float));
+          output.Resize(GetShape(f, name, values.count(tfrecord::ListKind::float32)));
+          values.CopyFloat(output.mutable_data<float>());
           break;
       }
       output.SetSourceInfo(data.GetSourceInfo());
     }
   }
 
+  void PrepareThreads(int num_threads) override {
+    scratch_.Resize(num_threads);
+  }
+
  private:
   std::vector<std::string> feature_names_;
   std::vector<Feature> features_;
 
+  /// Locations of the requested features in the record being parsed
+  struct Scratch {
+    std::vector<span<const uint8_t>> encoded_features;
+    std::unique_ptr<bool[]> found;
+  };
+  PerThreadScratch<Scratch> scratch_;
+
+  std::vector<Index> GetShape(Feature& feature, const std::string& name, int64_t count) {
+    if (!feature.HasShape())
+      return InferShape(feature, count);
+    std::vector<Index> shape = feature.Shape();
+    if (shape.empty())
+      shape = {1};
+    DALI_ENFORCE(volume(shape) == count, "Feature \"" + name + "\" has " + to_string(count) +
+        " values, but its shape " + to_string(shape) + " requires " + to_string(volume(shape)));
+    return shape;
+  }
+
   std::vector<Index> InferShape(Feature& feature, size_t feature_size) {
     if (feature.HasPartialShape()) {
       auto partial_shape = feature.PartialShape();
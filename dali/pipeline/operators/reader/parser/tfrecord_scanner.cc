@@ -0,0 +1,355 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/operators/reader/parser/tfrecord_scanner.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dali/core/cpu_features.h"
+
+#if DALI_X86_SIMD && defined(__x86_64__)
+#define DALI_CRC32C_SSE42 1
+#endif
+
+namespace dali {
+namespace tfrecord {
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0x82f63b78u;  // reversed Castagnoli polynomial
+
+/**
+ * @brief Lookup tables for computing the CRC 8 bytes at a time ("slicing-by-8")
+ *
+ * table[k][b] is the CRC of the byte `b` followed by `k` zero bytes.
+ */
+struct CRC32CTables {
+  CRC32CTables() {
+    for (uint32_t b = 0; b < 256; b++) {
+      uint32_t crc = b;
+      for (int k = 0; k < 8; k++)
+        crc = (crc >> 1) ^ (kPolynomial & (0u - (crc & 1u)));
+      table[0][b] = crc;
+    }
+    for (int k = 1; k < 8; k++) {
+      for (int b = 0; b < 256; b++)
+        table[k][b] = (table[k - 1][b] >> 8) ^ table[0][table[k - 1][b] & 0xff];
+    }
+  }
+
+  uint32_t table[8][256];
+};
+
+uint32_t CRC32CPortable(uint32_t crc, const uint8_t *data, size_t size) {
+  static const CRC32CTables tables;
+  auto &t = tables.table;
+  for (; size >= 8; data += 8, size -= 8) {
+    uint32_t lo, hi;
+    std::memcpy(&lo, data, sizeof(lo));
+    std::memcpy(&hi, data + sizeof(lo), sizeof(hi));
+    lo ^= crc;
+    crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+          t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+  }
+  for (; size > 0; data++, size--)
+    crc = t[0][(crc ^ *data) & 0xff] ^ (crc >> 8);
+  return crc;
+}
+
+#if DALI_CRC32C_SSE42
+
+/**
+ * @brief Advances the CRC register over a fixed number of zero bytes
+ *
+ * This is a linear map, so it is tabulated for each byte of the register. Built from
+ * the matrix of a single zero bit, raised to the required power by repeated squaring.
+ */
+class CRC32CShift {
+ public:
+  explicit CRC32CShift(size_t bytes) {
+    Matrix bit, result;
+    bit[0] = kPolynomial;
+    for (int i = 1; i < 32; i++)
+      bit[i] = 1u << (i - 1);
+    for (int i = 0; i < 32; i++)
+      result[i] = 1u << i;
+    // powers of the single bit operator, for each bit of the number of zero bits
+    for (size_t bits = bytes * 8; bits; bits >>= 1) {
+      if (bits & 1)
+        result = Multiply(bit, result);
+      bit = Multiply(bit, bit);
+    }
+    for (int k = 0; k < 4; k++) {
+      for (uint32_t b = 0; b < 256; b++)
+        table_[k][b] = Apply(result, b << (8 * k));
+    }
+  }
+
+  uint32_t operator()(uint32_t crc) const {
+    return table_[0][crc & 0xff] ^ table_[1][(crc >> 8) & 0xff] ^
+           table_[2][(crc >> 16) & 0xff] ^ table_[3][crc >> 24];
+  }
+
+ private:
+  /// Column i is the image of the bit i
+  using Matrix = std::array<uint32_t, 32>;
+
+  static uint32_t Apply(const Matrix &m, uint32_t v) {
+    uint32_t result = 0;
+    for (int i = 0; v; i++, v >>= 1) {
+      if (v & 1)
+        result ^= m[i];
+    }
+    return result;
+  }
+
+  static Matrix Multiply(const Matrix &a, const Matrix &b) {
+    Matrix result;
+    for (int i = 0; i < 32; i++)
+      result[i] = Apply(a, b[i]);
+    return result;
+  }
+
+  uint32_t table_[4][256];
+};
+
+DALI_TARGET_SSE42
+uint64_t CRC32CSSE42Stream(uint64_t crc, const uint8_t *data, size_t size) {
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t v;
+    std::memcpy(&v, data, sizeof(v));
+    crc = _mm_crc32_u64(crc, v);
+  }
+  return crc;
+}
+
+/**
+ * The instruction has a latency of 3 cycles and a throughput of 1 per cycle, so large
+ * buffers are processed as 3 independent streams, which are then combined.
+ */
+DALI_TARGET_SSE42
+uint32_t CRC32CSSE42(uint32_t crc, const uint8_t *data, size_t size) {
+  constexpr size_t kStreamSize = 1024;
+  static const CRC32CShift shift(kStreamSize);
+  uint64_t crc0 = crc;
+  for (; size >= 3 * kStreamSize; data += 3 * kStreamSize, size -= 3 * kStreamSize) {
+    uint64_t crc1 = 0, crc2 = 0;
+    for (size_t i = 0; i < kStreamSize; i += 8) {
+      uint64_t v0, v1, v2;
+      std::memcpy(&v0, data + i, sizeof(v0));
+      std::memcpy(&v1, data + kStreamSize + i, sizeof(v1));
+      std::memcpy(&v2, data + 2 * kStreamSize + i, sizeof(v2));
+      crc0 = _mm_crc32_u64(crc0, v0);
+      crc1 = _mm_crc32_u64(crc1, v1);
+      crc2 = _mm_crc32_u64(crc2, v2);
+    }
+    // CRC(a || b) = CRC(a) advanced over len(b) zero bytes ^ CRC of b from a zero register
+    crc0 = shift(shift(static_cast<uint32_t>(crc0)) ^ static_cast<uint32_t>(crc1)) ^ crc2;
+  }
+  crc0 = CRC32CSSE42Stream(crc0, data, size);
+  crc = static_cast<uint32_t>(crc0);
+  data += size & ~size_t(7);
+  for (size &= 7; size > 0; data++, size--)
+    crc = _mm_crc32_u8(crc, *data);
+  return crc;
+}
+
+#endif  // DALI_CRC32C_SSE42
+
+}  // namespace
+
+uint32_t CRC32C(const uint8_t *data, size_t size) {
+#if DALI_CRC32C_SSE42
+  if (HasSSE42())
+    return ~CRC32CSSE42(~0u, data, size);
+#endif
+  return ~CRC32CPortable(~0u, data, size);
+}
+
+span<const uint8_t> CheckFraming(span<const uint8_t> record) {
+  const size_t size = record.size();
+  DALI_ENFORCE(size >= kHeaderSize + kFooterSize,
+               "Invalid TFRecord: the record is only " + std::to_string(size) + " bytes long.");
+  const uint8_t *data = record.data();
+  uint64_t length;
+  uint32_t length_crc, data_crc;
+  std::memcpy(&length, data, sizeof(length));
+  std::memcpy(&length_crc, data + sizeof(length), sizeof(length_crc));
+  DALI_ENFORCE(MaskedCRC32C(data, sizeof(length)) == length_crc,
+               "Invalid TFRecord: corrupted length.");
+  DALI_ENFORCE(length <= size - kHeaderSize - kFooterSize,
+               "Invalid TFRecord: the record is " + std::to_string(length) +
+               " bytes long, but only " + std::to_string(size - kHeaderSize - kFooterSize) +
+               " bytes were read. Check if the index file matches the TFRecord file.");
+  std::memcpy(&data_crc, data + kHeaderSize + length, sizeof(data_crc));
+  DALI_ENFORCE(MaskedCRC32C(data + kHeaderSize, length) == data_crc,
+               "Invalid TFRecord: corrupted data.");
+  return span<const uint8_t>(data + kHeaderSize, static_cast<span_extent_t>(length));
+}
+
+void FindFeatures(span<const uint8_t> example, const std::vector<std::string> &names,
+                  span<const uint8_t> *features, bool *found) {
+  std::fill(found, found + names.size(), false);
+  WireReader example_reader(example);
+  WireField field;
+  // Example { Features features = 1; }
+  while (example_reader.Next(&field)) {
+    if (field.number != 1 || field.wire_type != kLengthDelimited)
+      continue;
+    // Features { map<string, Feature> feature = 1; }
+    WireReader features_reader(field.bytes);
+    WireField entry;
+    while (features_reader.Next(&entry)) {
+      if (entry.number != 1 || entry.wire_type != kLengthDelimited)
+        continue;
+      // map entry { string key = 1; Feature value = 2; }
+      WireReader entry_reader(entry.bytes);
+      WireField kv;
+      span<const uint8_t> key, value;
+      while (entry_reader.Next(&kv)) {
+        if (kv.wire_type != kLengthDelimited)
+          continue;
+        if (kv.number == 1)
+          key = kv.bytes;
+        else if (kv.number == 2)
+          value = kv.bytes;
+      }
+      for (size_t i = 0; i < names.size(); i++) {
+        if (names[i].size() == static_cast<size_t>(key.size()) &&
+            std::memcmp(names[i].data(), key.data(), key.size()) == 0) {
+          features[i] = value;
+          found[i] = true;
+        }
+      }
+    }
+  }
+}
+
+FeatureValues::FeatureValues(span<const uint8_t> feature) {
+  // Feature { oneof kind { BytesList bytes_list = 1; FloatList float_list = 2;
+  //                        Int64List int64_list = 3; } }
+  WireReader reader(feature);
+  WireField field;
+  for (auto rest = reader.remaining(); reader.Next(&field); rest = reader.remaining()) {
+    if (field.wire_type != kLengthDelimited || field.number < 1 || field.number > 3)
+      continue;
+    auto kind = static_cast<ListKind>(field.number);
+    if (kind != kind_) {
+      kind_ = kind;
+      lists_ = rest;
+    }
+  }
+}
+
+template <typename Callback>
+void FeatureValues::ForEachList(Callback &&callback) const {
+  // XxxList { repeated xxx value = 1; } - numeric values can be packed or not
+  WireReader reader(lists_);
+  WireField list;
+  while (reader.Next(&list)) {
+    if (static_cast<ListKind>(list.number) != kind_ || list.wire_type != kLengthDelimited)
+      continue;
+    WireReader list_reader(list.bytes);
+    WireField value;
+    while (list_reader.Next(&value)) {
+      if (value.number == 1)
+        callback(value);
+    }
+  }
+}
+
+int64_t FeatureValues::count(ListKind kind) const {
+  if (kind != kind_)
+    return 0;
+  int64_t n = 0;
+  ForEachList([&](const WireField &value) {
+    switch (kind_) {
+      case ListKind::int64:
+        if (value.wire_type == kVarint) {
+          n++;
+        } else if (value.wire_type == kLengthDelimited) {
+          DALI_ENFORCE(value.bytes.empty() || value.bytes[value.bytes.size() - 1] < 0x80,
+                       "Truncated varint in a packed int64 list.");
+          // each varint ends with a byte without the continuation bit
+          for (uint8_t b : value.bytes)
+            n += b < 0x80;
+        }
+        break;
+      case ListKind::float32:
+        if (value.wire_type == kFixed32) {
+          n++;
+        } else if (value.wire_type == kLengthDelimited) {
+          DALI_ENFORCE(value.bytes.size() % sizeof(float) == 0,
+                       "Invalid length of a packed float list.");
+          n += value.bytes.size() / sizeof(float);
+        }
+        break;
+      case ListKind::bytes:
+        n += value.wire_type == kLengthDelimited;
+        break;
+      default:
+        break;
+    }
+  });
+  return n;
+}
+
+void FeatureValues::CopyInt64(int64_t *out) const {
+  if (kind_ != ListKind::int64)
+    return;
+  ForEachList([&](const WireField &value) {
+    if (value.wire_type == kVarint) {
+      *out++ = static_cast<int64_t>(value.value);
+    } else if (value.wire_type == kLengthDelimited) {
+      const uint8_t *ptr = value.bytes.data();
+      const uint8_t *end = ptr + value.bytes.size();
+      while (ptr < end)
+        *out++ = static_cast<int64_t>(WireReader::DecodeVarint(ptr, end));
+    }
+  });
+}
+
+void FeatureValues::CopyFloat(float *out) const {
+  if (kind_ != ListKind::float32)
+    return;
+  ForEachList([&](const WireField &value) {
+    if (value.wire_type == kFixed32) {
+      uint32_t bits = static_cast<uint32_t>(value.value);
+      std::memcpy(out++, &bits, sizeof(float));
+    } else if (value.wire_type == kLengthDelimited) {
+      std::memcpy(out, value.bytes.data(), value.bytes.size());
+      out += value.bytes.size() / sizeof(float);
+    }
+  });
+}
+
+span<const uint8_t> FeatureValues::FirstBytes() const {
+  span<const uint8_t> first;
+  bool found = false;
+  if (kind_ == ListKind::bytes) {
+    ForEachList([&](const WireField &value) {
+      if (!found && value.wire_type == kLengthDelimited) {
+        first = value.bytes;
+        found = true;
+      }
+    });
+  }
+  return first;
+}
+
+}  // namespace tfrecord
+}  // namespace dali
@@ -0,0 +1,212 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATORS_READER_PARSER_TFRECORD_SCANNER_H_
+#define DALI_PIPELINE_OPERATORS_READER_PARSER_TFRECORD_SCANNER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/core/error_handling.h"
+#include "dali/core/span.h"
+
+namespace dali {
+
+/**
+ * @brief Reading of TFRecords straight from the protobuf wire format
+ *
+ * Only the requested features of a serialized tf.Example are located; their values
+ * are decoded on demand, without materializing the whole message.
+ */
+namespace tfrecord {
+
+/// Length of the record, followed by its masked CRC
+constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+/// Masked CRC of the data
+constexpr size_t kFooterSize = sizeof(uint32_t);
+
+/**
+ * @brief CRC-32C (Castagnoli) of `size` bytes; uses the SSE4.2 instruction when available
+ */
+DLL_PUBLIC uint32_t CRC32C(const uint8_t *data, size_t size);
+
+/**
+ * @brief The checksum stored in TFRecords - rotated, so that a CRC of data containing
+ *        an embedded CRC is less likely to be trivial
+ */
+inline uint32_t MaskedCRC32C(const uint8_t *data, size_t size) {
+  uint32_t crc = CRC32C(data, size);
+  return ((crc >> 15) | (crc << 17)) + 0xa282ead8u;
+}
+
+/**
+ * @brief Checks the length and the checksums of a single framed record
+ *
+ * @return the payload of the record, i.e. a serialized tf.Example
+ */
+DLL_PUBLIC span<const uint8_t> CheckFraming(span<const uint8_t> record);
+
+enum WireType : uint32_t {
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kFixed32 = 5
+};
+
+/// A single field of a protobuf message
+struct WireField {
+  uint32_t number;
+  WireType wire_type;
+  /// The value of varint and fixed-size fields
+  uint64_t value;
+  /// The payload of length-delimited fields
+  span<const uint8_t> bytes;
+};
+
+/**
+ * @brief Iterates over the fields of a serialized protobuf message
+ */
+class WireReader {
+ public:
+  explicit WireReader(span<const uint8_t> message)
+  : ptr_(message.data()), end_(message.data() + message.size()) {}
+
+  /**
+   * @brief Reads the next field; returns false at the end of the message
+   */
+  bool Next(WireField *field) {
+    if (ptr_ == end_)
+      return false;
+    uint64_t tag = ReadVarint();
+    field->number = static_cast<uint32_t>(tag >> 3);
+    field->wire_type = static_cast<WireType>(tag & 7);
+    DALI_ENFORCE(field->number != 0, "Invalid field number in a protobuf message.");
+    switch (field->wire_type) {
+      case kVarint:
+        field->value = ReadVarint();
+        break;
+      case kFixed64:
+        field->value = ReadFixed<uint64_t>();
+        break;
+      case kFixed32:
+        field->value = ReadFixed<uint32_t>();
+        break;
+      case kLengthDelimited: {
+          uint64_t length = ReadVarint();
+          DALI_ENFORCE(length <= static_cast<uint64_t>(end_ - ptr_),
+                       "Truncated length-delimited field in a protobuf message.");
+          field->bytes = span<const uint8_t>(ptr_, static_cast<span_extent_t>(length));
+          ptr_ += length;
+        }
+        break;
+      default:
+        DALI_FAIL("Unsupported wire type " + std::to_string(field->wire_type) +
+                  " in a protobuf message.");
+    }
+    return true;
+  }
+
+  /// @brief The part of the message which was not read yet
+  span<const uint8_t> remaining() const {
+    return span<const uint8_t>(ptr_, end_);
+  }
+
+  static uint64_t DecodeVarint(const uint8_t *&ptr, const uint8_t *end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      DALI_ENFORCE(ptr < end, "Truncated varint in a protobuf message.");
+      uint8_t byte = *ptr++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return value;
+    }
+    DALI_FAIL("Varint too long in a protobuf message.");
+  }
+
+ private:
+  uint64_t ReadVarint() {
+    // fast path for tags and lengths below 128
+    if (ptr_ < end_ && *ptr_ < 0x80)
+      return *ptr_++;
+    return DecodeVarint(ptr_, end_);
+  }
+
+  template <typename T>
+  T ReadFixed() {
+    DALI_ENFORCE(static_cast<size_t>(end_ - ptr_) >= sizeof(T),
+                 "Truncated fixed-size field in a protobuf message.");
+    T value;
+    std::memcpy(&value, ptr_, sizeof(T));
+    ptr_ += sizeof(T);
+    return value;
+  }
+
+  const uint8_t *ptr_, *end_;
+};
+
+/// Kind of the value list of a tf.Feature - the field number in the `oneof`
+enum class ListKind : uint32_t {
+  none = 0,
+  bytes = 1,
+  float32 = 2,
+  int64 = 3
+};
+
+/**
+ * @brief Looks up features by name in a serialized tf.Example
+ *
+ * Fills `features[i]` with the serialized tf.Feature named `names[i]`; a feature that
+ * is not present is left empty and `found[i]` is set to false. If a name occurs more
+ * than once, the last occurrence is used, as it would be by the protobuf parser.
+ */
+DLL_PUBLIC void FindFeatures(span<const uint8_t> example, const std::vector<std::string> &names,
+                             span<const uint8_t> *features, bool *found);
+
+/**
+ * @brief The values of a serialized tf.Feature
+ *
+ * Follows the protobuf merge semantics - if the message contains several lists,
+ * the kind set last wins and the lists of that kind which follow are concatenated.
+ */
+class DLL_PUBLIC FeatureValues {
+ public:
+  explicit FeatureValues(span<const uint8_t> feature);
+
+  ListKind kind() const { return kind_; }
+
+  /// @brief Number of values - 0 if the feature holds a list of a different kind
+  int64_t count(ListKind kind) const;
+
+  void CopyInt64(int64_t *out) const;
+  void CopyFloat(float *out) const;
+
+  /// @brief The first element of a bytes list; empty if there is none
+  span<const uint8_t> FirstBytes() const;
+
+ private:
+  template <typename Callback>
+  void ForEachList(Callback &&callback) const;
+
+  /// Starts with the first list of the last kind set
+  span<const uint8_t> lists_;
+  ListKind kind_ = ListKind::none;
+};
+
+}  // namespace tfrecord
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_READER_PARSER_TFRECORD_SCANNER_H_
@@ -0,0 +1,350 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/parser/tfrecord_scanner.h"
+#ifdef DALI_BUILD_PROTO3
+#include "dali/pipeline/operators/reader/parser/example.pb.h"
+#include "dali/pipeline/operators/reader/parser/tfrecord_parser.h"
+#endif  // DALI_BUILD_PROTO3
+
+namespace dali {
+namespace tfrecord {
+
+namespace {
+
+/// Minimal protobuf encoder, so that the wire format can be tested without generated code
+class WireWriter {
+ public:
+  WireWriter &Varint(uint32_t number, uint64_t value) {
+    Tag(number, kVarint);
+    PutVarint(value);
+    return *this;
+  }
+
+  WireWriter &Fixed32(uint32_t number, float value) {
+    Tag(number, kFixed32);
+    Put(&value, sizeof(value));
+    return *this;
+  }
+
+  WireWriter &Bytes(uint32_t number, const std::string &value) {
+    Tag(number, kLengthDelimited);
+    PutVarint(value.size());
+    Put(value.data(), value.size());
+    return *this;
+  }
+
+  WireWriter &Message(uint32_t number, const WireWriter &message) {
+    return Bytes(number, message.str());
+  }
+
+  const std::string &str() const { return data_; }
+
+  static std::string PackedInt64(const std::vector<int64_t> &values) {
+    WireWriter w;
+    for (auto v : values)
+      w.PutVarint(static_cast<uint64_t>(v));
+    return w.str();
+  }
+
+  static std::string PackedFloat(const std::vector<float> &values) {
+    return std::string(reinterpret_cast<const char *>(values.data()),
+                       values.size() * sizeof(float));
+  }
+
+ private:
+  void Tag(uint32_t number, WireType type) {
+    PutVarint(number << 3 | type);
+  }
+
+  void PutVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>(value | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+
+  void Put(const void *data, size_t size) {
+    data_.append(static_cast<const char *>(data), size);
+  }
+
+  std::string data_;
+};
+
+WireWriter Entry(const std::string &name, const WireWriter &feature) {
+  return WireWriter().Bytes(1, name).Message(2, feature);
+}
+
+span<const uint8_t> AsSpan(const std::string &s) {
+  return span<const uint8_t>(reinterpret_cast<const uint8_t *>(s.data()), s.size());
+}
+
+std::string Frame(const std::string &data) {
+  uint64_t length = data.size();
+  uint32_t length_crc = MaskedCRC32C(reinterpret_cast<const uint8_t *>(&length), sizeof(length));
+  uint32_t data_crc = MaskedCRC32C(AsSpan(data).data(), data.size());
+  std::string record(reinterpret_cast<const char *>(&length), sizeof(length));
+  record.append(reinterpret_cast<const char *>(&length_crc), sizeof(length_crc));
+  record += data;
+  record.append(reinterpret_cast<const char *>(&data_crc), sizeof(data_crc));
+  return record;
+}
+
+}  // namespace
+
+TEST(TFRecordScannerTest, CRC32C) {
+  // check value of the Castagnoli CRC
+  EXPECT_EQ(CRC32C(AsSpan("123456789").data(), 9), 0xe3069283u);
+  EXPECT_EQ(CRC32C(nullptr, 0), 0u);
+  // all lengths and alignments of the tail, compared with the bitwise definition
+  std::string data;
+  for (int i = 0; i < 20000; i++)
+    data.push_back(static_cast<char>(i * 37 + (i >> 8)));
+  auto reference = [&](size_t offset, size_t size) {
+    uint32_t crc = ~0u;
+    for (size_t i = offset; i < offset + size; i++) {
+      crc ^= static_cast<uint8_t>(data[i]);
+      for (int k = 0; k < 8; k++)
+        crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1u)));
+    }
+    return ~crc;
+  };
+  for (size_t offset = 0; offset < 8; offset++) {
+    for (size_t size = 0; size < 100; size++) {
+      ASSERT_EQ(CRC32C(AsSpan(data).data() + offset, size), reference(offset, size))
+          << "offset " << offset << " size " << size;
+    }
+    // large buffers are processed in several streams
+    for (size_t size : { 3071, 3072, 3079, 6144, 19000 }) {
+      ASSERT_EQ(CRC32C(AsSpan(data).data() + offset, size), reference(offset, size))
+          << "offset " << offset << " size " << size;
+    }
+  }
+}
+
+TEST(TFRecordScannerTest, Framing) {
+  std::string data = "not really an Example";
+  std::string record = Frame(data);
+  auto payload = CheckFraming(AsSpan(record));
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(payload.data()), payload.size()), data);
+
+  // trailing bytes are ignored
+  EXPECT_EQ(CheckFraming(AsSpan(record + "xyz")).size(), payload.size());
+
+  auto corrupted = record;
+  corrupted[0] ^= 1;
+  EXPECT_THROW(CheckFraming(AsSpan(corrupted)), std::runtime_error);
+  corrupted = record;
+  corrupted[kHeaderSize + 3] ^= 1;
+  EXPECT_THROW(CheckFraming(AsSpan(corrupted)), std::runtime_error);
+  corrupted = record;
+  corrupted[record.size() - 1] ^= 1;
+  EXPECT_THROW(CheckFraming(AsSpan(corrupted)), std::runtime_error);
+  EXPECT_THROW(CheckFraming(AsSpan(record.substr(0, record.size() - 1))), std::runtime_error);
+  EXPECT_THROW(CheckFraming(AsSpan(record.substr(0, 5))), std::runtime_error);
+}
+
+TEST(TFRecordScannerTest, FindFeatures) {
+  auto int64_feature = WireWriter().Message(3, WireWriter().Bytes(
+      1, WireWriter::PackedInt64({1, -2, 300})));
+  auto float_feature = WireWriter().Message(2, WireWriter().Fixed32(1, 0.5f).Fixed32(1, 1.5f));
+  auto bytes_feature = WireWriter().Message(1, WireWriter().Bytes(1, "image").Bytes(1, "x"));
+  auto features = WireWriter()
+      .Message(1, Entry("label", int64_feature))
+      .Message(1, Entry("bbox", float_feature))
+      .Message(1, Entry("label", WireWriter().Message(3, WireWriter().Varint(1, 7))));
+  // the features can be split among several fields, which are merged; unknown fields are skipped
+  auto example = WireWriter()
+      .Message(1, features)
+      .Varint(15, 12345)
+      .Message(1, WireWriter().Message(1, Entry("encoded", bytes_feature)));
+
+  std::vector<std::string> names = { "encoded", "label", "bbox", "missing" };
+  std::vector<span<const uint8_t>> found_features(names.size());
+  bool found[4];
+  FindFeatures(AsSpan(example.str()), names, found_features.data(), found);
+  EXPECT_TRUE(found[0]);
+  EXPECT_TRUE(found[1]);
+  EXPECT_TRUE(found[2]);
+  EXPECT_FALSE(found[3]);
+
+  FeatureValues encoded(found_features[0]);
+  EXPECT_EQ(encoded.kind(), ListKind::bytes);
+  EXPECT_EQ(encoded.count(ListKind::bytes), 2);
+  EXPECT_EQ(encoded.count(ListKind::int64), 0);
+  auto first = encoded.FirstBytes();
+  EXPECT_EQ(std::string(reinterpret_cast<const char *>(first.data()), first.size()), "image");
+
+  // the last entry of a key wins
+  FeatureValues label(found_features[1]);
+  ASSERT_EQ(label.count(ListKind::int64), 1);
+  int64_t label_value = 0;
+  label.CopyInt64(&label_value);
+  EXPECT_EQ(label_value, 7);
+
+  FeatureValues bbox(found_features[2]);
+  ASSERT_EQ(bbox.count(ListKind::float32), 2);
+  float bbox_values[2];
+  bbox.CopyFloat(bbox_values);
+  EXPECT_EQ(bbox_values[0], 0.5f);
+  EXPECT_EQ(bbox_values[1], 1.5f);
+}
+
+TEST(TFRecordScannerTest, MergedLists) {
+  // packed and unpacked values of the same list are concatenated...
+  auto ints = WireWriter()
+      .Message(3, WireWriter().Bytes(1, WireWriter::PackedInt64({1, 1LL << 40})).Varint(1, 2))
+      .Message(3, WireWriter().Bytes(1, WireWriter::PackedInt64({-1})));
+  FeatureValues int_values(AsSpan(ints.str()));
+  ASSERT_EQ(int_values.count(ListKind::int64), 4);
+  int64_t int_out[4];
+  int_values.CopyInt64(int_out);
+  EXPECT_EQ(int_out[0], 1);
+  EXPECT_EQ(int_out[1], 1LL << 40);
+  EXPECT_EQ(int_out[2], 2);
+  EXPECT_EQ(int_out[3], -1);
+
+  // ...but setting another kind of the `oneof` discards the previous lists
+  auto floats = WireWriter()
+      .Message(2, WireWriter().Bytes(1, WireWriter::PackedFloat({1, 2})))
+      .Message(3, WireWriter().Varint(1, 5))
+      .Message(2, WireWriter().Bytes(1, WireWriter::PackedFloat({3, 4, 5})).Fixed32(1, 6));
+  FeatureValues float_values(AsSpan(floats.str()));
+  EXPECT_EQ(float_values.kind(), ListKind::float32);
+  ASSERT_EQ(float_values.count(ListKind::float32), 4);
+  float float_out[4];
+  float_values.CopyFloat(float_out);
+  EXPECT_EQ(std::vector<float>(float_out, float_out + 4), std::vector<float>({3, 4, 5, 6}));
+
+  FeatureValues empty(span<const uint8_t>{});
+  EXPECT_EQ(empty.kind(), ListKind::none);
+  EXPECT_EQ(empty.count(ListKind::float32), 0);
+  EXPECT_EQ(empty.FirstBytes().size(), 0);
+}
+
+TEST(TFRecordScannerTest, Malformed) {
+  std::vector<std::string> names = { "a" };
+  span<const uint8_t> feature;
+  bool found;
+  auto example = WireWriter().Message(1, WireWriter().Message(1, Entry("a", WireWriter()))).str();
+  for (size_t size = 1; size < example.size(); size++) {
+    EXPECT_THROW(FindFeatures(AsSpan(example.substr(0, size)), names, &feature, &found),
+                 std::runtime_error) << size;
+  }
+  // a packed varint list cannot end in the middle of a value
+  auto ints = WireWriter().Message(3, WireWriter().Bytes(1, "\x81")).str();
+  EXPECT_THROW(FeatureValues(AsSpan(ints)).count(ListKind::int64), std::runtime_error);
+  auto floats = WireWriter().Message(2, WireWriter().Bytes(1, "abc")).str();
+  EXPECT_THROW(FeatureValues(AsSpan(floats)).count(ListKind::float32), std::runtime_error);
+}
+
+#ifdef DALI_BUILD_PROTO3
+
+class TFRecordParserTest : public ::testing::Test {
+ protected:
+  using Feature = TFUtil::Feature;
+
+  void SetUp() override {
+    workspace_.GetSample(&ws_, 0, 0);
+    for (int i = 0; i < 3; i++) {
+      outputs_.push_back(std::make_shared<Tensor<CPUBackend>>());
+      outputs_.back()->set_pinned(false);
+      ws_.AddOutput(outputs_.back());
+    }
+    for (int i = 0; i < 1000; i++)
+      image_.push_back(static_cast<char>(i));
+  }
+
+  void Parse(const tensorflow::Example &example, const std::vector<Feature> &features) {
+    auto record = Frame(example.SerializeAsString());
+    record_.Reset();
+    record_.set_pinned(false);
+    record_.Resize({static_cast<Index>(record.size())});
+    std::memcpy(record_.mutable_data<uint8_t>(), record.data(), record.size());
+    record_.SetSourceInfo("test record");
+    auto spec = OpSpec("TFRecordReader")
+        .AddArg("feature_names", std::vector<std::string>{ "image", "label", "bbox" })
+        .AddArg("features", features);
+    TFRecordParser parser(spec);
+    parser.PrepareThreads(1);
+    parser.Parse(record_, &ws_);
+  }
+
+  tensorflow::Example MakeExample() {
+    tensorflow::Example example;
+    auto &features = *example.mutable_features()->mutable_feature();
+    features["image"].mutable_bytes_list()->add_value(image_);
+    features["label"].mutable_int64_list()->add_value(-3);
+    features["other"].mutable_bytes_list()->add_value("ignored");
+    for (int i = 0; i < 8; i++)
+      features["bbox"].mutable_float_list()->add_value(i * 0.25f);
+    return example;
+  }
+
+  HostWorkspace workspace_;
+  SampleWorkspace ws_;
+  std::vector<std::shared_ptr<Tensor<CPUBackend>>> outputs_;
+  Tensor<CPUBackend> record_;
+  std::string image_;
+};
+
+TEST_F(TFRecordParserTest, MatchesProtobuf) {
+  Parse(MakeExample(), {
+    Feature({}, TFUtil::FeatureType::string, Feature::Value{}),
+    Feature({1}, TFUtil::FeatureType::int64, Feature::Value{"", -1}),
+    Feature(TFUtil::FeatureType::float32, Feature::Value{}, {4}) });
+
+  auto &image = *outputs_[0];
+  ASSERT_EQ(image.size(), static_cast<Index>(image_.size()));
+  auto image_data = reinterpret_cast<const char *>(image.data<uint8_t>());
+  EXPECT_EQ(std::string(image_data, image.size()), image_);
+  EXPECT_TRUE(image.shares_data());
+  EXPECT_EQ(image.GetSourceInfo(), "test record");
+
+  ASSERT_EQ(outputs_[1]->shape(), kernels::TensorShape<>(1));
+  EXPECT_EQ(outputs_[1]->data<int64_t>()[0], -3);
+
+  ASSERT_EQ(outputs_[2]->shape(), kernels::TensorShape<>(2, 4));
+  for (int i = 0; i < 8; i++)
+    EXPECT_EQ(outputs_[2]->data<float>()[i], i * 0.25f);
+}
+
+TEST_F(TFRecordParserTest, Errors) {
+  std::vector<Feature> features = {
+    Feature({}, TFUtil::FeatureType::string, Feature::Value{}),
+    Feature({1}, TFUtil::FeatureType::int64, Feature::Value{"", -1}),
+    Feature({8}, TFUtil::FeatureType::float32, Feature::Value{}) };
+  auto example = MakeExample();
+  EXPECT_NO_THROW(Parse(example, features));
+
+  // a fixed shape must match the number of values
+  features[1] = Feature({2}, TFUtil::FeatureType::int64, Feature::Value{"", -1});
+  EXPECT_THROW(Parse(example, features), std::runtime_error);
+  features[1] = Feature({1}, TFUtil::FeatureType::int64, Feature::Value{"", -1});
+
+  example.mutable_features()->mutable_feature()->erase("bbox");
+  EXPECT_THROW(Parse(example, features), std::runtime_error);
+}
+
+#endif  // DALI_BUILD_PROTO3
+
+}  // namespace tfrecord
+}  // namespace dali
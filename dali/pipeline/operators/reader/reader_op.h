@@ -16,17 +16,19 @@
 #define DALI_PIPELINE_OPERATORS_READER_READER_OP_H_
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
 #include <vector>
-#include <unordered_map>
 
 #include "dali/pipeline/operators/reader/loader/loader.h"
+#include "dali/pipeline/operators/reader/parsed_output_cache.h"
 #include "dali/pipeline/operators/reader/parser/parser.h"
 #include "dali/pipeline/operators/operator.h"
+#include "dali/pipeline/util/spsc_ring.h"
 
 namespace dali {
 
@@ -53,19 +55,20 @@ class DataReader : public Operator<Backend> {
 
   inline explicit DataReader(const OpSpec& spec)
       : Operator<Backend>(spec),
-        finished_(false),
         prefetch_queue_depth_(spec.GetArgument<int>("prefetch_queue_depth")),
         skip_cached_images_(spec.GetArgument<bool>("skip_cached_images")),
-        prefetched_batch_queue_(prefetch_queue_depth_),
-        curr_batch_consumer_(0),
-        curr_batch_producer_(0),
-        consumer_cycle_(false),
-        producer_cycle_(false),
+        prefetched_batch_queue_(prefetch_queue_depth_,
+                                spec.GetArgument<int>("prefetch_spin_count")),
         device_id_(-1),
         samples_processed_(0) {
           if (std::is_same<Backend, GPUBackend>::value) {
             device_id_ = spec.GetArgument<int>("device_id");
           }
+          int num_prefetch_threads = spec.GetArgument<int>("num_prefetch_threads");
+          DALI_ENFORCE(num_prefetch_threads > 0, "num_prefetch_threads must be positive");
+          if (num_prefetch_threads > 1) {
+            prefetch_thread_pool_.reset(new ThreadPool(num_prefetch_threads, device_id_, false));
+          }
         }
 
   ~DataReader() noexcept override {
@@ -81,28 +84,26 @@ class DataReader : public Operator<Backend> {
   // perform the prefetching operation
   virtual void Prefetch() {
     // We actually prepare the next batch
-    TimeRange tr("DataReader::Prefetch #" + to_string(curr_batch_producer_), TimeRange::kRed);
-    auto &curr_batch = prefetched_batch_queue_[curr_batch_producer_];
+    TimeRange tr("DataReader::Prefetch", TimeRange::kRed);
+    auto &curr_batch = prefetched_batch_queue_.WriteSlot();
     curr_batch.reserve(Operator<Backend>::batch_size_);
     curr_batch.clear();
-    for (int i = 0; i < Operator<Backend>::batch_size_; ++i) {
-      curr_batch.push_back(loader_->ReadOne());
-    }
+    loader_->ReadBatch(curr_batch, Operator<Backend>::batch_size_, prefetch_thread_pool_.get());
   }
 
   // Main prefetch work loop
   void PrefetchWorker() {
     DeviceGuard g(device_id_);
-    ProducerWait();
-    while (!finished_) {
+    // may run before the derived reader is constructed, so the spec is used rather than name()
+    tracing::SetThreadName(this->spec_.name() + " prefetch");
+    while (ProducerWait()) {
       try {
         Prefetch();
       } catch (const std::exception& e) {
         ProducerStop(std::current_exception());
         return;
       }
-      ProducerAdvanceQueue();
-      ProducerWait();
+      prefetched_batch_queue_.CommitWrite();
     }
   }
 
@@ -118,13 +119,17 @@ class DataReader : public Operator<Backend> {
   void StopPrefetchThread() {
     ProducerStop();
     if (prefetch_thread_.joinable()) {
-      producer_.notify_one();
       // join the prefetch thread and destroy it
       prefetch_thread_.join();
       prefetch_thread_ = {};
     }
   }
 
+  // Readers consume whole batches from the prefetch queue
+  bool CanRunPerSample() const override {
+    return false;
+  }
+
   // CPUBackend operators
   void Run(HostWorkspace* ws) override {
     // If necessary start prefetching thread and wait for a consumable batch
@@ -132,10 +137,10 @@ class DataReader : public Operator<Backend> {
     ConsumerWait();
 
     // consume batch
-    TimeRange tr("DataReader::Run #" + to_string(curr_batch_consumer_), TimeRange::kViolet);
+    TimeRange tr("DataReader::Run", TimeRange::kViolet);
 
     // This is synchronous call for CPU Backend
-    Operator<Backend>::Run(ws);
+    ParseBatch(ws);
 
     for (int sample_idx = 0; sample_idx < Operator<Backend>::batch_size_; sample_idx++) {
       loader_->RecycleTensor(MoveSample(sample_idx));
@@ -166,53 +171,68 @@ class DataReader : public Operator<Backend> {
     return loader_->Size();
   }
 
+  /**
+   * @brief The size of the loaded sample, so that the largest samples are parsed first
+   */
+  int64_t EstimateSampleCost(HostWorkspace *ws, int data_idx) override {
+    return SampleSize(GetSample(data_idx));
+  }
+
+  double LastRunWaitTime() const override {
+    return last_wait_ms_;
+  }
+
   LoadTarget& GetSample(int sample_idx) {
-    return *prefetched_batch_queue_[curr_batch_consumer_][sample_idx];
+    return *prefetched_batch_queue_.ReadSlot()[sample_idx];
   }
 
   LoadTargetPtr MoveSample(int sample_idx) {
-    auto &sample = prefetched_batch_queue_[curr_batch_consumer_][sample_idx];
+    auto &sample = prefetched_batch_queue_.ReadSlot()[sample_idx];
     auto sample_ptr = std::move(sample);
     sample = {};
     return sample_ptr;
   }
 
  protected:
-  void ParseIfNeeded(const Tensor<CPUBackend>& tensor, SampleWorkspace* ws) {
-    using OutputCache = std::unordered_map<std::string, std::vector<Tensor<CPUBackend>>>;
-    static OutputCache output_cache;
-    static std::mutex output_cache_mutex;
+  /**
+   * @brief Parses the samples of the current batch on the thread pool of the workspace
+   *
+   * Before the batch is dispatched, the parser can prepare scratch for each thread
+   * of the pool - see Parser::PrepareThreads. The samples are then run through
+   * Operator::Run, the largest ones first (see EstimateSampleCost).
+   */
+  virtual void ParseBatch(HostWorkspace* ws) {
+    if (parser_)
+      parser_->PrepareThreads(ws->GetThreadPool().size());
+    Operator<Backend>::Run(ws);
+  }
 
+  void ParseIfNeeded(const Tensor<CPUBackend>& tensor, SampleWorkspace* ws) {
     const auto& source_info = tensor.GetSourceInfo();
     const auto should_skip_sample = tensor.ShouldSkipSample();
     const std::size_t num_outputs = ws->NumOutput();
 
     if (should_skip_sample) {
-      std::lock_guard<std::mutex> lock(output_cache_mutex);
-      auto it = output_cache.find(source_info);
-      DALI_ENFORCE(it != output_cache.end(),
+      auto cached_outputs = output_cache_.Get(source_info);
+      DALI_ENFORCE(cached_outputs != nullptr,
         "Image `" + source_info + "` should be in cache (cache size: "
-        + std::to_string(output_cache.size()) + ")");
-      auto& cached_outputs = it->second;
-      DALI_ENFORCE(cached_outputs.size() == num_outputs,
+        + std::to_string(output_cache_.size()) + ")");
+      DALI_ENFORCE(cached_outputs->size() == num_outputs,
         "Unexpected number of outputs");
-      for (std::size_t i = 0; i < cached_outputs.size(); i++) {
+      for (std::size_t i = 0; i < cached_outputs->size(); i++) {
         auto& output = ws->Output<CPUBackend>(i);
-        output.Copy(cached_outputs[i], 0);
+        // the parser may have shared the output with the loader's buffer
+        if (output.shares_data())
+          output.Reset();
+        output.Copy((*cached_outputs)[i], 0);
       }
       return;
     }
 
     parser_->Parse(tensor, ws);
 
-    if (skip_cached_images_) {
-      std::lock_guard<std::mutex> lock(output_cache_mutex);
-      if (output_cache.find(source_info) != output_cache.end()) {
-        return;
-      }
-
-      auto& cached_outputs = output_cache[source_info];
-      cached_outputs.resize(num_outputs);
+    if (skip_cached_images_ && !output_cache_.Contains(source_info)) {
+      ParsedOutputCache::Outputs cached_outputs(num_outputs);
 
       // We don't want to cache the image itself
       auto& first_output = cached_outputs[0];
@@ -225,85 +245,55 @@ class DataReader : public Operator<Backend> {
         auto& output = ws->Output<CPUBackend>(i);
         cached_outputs[i].Copy(output, 0);
       }
+      output_cache_.Add(source_info, std::move(cached_outputs));
     }
   }
 
   void ProducerStop(std::exception_ptr error = nullptr) {
-    {
-      std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
-      finished_ = true;
-      if (error)
-        prefetch_error_ = error;
-    }
-    consumer_.notify_all();
+    if (error)
+      prefetch_error_ = error;
+    // Stop publishes prefetch_error_ to the consumer
+    prefetched_batch_queue_.Stop();
   }
 
-  void ProducerAdvanceQueue() {
-    {
-      std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
-      AdvanceIndex(curr_batch_producer_, producer_cycle_);
-    }
-    consumer_.notify_all();
-  }
-
-  void ProducerWait() {
-    std::unique_lock<std::mutex> lock(prefetch_access_mutex_);
-    producer_.wait(lock, [&]() { return finished_ || !IsPrefetchQueueFull(); });
+  // Waits for a free slot in the queue, returns false if prefetching was stopped
+  bool ProducerWait() {
+    DALI_TRACE_SCOPE("DataReader::ProducerWait");
+    return prefetched_batch_queue_.AcquireWrite();
   }
 
   void ConsumerWait() {
-    TimeRange tr("DataReader::ConsumerWait #" + to_string(curr_batch_consumer_),
-                 TimeRange::kMagenta);
-    std::unique_lock<std::mutex> prefetch_lock(prefetch_access_mutex_);
-    consumer_.wait(prefetch_lock, [this]() { return finished_ || !IsPrefetchQueueEmpty(); });
+    TimeRange tr("DataReader::ConsumerWait", TimeRange::kMagenta);
+    auto start = std::chrono::steady_clock::now();
+    bool batch_ready = prefetched_batch_queue_.AcquireRead();
+    last_wait_ms_ = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
     if (prefetch_error_) std::rethrow_exception(prefetch_error_);
+    DALI_ENFORCE(batch_ready, "Prefetching was stopped before the batch was produced");
   }
 
   void ConsumerAdvanceQueue() {
-    {
-      std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
-      AdvanceIndex(curr_batch_consumer_, consumer_cycle_);
-    }
-    producer_.notify_one();
-  }
-
-  void AdvanceIndex(int& index, bool& cycle) {
-    index = (index + 1) % prefetch_queue_depth_;
-    if (index == 0) cycle = !cycle;
-  }
-
-  bool IsPrefetchQueueEmpty() {
-    return curr_batch_producer_ == curr_batch_consumer_
-           && consumer_cycle_ == producer_cycle_;
-  }
-
-  bool IsPrefetchQueueFull() {
-    return curr_batch_producer_ == curr_batch_consumer_
-           && consumer_cycle_ != producer_cycle_;
+    prefetched_batch_queue_.ReleaseRead();
   }
 
   std::thread prefetch_thread_;
 
-  // mutex to control access to the producer
+  // mutex to control starting of the prefetch thread
   std::mutex prefetch_access_mutex_;
 
-  // signals for producer and consumer
-  std::condition_variable producer_, consumer_;
-
-  // signal that the prefetch thread has finished
-  std::atomic<bool> finished_;
-
   // prefetched batch
   int prefetch_queue_depth_;
   bool skip_cached_images_;
+  // time the last Run spent in ConsumerWait
+  double last_wait_ms_ = 0;
   using BatchQueueElement = std::vector<LoadTargetPtr>;
-  std::vector<BatchQueueElement> prefetched_batch_queue_;
-  int curr_batch_consumer_;
-  int curr_batch_producer_;
-  bool consumer_cycle_;
-  bool producer_cycle_;
+  // lock-free handoff of batches between the prefetch thread and Run
+  SPSCRing<BatchQueueElement> prefetched_batch_queue_;
   int device_id_;
 
+  // workers reading the samples of a batch in parallel, null if reading is serial
+  std::unique_ptr<ThreadPool> prefetch_thread_pool_;
+
   // keep track of how many samples have been processed over all threads.
   std::atomic<int> samples_processed_;
 
@@ -315,6 +305,19 @@ class DataReader : public Operator<Backend> {
 
   // Parser
   std::unique_ptr<Parser<ParseTarget>> parser_;
+
+  // outputs of the parsed samples, returned for the samples skipped with skip_cached_images
+  ParsedOutputCache output_cache_;
+
+ private:
+  static int64_t SampleSize(const Tensor<CPUBackend> &sample) {
+    return sample.size();
+  }
+
+  template <typename T>
+  static int64_t SampleSize(const T &) {
+    return 0;
+  }
 };
 
 #define USE_READER_OPERATOR_MEMBERS_1(Backend, LoadTarget) \
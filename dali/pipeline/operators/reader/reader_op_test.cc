@@ -14,6 +14,7 @@
 
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <string>
@@ -105,6 +106,54 @@ DALI_SCHEMA(DummyDataReader)
   .NumOutput(1)
   .AddParent("LoaderBase");
 
+/**
+ * @brief Counts the parsed samples in per-thread scratch, which fails if the thread index
+ *        is out of the range announced in PrepareThreads
+ */
+class ScratchParser : public Parser<Tensor<CPUBackend>> {
+ public:
+  explicit ScratchParser(const OpSpec &spec) : Parser<Tensor<CPUBackend>>(spec) {}
+
+  void Parse(const Tensor<CPUBackend> &data, SampleWorkspace *ws) override {
+    scratch_[ws->thread_idx()]++;
+    total_parsed++;
+    ws->Output<CPUBackend>(0).Copy(data, 0);
+  }
+
+  void PrepareThreads(int num_threads) override {
+    scratch_.Resize(num_threads);
+  }
+
+  static std::atomic<int> total_parsed;
+
+ private:
+  PerThreadScratch<int> scratch_;
+};
+
+std::atomic<int> ScratchParser::total_parsed{0};
+
+class ParsingDataReader : public DataReader<CPUBackend, Tensor<CPUBackend>> {
+ public:
+  explicit ParsingDataReader(const OpSpec &spec)
+      : DataReader<CPUBackend, Tensor<CPUBackend>>(spec) {
+    loader_ = InitLoader<DummyLoader>(spec);
+    parser_.reset(new ScratchParser(spec));
+  }
+
+  void RunImpl(SampleWorkspace* ws, int idx) override {
+    ParseIfNeeded(GetSample(ws->data_idx()), ws);
+  }
+};
+
+DALI_REGISTER_OPERATOR(ParsingDataReader, ParsingDataReader, CPU);
+
+DALI_SCHEMA(ParsingDataReader)
+  .DocStr("Dummy")
+  .OutputFn([](const OpSpec& spec) { return 1; })
+  .NumInput(0)
+  .NumOutput(1)
+  .AddParent("LoaderBase");
+
 template <typename Backend>
 class ReaderTest : public DALITest {
  public:
@@ -156,6 +205,26 @@ TYPED_TEST(ReaderTest, PrefetchQueueTest) {
   return;
 }
 
+TYPED_TEST(ReaderTest, ParseBatchTest) {
+  Pipeline pipe(32, 4, 0);
+
+  pipe.AddOperator(
+      OpSpec("ParsingDataReader")
+      .AddOutput("data_out", "cpu"));
+
+  std::vector<std::pair<string, string>> outputs = {{"data_out", "cpu"}};
+  pipe.Build(outputs);
+
+  ScratchParser::total_parsed = 0;
+  DeviceWorkspace ws;
+  for (int i = 0; i < 3; ++i) {
+    pipe.RunCPU();
+    pipe.RunGPU();
+    pipe.Outputs(&ws);
+  }
+  EXPECT_EQ(ScratchParser::total_parsed, 3 * 32);
+}
+
 TYPED_TEST(ReaderTest, LazyInitTest) {
   Pipeline eager_pipe(32, 1, 0);
   Pipeline lazy_pipe(32, 1, 0);
@@ -32,7 +32,8 @@ DALI_SCHEMA(_TFRecordReaderBase)
   .AddArg("index_path",
       R"code(List of paths to index files (1 index file for every TFRecord file).
 Index files may be obtained from TFRecord files using
-`tfrecord2idx` script distributed with DALI.)code",
+`tfrecord2idx` script distributed with DALI. Text index files can be converted
+with the `idx2bin` script to a binary format, which is memory-mapped instead of parsed.)code",
       DALI_STRING_VEC);
 
 DALI_SCHEMA(_TFRecordReader)
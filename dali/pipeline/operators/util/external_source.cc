@@ -18,28 +18,27 @@ namespace dali {
 
 template<>
 void ExternalSource<CPUBackend>::RunImpl(SampleWorkspace *ws, const int idx) {
-  // Wrap the output tensor around our data
   auto &output = ws->Output<CPUBackend>(idx);
   cudaStream_t stream = ws->has_stream() ? ws->stream() : 0;
-  if (data_in_tl_) {
-    DALI_ENFORCE(OperatorBase::batch_size_ == static_cast<int>(tl_data_.ntensor()),
-      "Data list provided to ExternalSource needs to have batch_size length.");
-    output.Copy(tl_data_, ws->data_idx(), stream);
+  auto &batch = AcquireBatch();
+  SampleReleaser releaser(this, 1);
+  const int data_idx = ws->data_idx();
+  if (batch.shared) {
+    // Wrap the output tensor around the caller's data
+    auto &data = batch.tensors[data_idx];
+    output.ShareData(&data);
+    output.SetLayout(data.GetLayout());
+    output.SetSourceInfo(data.GetSourceInfo());
+    output.SetSkipSample(data.ShouldSkipSample());
   } else {
-    DALI_ENFORCE(OperatorBase::batch_size_ == static_cast<int>(t_data_.size()),
-      "Data list provided to ExternalSource needs to have batch_size length.");
-    auto &data = t_data_[ws->data_idx()];
-    output.Copy(data, stream);
-  }
-
-  std::lock_guard<std::mutex> l(samples_processed_m_);
-  if (++samples_processed_ >= batch_size_) {
-    samples_processed_ = 0;
-    {
-      std::lock_guard<std::mutex> busy_lock(busy_m_);
-      busy_ = false;
+    // the output may still reference the data shared in one of the previous iterations
+    if (output.shares_data())
+      output.Reset();
+    if (batch.in_tl) {
+      output.Copy(batch.tl, data_idx, stream);
+    } else {
+      output.Copy(batch.tensors[data_idx], stream);
     }
-    cv_.notify_one();
   }
 }
 
@@ -53,6 +52,9 @@ supported in TensorFlow. It is worth noting that fed inputs should match the num
 expected by the next operator in the pipeline (e.g. NHWC will expect 3-dimensional tensors
 where the last dimension represents the different channels).)code")
   .NumInput(0)
-  .NumOutput(1);
+  .NumOutput(1)
+  .AddOptionalArg("queue_depth",
+      R"code(Number of batches that can be fed in advance. Feeding blocks while
+this many batches are waiting for the pipeline.)code", 1);
 
 }  // namespace dali
@@ -18,15 +18,18 @@ namespace dali {
 
 template<>
 void ExternalSource<GPUBackend>::RunImpl(DeviceWorkspace *ws, const int idx) {
-  DALI_ENFORCE(data_in_tl_, "Cannot feed non-contiguous data to GPU op.");
-
   auto &output = ws->Output<GPUBackend>(idx);
-  output.Copy(tl_data_, (ws->has_stream() ? ws->stream() : 0));
-  {
-    std::lock_guard<std::mutex> busy_lock(busy_m_);
-    busy_ = false;
+  auto &batch = AcquireBatch();
+  SampleReleaser releaser(this, batch_size_);
+  DALI_ENFORCE(batch.in_tl, "Cannot feed non-contiguous data to GPU op.");
+  if (batch.shared) {
+    output.ShareData(&batch.tl);
+    output.SetLayout(batch.tl.GetLayout());
+  } else {
+    if (output.shares_data())
+      output.Reset();
+    output.Copy(batch.tl, (ws->has_stream() ? ws->stream() : 0));
   }
-  cv_.notify_all();
 }
 
 DALI_REGISTER_OPERATOR(ExternalSource, ExternalSource<GPUBackend>, GPU);
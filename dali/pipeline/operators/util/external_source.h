@@ -15,8 +15,11 @@
 #ifndef DALI_PIPELINE_OPERATORS_UTIL_EXTERNAL_SOURCE_H_
 #define DALI_PIPELINE_OPERATORS_UTIL_EXTERNAL_SOURCE_H_
 
-#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <condition_variable>
 #include <mutex>
@@ -25,18 +28,27 @@
 
 namespace dali {
 
+/**
+ * @brief Called when the pipeline no longer uses the data passed to ExternalSource
+ *        without copying. May be called from any thread.
+ */
+using ExternalSourceRelease = std::function<void()>;
+
 /**
  * @brief Provides in-graph access to data fed in from outside of dali.
- * For now, we do a copy from the passed in data into our data to avoid
- * potential scoping and data corruption issues.
+ *
+ * The data is either copied, to avoid potential scoping and data corruption issues,
+ * or shared with the caller, who is notified when the pipeline is done with it.
+ * Up to `queue_depth` batches can be fed ahead of the pipeline; feeding blocks
+ * while the queue is full.
  */
 template <typename Backend>
 class ExternalSource : public Operator<Backend> {
  public:
   inline explicit ExternalSource(const OpSpec &spec) :
     Operator<Backend>(spec),
-    samples_processed_(0),
-    busy_(false) {
+    queue_depth_(spec.GetArgument<int>("queue_depth")) {
+    DALI_ENFORCE(queue_depth_ >= 1, "ExternalSource queue_depth must be positive.");
     output_name_ = spec.Output(0);
   }
 
@@ -48,41 +60,91 @@ class ExternalSource : public Operator<Backend> {
 
   /**
    * @brief Sets the data that should be passed out of the op
-   * on the next iteration.
+   * on one of the next iterations.
    */
   inline void SetDataSource(const TensorList<Backend> &tl) {
-    DALI_ENFORCE(OperatorBase::batch_size_ == static_cast<int>(tl.ntensor()),
-      "Data list provided to ExternalSource needs to have batch_size length.");
+    CheckBatchSize(tl.ntensor());
     // Note: If we create a GPU source, we will need to figure
     // out what stream we want to do this copy in. CPU we can
     // pass anything as it is ignored.
-    std::unique_lock<std::mutex> lock(busy_m_);
-    cv_.wait(lock,  [this]{return !this->busy_;});
-    tl_data_.Copy(tl, 0);
-    data_in_tl_ = true;
-    busy_ = true;
+    FeedBatch([&](Batch &batch) {
+      batch.tl.Copy(tl, 0);
+      batch.in_tl = true;
+      batch.shared = false;
+    });
   }
 
   /**
    * @brief Sets the data that should be passed out of the op
-   * on the next iteration.
+   * on one of the next iterations.
    */
   inline void SetDataSource(const vector<Tensor<Backend>> &t) {
-    DALI_ENFORCE(OperatorBase::batch_size_ == static_cast<int>(t.size()),
-      "Data list provided to ExternalSource needs to have batch_size length.");
-    // Note: If we create a GPU source, we will need to figure
-    // out what stream we want to do this copy in. CPU we can
-    // pass anything as it is ignored.
+    CheckBatchSize(t.size());
+    FeedBatch([&](Batch &batch) {
+      batch.tensors.resize(t.size());
+      for (size_t i = 0; i < t.size(); ++i) {
+        batch.tensors[i].Copy(t[i], 0);
+      }
+      batch.in_tl = false;
+      batch.shared = false;
+    });
+  }
 
-    std::unique_lock<std::mutex> lock(busy_m_);
-    cv_.wait(lock,  [this]{return !this->busy_;});
+  /**
+   * @brief Passes the data out of the op on one of the next iterations, without copying.
+   *
+   * The caller must keep the memory intact until `release` is called. This happens when
+   * the data is no longer referenced by the pipeline - usually when the buffers the data
+   * was passed to are reused, a few iterations later - and at the latest when
+   * the pipeline is destroyed.
+   */
+  inline void ShareDataSource(const TensorList<Backend> &tl, ExternalSourceRelease release) {
+    CheckBatchSize(tl.ntensor());
+    auto owner = MakeOwner(std::move(release));
+    FeedBatch([&](Batch &batch) {
+      batch.shared = true;
+      batch.in_tl = true;
+      // the whole list, for GPU...
+      batch.tl.ShareData(AliasOwner(owner, tl.raw_data()), tl.size() * tl.type().size());
+      batch.tl.set_type(tl.type());
+      batch.tl.Resize(tl.shape());
+      batch.tl.SetLayout(tl.GetLayout());
+      // ...and the samples, so that each of them keeps the data referenced
+      batch.tensors.resize(tl.ntensor());
+      for (size_t i = 0; i < tl.ntensor(); ++i) {
+        auto &t = batch.tensors[i];
+        t.ShareData(AliasOwner(owner, tl.raw_tensor(i)),
+                    volume(tl.tensor_shape(i)) * tl.type().size(), tl.tensor_shape(i));
+        t.set_type(tl.type());
+        t.SetLayout(tl.GetLayout());
+        t.SetSourceInfo(tl.GetSourceInfo(i));
+        t.SetSkipSample(tl.ShouldSkipSample(i));
+      }
+    });
+  }
 
-    t_data_.resize(t.size());
-    for (size_t i = 0; i < t.size(); ++i) {
-      t_data_[i].Copy(t[i], 0);
-    }
-    data_in_tl_ = false;
-    busy_ = true;
+  /**
+   * @brief Passes the data out of the op on one of the next iterations, without copying.
+   *
+   * See ShareDataSource(const TensorList<Backend> &, ExternalSourceRelease).
+   */
+  inline void ShareDataSource(const vector<Tensor<Backend>> &t, ExternalSourceRelease release) {
+    CheckBatchSize(t.size());
+    auto owner = MakeOwner(std::move(release));
+    FeedBatch([&](Batch &batch) {
+      batch.shared = true;
+      batch.in_tl = false;
+      batch.tensors.resize(t.size());
+      for (size_t i = 0; i < t.size(); ++i) {
+        auto &dst = batch.tensors[i];
+        dst.ShareData(AliasOwner(owner, t[i].raw_data()), t[i].size() * t[i].type().size(),
+                      t[i].shape());
+        dst.set_type(t[i].type());
+        dst.SetLayout(t[i].GetLayout());
+        dst.SetSourceInfo(t[i].GetSourceInfo());
+        dst.SetSkipSample(t[i].ShouldSkipSample());
+      }
+    });
   }
 
   DISABLE_COPY_MOVE_ASSIGN(ExternalSource);
@@ -90,17 +152,155 @@ class ExternalSource : public Operator<Backend> {
  protected:
   void RunImpl(Workspace<Backend> *ws, const int idx) override;
 
+  struct Batch {
+    TensorList<Backend> tl;
+    std::vector<Tensor<Backend>> tensors;
+    bool in_tl = true;
+    /// If set, the data is owned by the caller and both `tl` and `tensors` reference it
+    bool shared = false;
+
+    void Reset() {
+      tl.Reset();
+      for (auto &t : tensors)
+        t.Reset();
+      shared = false;
+    }
+  };
+
+  inline void CheckBatchSize(size_t size) const {
+    DALI_ENFORCE(OperatorBase::batch_size_ == static_cast<int>(size),
+      "Data list provided to ExternalSource needs to have batch_size length.");
+  }
+
+  /// @brief Calls `release` when the last pointer obtained from AliasOwner is gone
+  static std::shared_ptr<void> MakeOwner(ExternalSourceRelease release) {
+    DALI_ENFORCE(static_cast<bool>(release), "Release callback must not be empty.");
+    return std::shared_ptr<void>(static_cast<void *>(nullptr),
+                                 [release](void *) { release(); });
+  }
+
+  static std::shared_ptr<void> AliasOwner(const std::shared_ptr<void> &owner, const void *ptr) {
+    return std::shared_ptr<void>(owner, const_cast<void *>(ptr));
+  }
+
+  /**
+   * @brief Waits for a free slot in the queue, fills a batch outside of the lock,
+   *        so that the pipeline is not blocked, and enqueues it.
+   */
+  template <typename Fill>
+  void FeedBatch(Fill &&fill) {
+    std::unique_ptr<Batch> batch;
+    {
+      std::unique_lock<std::mutex> lock(queue_m_);
+      cv_.wait(lock, [this]() {
+        return static_cast<int>(queue_.size()) + batches_filled_ < queue_depth_;
+      });
+      batches_filled_++;
+      if (free_batches_.empty()) {
+        batch.reset(new Batch());
+      } else {
+        batch = std::move(free_batches_.back());
+        free_batches_.pop_back();
+      }
+    }
+
+    try {
+      fill(*batch);
+    } catch (...) {
+      batch->Reset();
+      std::lock_guard<std::mutex> lock(queue_m_);
+      batches_filled_--;
+      free_batches_.push_back(std::move(batch));
+      cv_.notify_all();
+      throw;
+    }
+
+    std::lock_guard<std::mutex> lock(queue_m_);
+    batches_filled_--;
+    queue_.push_back(std::move(batch));
+  }
+
+  /**
+   * @brief Returns the batch for the current iteration
+   *
+   * The first call in an iteration takes the next batch from the queue. If nothing was fed,
+   * the previous batch is used again, unless it was shared with the caller.
+   */
+  Batch &AcquireBatch() {
+    std::lock_guard<std::mutex> lock(queue_m_);
+    if (!current_) {
+      if (!queue_.empty()) {
+        current_ = std::move(queue_.front());
+        queue_.pop_front();
+        if (last_) {
+          free_batches_.push_back(std::move(last_));
+        }
+        cv_.notify_all();
+      } else {
+        DALI_ENFORCE(last_ != nullptr, "No data was provided to " + name() + ".");
+        current_ = std::move(last_);
+      }
+    }
+    return *current_;
+  }
+
+  /**
+   * @brief Marks samples of the current batch as processed when it goes out of scope,
+   *        also when the run throws - otherwise the batch would never be released
+   */
+  class SampleReleaser {
+   public:
+    SampleReleaser(ExternalSource *source, int count) : source_(source), count_(count) {}
+    ~SampleReleaser() {
+      source_->ReleaseSamples(count_);
+    }
+
+    DISABLE_COPY_MOVE_ASSIGN(SampleReleaser);
+
+   private:
+    ExternalSource *source_;
+    int count_;
+  };
+
+  /**
+   * @brief Marks `count` samples of the current batch as processed
+   */
+  void ReleaseSamples(int count) {
+    std::unique_ptr<Batch> shared_batch;
+    {
+      std::lock_guard<std::mutex> lock(queue_m_);
+      samples_processed_ += count;
+      if (samples_processed_ < OperatorBase::batch_size_)
+        return;
+      samples_processed_ = 0;
+      if (current_->shared)
+        shared_batch = std::move(current_);
+      else
+        last_ = std::move(current_);
+    }
+    if (!shared_batch)
+      return;
+    // Drop our references to the shared data outside of the lock, as this may call
+    // the release callback; the outputs keep the data until they are reused.
+    shared_batch->Reset();
+    std::lock_guard<std::mutex> lock(queue_m_);
+    free_batches_.push_back(std::move(shared_batch));
+  }
+
   string output_name_;
-  TensorList<Backend> tl_data_;
-  std::vector<Tensor<Backend>> t_data_;
-  bool data_in_tl_;
+  int queue_depth_;
 
-  int samples_processed_;
+  /// Batches fed and not yet taken by the pipeline
+  std::deque<std::unique_ptr<Batch>> queue_;
+  /// The batch of the current iteration and the previous one, if it can be repeated
+  std::unique_ptr<Batch> current_, last_;
+  /// Batches available for reuse, so that copying does not reallocate
+  std::vector<std::unique_ptr<Batch>> free_batches_;
+  int batches_filled_ = 0;
+  int samples_processed_ = 0;
 
-  bool busy_;
   std::condition_variable cv_;
-  std::mutex busy_m_;
-  std::mutex samples_processed_m_;
+  std::mutex queue_m_;
 };
 
 }  // namespace dali
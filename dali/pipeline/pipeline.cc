@@ -400,6 +400,8 @@ void Pipeline::Build(vector<std::pair<string, string>> output_names) {
   executor_ = GetExecutor(pipelined_execution_, separated_execution_, async_execution_, batch_size_,
                           num_threads_, device_id_, bytes_per_sample_hint_, set_affinity_,
                           max_num_stream_, default_cuda_stream_priority_, prefetch_queue_depth_);
+  executor_->SetDepthFirstCPU(depth_first_cpu_);
+  executor_->SetBufferGrowthPolicy(buffer_growth_policy_);
   executor_->Init();
 
   // Creating the graph
@@ -679,6 +681,26 @@ OpNode * Pipeline::GetOperatorNode(const std::string& name) {
   return &(graph_.Node(name));
 }
 
+OperatorTimings Pipeline::GetOperatorTimings() const {
+  DALI_ENFORCE(built_, "\"Build()\" must be called prior to querying operator timings.");
+  return executor_->GetOperatorTimings();
+}
+
+ExecutorStats Pipeline::GetStats() const {
+  DALI_ENFORCE(built_, "\"Build()\" must be called prior to querying statistics.");
+  return executor_->GetStats();
+}
+
+void Pipeline::ResetStats() {
+  DALI_ENFORCE(built_, "\"Build()\" must be called prior to resetting statistics.");
+  executor_->ResetStats();
+}
+
+size_t Pipeline::GetReallocationCount() const {
+  DALI_ENFORCE(built_, "\"Build()\" must be called prior to querying reallocation count.");
+  return executor_->GetReallocationCount();
+}
+
 std::map<std::string, Index> Pipeline::EpochSize() {
   std::map<std::string, Index> ret;
   for (Index i = 0; i < graph_.NumOp(OpType::CPU); ++i) {
@@ -101,8 +101,10 @@ class DLL_PUBLIC Pipeline {
 
   /**
    * @brief Creates a placeholder for an external input with the given name
+   *
+   * Up to `queue_depth` batches can be set in advance, before `SetExternalInput` blocks.
    */
-  DLL_PUBLIC inline void AddExternalInput(const string &name) {
+  DLL_PUBLIC inline void AddExternalInput(const string &name, int queue_depth = 1) {
     DALI_ENFORCE(!built_, "Alterations to the pipeline after "
         "\"Build()\" has been called are not allowed");
     // Verify that this name is unique and record it
@@ -121,6 +123,7 @@ class DLL_PUBLIC Pipeline {
     OpSpec spec =
       OpSpec("ExternalSource")
       .AddArg("device", "cpu")
+      .AddArg("queue_depth", queue_depth)
       .AddOutput(name, "cpu");
     PrepareOpSpec(&spec);
     graph_.AddOp(spec, "__ExternalInput_" + name);
@@ -130,12 +133,10 @@ class DLL_PUBLIC Pipeline {
   /**
    * @brief Helper function for the SetExternalInput.
    */
-  template <typename T>
-  inline void SetExternalInputHelper(const string &name,
-      const T &tl) {
+  inline ExternalSource<CPUBackend> *GetExternalSource(const string &name) {
     if (!graph_.TensorExists(name + "_cpu")) {
       // Trying to set data for non existing node is a noop
-      return;
+      return nullptr;
     }
     OpNodeId node_id = graph_.TensorSourceID(name + "_cpu");
     DALI_ENFORCE(graph_.NodeType(node_id) == OpType::CPU,
@@ -147,7 +148,29 @@ class DLL_PUBLIC Pipeline {
       dynamic_cast<ExternalSource<CPUBackend>*>(op_ptr);
     DALI_ENFORCE(source != nullptr, "Input name '" +
         name + "' is not marked as an external input.");
-    source->SetDataSource(tl);
+    return source;
+  }
+
+  /**
+   * @brief Helper function for the SetExternalInput.
+   */
+  template <typename T>
+  inline void SetExternalInputHelper(const string &name,
+      const T &tl) {
+    if (auto *source = GetExternalSource(name))
+      source->SetDataSource(tl);
+  }
+
+  /**
+   * @brief Helper function for the SetExternalInput.
+   */
+  template <typename T>
+  inline void SetExternalInputHelper(const string &name,
+      const T &tl, ExternalSourceRelease release) {
+    if (auto *source = GetExternalSource(name))
+      source->ShareDataSource(tl, std::move(release));
+    else if (release)
+      release();
   }
 
   /**
@@ -168,6 +191,28 @@ class DLL_PUBLIC Pipeline {
     SetExternalInputHelper(name, tl);
   }
 
+  /**
+   * @brief Sets the external input with the input name to the
+   * input data, without copying it.
+   *
+   * The data must stay valid until `release` is called, see ExternalSource::ShareDataSource.
+   */
+  DLL_PUBLIC inline void SetExternalInput(const string &name,
+      const TensorList<CPUBackend> &tl, ExternalSourceRelease release) {
+    SetExternalInputHelper(name, tl, std::move(release));
+  }
+
+  /**
+   * @brief Sets the external input with the input name to the
+   * input data, without copying it.
+   *
+   * The data must stay valid until `release` is called, see ExternalSource::ShareDataSource.
+   */
+  DLL_PUBLIC inline void SetExternalInput(const string &name,
+      const vector<Tensor<CPUBackend>> &tl, ExternalSourceRelease release) {
+    SetExternalInputHelper(name, tl, std::move(release));
+  }
+
   /**
    * @brief Adds an Operator with the input specification to the pipeline. The
    * 'device' argument in the OpSpec determines whether the CPU or GPU version
@@ -211,6 +256,29 @@ class DLL_PUBLIC Pipeline {
     async_execution_ = async_execution;
   }
 
+  /**
+   * @brief Run chains of per-sample CPU operators depth-first, pushing each sample
+   * through the whole chain in one thread pool task instead of running the ops one by one
+   * over the whole batch.
+   *
+   * Must be called before Build()
+   */
+  DLL_PUBLIC void SetDepthFirstCPUExecution(bool depth_first_cpu = true) {
+    DALI_ENFORCE(!built_, "Alterations to the pipeline after "
+        "\"Build()\" has been called are not allowed - cannot change execution type.");
+    depth_first_cpu_ = depth_first_cpu;
+  }
+
+  /**
+   * @brief Sets the growth policy of the buffers that hold operator outputs.
+   *
+   * Must be called before Build()
+   */
+  DLL_PUBLIC void SetBufferGrowthPolicy(const BufferGrowthPolicy &policy) {
+    DALI_ENFORCE(!built_, "Alterations to the pipeline after "
+        "\"Build()\" has been called are not allowed - cannot change buffer growth policy.");
+    buffer_growth_policy_ = policy;
+  }
 
   /**
    * @brief Set queue sizes for Pipeline using Separated Queues
@@ -301,6 +369,33 @@ class DLL_PUBLIC Pipeline {
    */
   DLL_PUBLIC std::map<std::string, Index> EpochSize();
 
+  /**
+   * @brief Returns the (node name, timing) map with the wall time spent by the
+   * operators on whole batches and the size of their outputs.
+   */
+  DLL_PUBLIC OperatorTimings GetOperatorTimings() const;
+
+  /**
+   * @brief Returns the operator timings together with the time each stage waited
+   * for a batch and the occupancy of its queue - useful to tell whether the pipeline
+   * is bound by the CPU, the GPU, the readers or its consumer.
+   */
+  DLL_PUBLIC ExecutorStats GetStats() const;
+
+  /**
+   * @brief Clears the statistics, so that the next GetStats() covers only the
+   * iterations run from now on.
+   */
+  DLL_PUBLIC void ResetStats();
+
+  /**
+   * @brief Returns how many times the buffers holding operator outputs were reallocated
+   * since the pipeline was built - useful for tuning the buffer growth policy.
+   * Can be called while iterations are running; a stage's reallocations are counted
+   * once that stage finishes its run.
+   */
+  DLL_PUBLIC size_t GetReallocationCount() const;
+
   /**
    * @brief Returns the number of threads used by the pipeline.
    */
@@ -382,6 +477,8 @@ class DLL_PUBLIC Pipeline {
   bool pipelined_execution_;
   bool separated_execution_;
   bool async_execution_;
+  bool depth_first_cpu_ = false;
+  BufferGrowthPolicy buffer_growth_policy_;
   size_t bytes_per_sample_hint_;
   int set_affinity_;
   int max_num_stream_;
@@ -17,6 +17,11 @@
 #include <cuda_runtime_api.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
 #include "dali/core/common.h"
 #include "dali/pipeline/data/backend.h"
 #include "dali/pipeline/data/buffer.h"
@@ -592,6 +597,93 @@ TEST_F(PrefetchedPipelineTest, SetQueueSizesFailAfterBuild) {
   ASSERT_THROW(pipe.SetQueueSizes(2, 2), std::runtime_error);
 }
 
+TEST_F(PrefetchedPipelineTest, OperatorTimings) {
+  int batch_size = this->batch_size_;
+  Pipeline pipe(batch_size, 4, 0);
+  pipe.SetExecutionTypes(false, false, false);
+  pipe.AddExternalInput("data");
+  pipe.AddOperator(OpSpec("ImageDecoder")
+          .AddArg("device", "cpu")
+          .AddInput("data", "cpu")
+          .AddOutput("images", "cpu"), "decoder");
+
+  vector<std::pair<string, string>> outputs = {{"images", "cpu"}};
+  ASSERT_THROW(pipe.GetOperatorTimings(), std::runtime_error);
+  pipe.Build(outputs);
+
+  TensorList<CPUBackend> tl;
+  this->MakeJPEGBatch(&tl, batch_size);
+  constexpr int kIters = 3;
+  for (int i = 0; i < kIters; i++) {
+    pipe.SetExternalInput("data", tl);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    DeviceWorkspace ws;
+    pipe.Outputs(&ws);
+  }
+
+  auto timings = pipe.GetOperatorTimings();
+  ASSERT_EQ(timings.count("decoder"), 1);
+  auto &decoder = timings["decoder"];
+  EXPECT_EQ(decoder.run_count, kIters);
+  EXPECT_GT(decoder.total_ms, 0);
+  EXPECT_GE(decoder.max_ms, decoder.last_ms);
+  EXPECT_GE(decoder.total_ms, decoder.max_ms);
+}
+
+TEST_F(PrefetchedPipelineTest, Stats) {
+  int batch_size = this->batch_size_;
+  Pipeline pipe(batch_size, 4, 0);
+  pipe.SetExecutionTypes(false, false, false);
+  pipe.AddExternalInput("data");
+  pipe.AddOperator(OpSpec("ImageDecoder")
+          .AddArg("device", "cpu")
+          .AddInput("data", "cpu")
+          .AddOutput("images", "cpu"), "decoder");
+  pipe.AddOperator(OpSpec("Copy")
+          .AddArg("device", "gpu")
+          .AddInput("images", "gpu")
+          .AddOutput("final_images", "gpu"), "copy");
+
+  vector<std::pair<string, string>> outputs = {{"final_images", "gpu"}};
+  ASSERT_THROW(pipe.GetStats(), std::runtime_error);
+  pipe.Build(outputs);
+
+  TensorList<CPUBackend> tl;
+  this->MakeJPEGBatch(&tl, batch_size);
+  constexpr int kIters = 3;
+  int64_t image_bytes = 0;
+  for (int i = 0; i < kIters; i++) {
+    pipe.SetExternalInput("data", tl);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    DeviceWorkspace ws;
+    pipe.Outputs(&ws);
+    image_bytes += ws.Output<GPUBackend>(0).nbytes();
+  }
+
+  auto stats = pipe.GetStats();
+  ASSERT_EQ(stats.operators.count("decoder"), 1);
+  ASSERT_EQ(stats.operators.count("copy"), 1);
+  EXPECT_EQ(stats.operators["decoder"].run_count, kIters);
+  EXPECT_EQ(stats.operators["decoder"].bytes_produced, image_bytes);
+  EXPECT_EQ(stats.operators["copy"].bytes_produced, image_bytes);
+  for (const char *stage : {"support", "cpu", "mixed", "gpu", "outputs"}) {
+    ASSERT_EQ(stats.stages.count(stage), 1) << stage;
+    auto &st = stats.stages[stage];
+    EXPECT_EQ(st.acquire_count, kIters) << stage;
+    EXPECT_GE(st.max_wait_ms * kIters, st.total_wait_ms) << stage;
+    EXPECT_GE(st.max_ready, st.mean_ready()) << stage;
+  }
+  // The first stage starts with all the buffers free
+  EXPECT_GT(stats.stages["support"].max_ready, 0);
+
+  pipe.ResetStats();
+  stats = pipe.GetStats();
+  EXPECT_TRUE(stats.operators.empty());
+  EXPECT_TRUE(stats.stages.empty());
+}
+
 TEST_F(PrefetchedPipelineTest, TestFillQueues) {
   // Test coprime queue sizes
   constexpr int CPU = 5, GPU = 3;
@@ -677,4 +769,124 @@ TEST_F(PrefetchedPipelineTest, TestFillQueues) {
 }
 
 
+TEST_F(PipelineTestOnce, ExternalSourceQueueAndShare) {
+  constexpr int batch_size = 4, kIters = 3, sample_size = 10;
+  // must outlive the pipeline, which may use the shared data until it is destroyed
+  std::vector<std::vector<int32_t>> data(kIters);
+  std::atomic<int> released{0};
+  {
+    Pipeline pipe(batch_size, 1, 0);
+    pipe.SetExecutionTypes(false, false, false);
+    pipe.AddExternalInput("data", kIters);
+    vector<std::pair<string, string>> outputs = {{"data", "cpu"}};
+    pipe.Build(outputs);
+
+    for (int i = 0; i < kIters; i++) {
+      data[i].resize(batch_size * sample_size);
+      std::iota(data[i].begin(), data[i].end(), i * 1000);
+      TensorList<CPUBackend> tl;
+      tl.ShareData(data[i].data(), data[i].size() * sizeof(int32_t));
+      tl.set_type(TypeInfo::Create<int32_t>());
+      tl.Resize(kernels::uniform_list_shape(batch_size, { sample_size }));
+      // the odd iterations are copied, the others are used without copying
+      if (i % 2)
+        pipe.SetExternalInput("data", tl);
+      else
+        pipe.SetExternalInput("data", tl, [&released]() { released++; });
+    }
+    // all the batches were fed in advance - none of them is released yet
+    EXPECT_EQ(released, 0);
+
+    for (int i = 0; i < kIters; i++) {
+      pipe.RunCPU();
+      pipe.RunGPU();
+      DeviceWorkspace ws;
+      pipe.Outputs(&ws);
+      auto &out = ws.Output<CPUBackend>(0);
+      ASSERT_EQ(out.ntensor(), batch_size);
+      for (int s = 0; s < batch_size; s++) {
+        const int32_t *sample = out.tensor<int32_t>(s);
+        for (int j = 0; j < sample_size; j++)
+          ASSERT_EQ(sample[j], i * 1000 + s * sample_size + j);
+      }
+    }
+
+    TensorList<CPUBackend> bad;
+    bad.Resize(kernels::uniform_list_shape(batch_size + 1, { sample_size }));
+    bad.set_type(TypeInfo::Create<int32_t>());
+    EXPECT_THROW(pipe.SetExternalInput("data", bad), std::runtime_error);
+  }
+  EXPECT_EQ(released, 2);
+}
+
+namespace {
+
+/**
+ * @brief Feeds batches with samples of `sizes` bytes through ExternalSource -> Copy
+ *        and returns how many times the pipeline reallocated its buffers
+ */
+size_t CountReallocations(const BufferGrowthPolicy &policy, const std::vector<int> &sizes) {
+  constexpr int batch_size = 2;
+  Pipeline pipe(batch_size, 1, 0);
+  pipe.SetExecutionTypes(false, false, false);
+  pipe.SetBufferGrowthPolicy(policy);
+  pipe.AddExternalInput("data");
+  pipe.AddOperator(
+      OpSpec("Copy")
+      .AddArg("device", "cpu")
+      .AddInput("data", "cpu")
+      .AddOutput("copy_out", "cpu"));
+  vector<std::pair<string, string>> outputs = {{"copy_out", "cpu"}};
+  pipe.Build(outputs);
+  EXPECT_EQ(pipe.GetReallocationCount(), 0u);
+
+  for (int size : sizes) {
+    TensorList<CPUBackend> tl;
+    tl.set_pinned(false);
+    tl.Resize(kernels::uniform_list_shape(batch_size, { size }));
+    std::memset(tl.mutable_data<uint8_t>(), size & 0xff, tl.size());
+    pipe.SetExternalInput("data", tl);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    DeviceWorkspace ws;
+    pipe.Outputs(&ws);
+    EXPECT_EQ(ws.Output<CPUBackend>(0).tensor_shape(0)[0], size);
+  }
+  return pipe.GetReallocationCount();
+}
+
+}  // namespace
+
+TEST_F(PipelineTestOnce, BufferGrowthPolicy) {
+  // each sample is larger than the previous one by more than the 1kB padding
+  std::vector<int> growing;
+  for (int i = 0; i < 10; i++)
+    growing.push_back(1000 + i * 5000);
+
+  BufferGrowthPolicy exact;
+  size_t exact_reallocs = CountReallocations(exact, growing);
+  EXPECT_GT(exact_reallocs, 0u);
+
+  BufferGrowthPolicy doubling;
+  doubling.growth_factor = 2.0;
+  size_t doubling_reallocs = CountReallocations(doubling, growing);
+  EXPECT_LT(doubling_reallocs, exact_reallocs);
+
+  // the largest sample fits in the initial reservation - nothing is reallocated
+  BufferGrowthPolicy reserved;
+  reserved.min_reservation = 1 << 20;
+  EXPECT_EQ(CountReallocations(reserved, growing), 0u);
+
+  // a single large batch followed by small ones
+  std::vector<int> shrinking = { 1 << 20 };
+  for (int i = 0; i < 10; i++)
+    shrinking.push_back(1000);
+
+  size_t no_shrink_reallocs = CountReallocations(exact, shrinking);
+  BufferGrowthPolicy shrink;
+  shrink.shrink_threshold = 0.25;
+  shrink.shrink_after = 3;
+  EXPECT_GT(CountReallocations(shrink, shrinking), no_shrink_reallocs);
+}
+
 }  // namespace dali
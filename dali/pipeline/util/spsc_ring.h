@@ -0,0 +1,167 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_UTIL_SPSC_RING_H_
+#define DALI_PIPELINE_UTIL_SPSC_RING_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+/**
+ * @brief Bounded single-producer/single-consumer ring of in-place slots.
+ *
+ * The producer obtains a free slot with AcquireWrite(), fills WriteSlot() and publishes it
+ * with CommitWrite(). The consumer waits with AcquireRead(), uses ReadSlot() and gives the slot
+ * back with ReleaseRead(). Slot ownership is handed over through two monotonic atomic counters,
+ * so the fast path takes no lock.
+ *
+ * A side that has to wait first busy-polls for up to `spin_count` iterations and only then
+ * parks on a condition variable. The mutex is touched only when one of the sides is parked.
+ */
+template <typename T>
+class SPSCRing {
+ public:
+  explicit SPSCRing(int capacity, int spin_count = 0)
+      : slots_(capacity), spin_count_(spin_count) {
+    DALI_ENFORCE(capacity > 0, "SPSCRing capacity must be positive");
+    DALI_ENFORCE(spin_count >= 0, "SPSCRing spin count cannot be negative");
+  }
+
+  SPSCRing(const SPSCRing &) = delete;
+  SPSCRing &operator=(const SPSCRing &) = delete;
+
+  /**
+   * @brief Waits until there is a free slot. Returns false if the ring was stopped.
+   */
+  bool AcquireWrite() {
+    Wait(producer_parked_, producer_cv_, [this]() { return stopped_ || !full(); });
+    return !stopped_;
+  }
+
+  T &WriteSlot() {
+    return slots_[head_.load(std::memory_order_relaxed) % slots_.size()];
+  }
+
+  void CommitWrite() {
+    head_.fetch_add(1, std::memory_order_seq_cst);
+    Wake(consumer_parked_, consumer_cv_);
+  }
+
+  /**
+   * @brief Waits until there is a filled slot. Returns false if the ring was stopped
+   *        and nothing is left to be consumed.
+   */
+  bool AcquireRead() {
+    Wait(consumer_parked_, consumer_cv_, [this]() { return stopped_ || !empty(); });
+    return !empty();
+  }
+
+  T &ReadSlot() {
+    return slots_[tail_.load(std::memory_order_relaxed) % slots_.size()];
+  }
+
+  void ReleaseRead() {
+    tail_.fetch_add(1, std::memory_order_seq_cst);
+    Wake(producer_parked_, producer_cv_);
+  }
+
+  /**
+   * @brief Wakes up both sides; all subsequent waits return immediately.
+   */
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(park_mutex_);
+      stopped_ = true;
+    }
+    producer_cv_.notify_all();
+    consumer_cv_.notify_all();
+  }
+
+  bool stopped() const {
+    return stopped_;
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+  }
+
+  bool full() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire)
+           == slots_.size();
+  }
+
+  int capacity() const {
+    return static_cast<int>(slots_.size());
+  }
+
+  // Raw slot access, e.g. for cleanup once both sides are stopped
+  typename std::vector<T>::iterator begin() { return slots_.begin(); }
+  typename std::vector<T>::iterator end() { return slots_.end(); }
+
+ private:
+  template <typename Predicate>
+  void Wait(std::atomic<bool> &parked, std::condition_variable &cv, Predicate ready) {
+    for (int i = 0; i < spin_count_; i++) {
+      if (ready())
+        return;
+      std::this_thread::yield();
+    }
+    if (ready())
+      return;
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    // The store must be ordered before the predicate check in cv.wait and pairs with
+    // the counter update / flag load in Wake, so at least one side sees the other.
+    parked.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    cv.wait(lock, ready);
+    parked.store(false, std::memory_order_relaxed);
+  }
+
+  void Wake(std::atomic<bool> &parked, std::condition_variable &cv) {
+    if (parked.load(std::memory_order_seq_cst)) {
+      std::lock_guard<std::mutex> lock(park_mutex_);
+      cv.notify_one();
+    }
+  }
+
+  std::vector<T> slots_;
+  int spin_count_;
+
+  // Keep the counters on separate cache lines, they are written by different threads.
+  // Padding is used instead of alignas, as the owner is heap-allocated and C++14 `new`
+  // does not honour extended alignment.
+  char pad0_[64];
+  std::atomic<uint64_t> head_{0};
+  char pad1_[64];
+  std::atomic<uint64_t> tail_{0};
+  char pad2_[64];
+
+  std::atomic<bool> stopped_{false};
+  std::atomic<bool> producer_parked_{false};
+  std::atomic<bool> consumer_parked_{false};
+  std::mutex park_mutex_;
+  std::condition_variable producer_cv_, consumer_cv_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_SPSC_RING_H_
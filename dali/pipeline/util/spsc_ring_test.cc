@@ -0,0 +1,81 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "dali/pipeline/util/spsc_ring.h"
+
+namespace dali {
+
+TEST(SPSCRingTest, SingleThreaded) {
+  SPSCRing<int> ring(2);
+  EXPECT_TRUE(ring.empty());
+  ASSERT_TRUE(ring.AcquireWrite());
+  ring.WriteSlot() = 1;
+  ring.CommitWrite();
+  ASSERT_TRUE(ring.AcquireWrite());
+  ring.WriteSlot() = 2;
+  ring.CommitWrite();
+  EXPECT_TRUE(ring.full());
+
+  ASSERT_TRUE(ring.AcquireRead());
+  EXPECT_EQ(ring.ReadSlot(), 1);
+  ring.ReleaseRead();
+  ASSERT_TRUE(ring.AcquireRead());
+  EXPECT_EQ(ring.ReadSlot(), 2);
+  ring.ReleaseRead();
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST(SPSCRingTest, StopWakesWaiters) {
+  SPSCRing<int> ring(1);
+  std::thread consumer([&]() {
+    EXPECT_FALSE(ring.AcquireRead());
+  });
+  ring.Stop();
+  consumer.join();
+  EXPECT_FALSE(ring.AcquireWrite());
+}
+
+class SPSCRingOrderTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(SPSCRingOrderTest, PreservesOrder) {
+  const int spin_count = GetParam();
+  const int n = 10000;
+  SPSCRing<std::vector<int>> ring(3, spin_count);
+  std::thread producer([&]() {
+    for (int i = 0; i < n; i++) {
+      ASSERT_TRUE(ring.AcquireWrite());
+      auto &slot = ring.WriteSlot();
+      slot.assign(4, i);
+      ring.CommitWrite();
+    }
+  });
+  for (int i = 0; i < n; i++) {
+    ASSERT_TRUE(ring.AcquireRead());
+    auto &slot = ring.ReadSlot();
+    ASSERT_EQ(slot.size(), 4u);
+    for (int v : slot)
+      ASSERT_EQ(v, i);
+    ring.ReleaseRead();
+  }
+  producer.join();
+  EXPECT_TRUE(ring.empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(SPSCRingWaitPolicies, SPSCRingOrderTest, ::testing::Values(0, 100));
+
+}  // namespace dali
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <cstdlib>
+#include <numeric>
+#include <string>
+#include <utility>
 
 #include "dali/pipeline/util/thread_pool.h"
 #if NVML_ENABLED
@@ -24,16 +27,20 @@
 namespace dali {
 
 ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity)
-    : threads_(num_thread), running_(true), work_complete_(true), active_threads_(0) {
+    : threads_(num_thread), running_(true), work_complete_(true), pending_(0), queued_(0),
+      next_queue_(0) {
   DALI_ENFORCE(num_thread > 0, "Thread pool must have non-zero size");
 #if NVML_ENABLED
   nvml::Init();
 #endif
+  tl_errors_.resize(num_thread);
+  for (int i = 0; i < num_thread; ++i) {
+    queues_.emplace_back(new WorkerQueue());
+  }
   // Start the threads in the main loop
   for (int i = 0; i < num_thread; ++i) {
     threads_[i] = std::thread(std::bind(&ThreadPool::ThreadMain, this, i, device_id, set_affinity));
   }
-  tl_errors_.resize(num_thread);
 }
 
 ThreadPool::~ThreadPool() {
@@ -55,19 +62,84 @@ ThreadPool::~ThreadPool() {
 
 void ThreadPool::DoWorkWithID(Work work) {
   {
-    // Add work to the queue
+    // Add work to the queue of the next thread
     std::lock_guard<std::mutex> lock(mutex_);
-    work_queue_.push(work);
+    pending_ += 1;
+    queued_ += 1;
     work_complete_ = false;
+    auto &queue = *queues_[next_queue_++ % queues_.size()];
+    std::lock_guard<std::mutex> queue_lock(queue.lock);
+    queue.tasks.emplace_back();
+    queue.tasks.back().work = std::move(work);
   }
   // Signal a thread to complete the work
   condition_.notify_one();
 }
 
+void ThreadPool::DoWorkRange(int64_t begin, int64_t end, RangeWork work) {
+  SubmitRange(begin, end, std::move(work), {});
+}
+
+void ThreadPool::DoWorkLargestFirst(const std::vector<int64_t> &costs, RangeWork work) {
+  const int64_t count = costs.size();
+  std::vector<int64_t> sorted(count);
+  std::iota(sorted.begin(), sorted.end(), 0);
+  std::stable_sort(sorted.begin(), sorted.end(), [&costs](int64_t a, int64_t b) {
+    return costs[a] > costs[b];
+  });
+  // Deal the sorted indices round-robin into the blocks, so every block is sorted as well
+  // and all threads start with an expensive item
+  const int64_t num_blocks = std::min<int64_t>(count, queues_.size());
+  std::vector<int64_t> order(count);
+  for (int64_t b = 0, pos = 0; b < num_blocks; ++b) {
+    for (int64_t i = b; i < count; i += num_blocks) {
+      order[pos++] = sorted[i];
+    }
+  }
+  SubmitRange(0, count, std::move(work), std::move(order));
+}
+
+void ThreadPool::SubmitRange(int64_t begin, int64_t end, RangeWork work,
+                             std::vector<int64_t> order) {
+  if (begin >= end)
+    return;
+  const int64_t count = end - begin;
+  const int64_t num_blocks = std::min<int64_t>(count, queues_.size());
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ += count;
+    queued_ += count;
+    work_complete_ = false;
+    range_works_.push_back(std::move(work));
+    const RangeWork *range_work = &range_works_.back();
+    const int64_t *range_order = nullptr;
+    if (!order.empty()) {
+      range_orders_.push_back(std::move(order));
+      range_order = range_orders_.back().data();
+    }
+    // Blocks differ in size by at most one index, the first ones are larger
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      Task task;
+      task.range_work = range_work;
+      task.range_order = range_order;
+      task.begin = begin + b * (count / num_blocks) + std::min(b, count % num_blocks);
+      task.end = task.begin + count / num_blocks + (b < count % num_blocks);
+      auto &queue = *queues_[(next_queue_ + b) % queues_.size()];
+      std::lock_guard<std::mutex> queue_lock(queue.lock);
+      queue.tasks.push_back(std::move(task));
+    }
+    next_queue_ += num_blocks;
+  }
+  condition_.notify_all();
+}
+
 // Blocks until all work issued to the thread pool is complete
 void ThreadPool::WaitForWork(bool checkForErrors) {
   std::unique_lock<std::mutex> lock(mutex_);
   completed_.wait(lock, [this] { return this->work_complete_; });
+  // No task refers to the range functions anymore
+  range_works_.clear();
+  range_orders_.clear();
 
   if (checkForErrors) {
     // Check for errors
@@ -86,8 +158,73 @@ int ThreadPool::size() const {
   return threads_.size();
 }
 
+bool ThreadPool::TryPop(WorkerQueue &queue, bool steal, Task *task, int64_t *index) {
+  std::lock_guard<std::mutex> lock(queue.lock);
+  if (queue.tasks.empty())
+    return false;
+  Task &top = steal ? queue.tasks.front() : queue.tasks.back();
+  if (top.range_work) {
+    // The owner walks the block forward, thieves take indices from its end
+    task->range_work = top.range_work;
+    task->range_order = top.range_order;
+    *index = steal ? --top.end : top.begin++;
+    if (top.begin < top.end)
+      return true;
+  } else {
+    task->work = std::move(top.work);
+  }
+  if (steal) {
+    queue.tasks.pop_front();
+  } else {
+    queue.tasks.pop_back();
+  }
+  return true;
+}
+
+bool ThreadPool::TryGetWork(int thread_id, Task *task, int64_t *index) {
+  if (TryPop(*queues_[thread_id], false, task, index))
+    return true;
+  const int n = queues_.size();
+  for (int i = 1; i < n; ++i) {
+    if (TryPop(*queues_[(thread_id + i) % n], true, task, index))
+      return true;
+  }
+  return false;
+}
+
+void ThreadPool::RunWork(int thread_id, const Task &task, int64_t index) {
+  // If an error occurs, we save it in tl_errors_. When
+  // WaitForWork is called, we will check for any errors
+  // in the threads and return an error if one occured.
+  try {
+    if (task.range_work) {
+      int64_t data_idx = task.range_order ? task.range_order[index] : index;
+      (*task.range_work)(data_idx, thread_id);
+    } else {
+      task.work(thread_id);
+    }
+  } catch (std::exception &e) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tl_errors_[thread_id].push(e.what());
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tl_errors_[thread_id].push("Caught unknown exception");
+  }
+
+  // Check for complete work; the recheck under the lock guards against
+  // new work submitted in the meantime
+  if (--pending_ == 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ == 0) {
+      work_complete_ = true;
+      completed_.notify_all();
+    }
+  }
+}
+
 void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
   DeviceGuard g(device_id);
+  tracing::SetThreadName("ThreadPool worker " + to_string(thread_id));
   try {
 #if NVML_ENABLED
     if (set_affinity) {
@@ -112,49 +249,20 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
     tl_errors_[thread_id].push("Caught unknown exception");
   }
 
-  while (running_) {
+  while (true) {
+    Task task;
+    int64_t index = 0;
+    if (TryGetWork(thread_id, &task, &index)) {
+      --queued_;
+      RunWork(thread_id, task, index);
+      continue;
+    }
+
     // Block on the condition to wait for work
     std::unique_lock<std::mutex> lock(mutex_);
-    condition_.wait(lock, [this] { return !(running_ && work_queue_.empty()); });
+    condition_.wait(lock, [this] { return !running_ || queued_ > 0; });
     // If we're no longer running, exit the run loop
     if (!running_) break;
-
-    // Get work from the queue & mark
-    // this thread as active
-    Work work = work_queue_.front();
-    work_queue_.pop();
-    bool should_wake_next = !work_queue_.empty();
-    ++active_threads_;
-
-    // Unlock the lock
-    lock.unlock();
-
-    if (should_wake_next) {
-      condition_.notify_one();
-    }
-
-    // If an error occurs, we save it in tl_errors_. When
-    // WaitForWork is called, we will check for any errors
-    // in the threads and return an error if one occured.
-    try {
-      work(thread_id);
-    } catch (std::exception &e) {
-      lock.lock();
-      tl_errors_[thread_id].push(e.what());
-      lock.unlock();
-    } catch (...) {
-      lock.lock();
-      tl_errors_[thread_id].push("Caught unknown exception");
-      lock.unlock();
-    }
-
-    // Mark this thread as idle & check for complete work
-    lock.lock();
-    --active_threads_;
-    if (work_queue_.empty() && active_threads_ == 0) {
-      work_complete_ = true;
-      completed_.notify_one();
-    }
   }
 }
 
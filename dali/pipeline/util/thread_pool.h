@@ -16,8 +16,14 @@
 #define DALI_PIPELINE_UTIL_THREAD_POOL_H_
 
 #include <cstdlib>
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -28,17 +34,46 @@
 
 namespace dali {
 
+/**
+ * @brief Pool of worker threads with per-thread work queues.
+ *
+ * Each worker owns a deque of tasks. A worker takes work from the back of its own deque
+ * and, when it runs dry, steals from the front of the other workers' deques, so a few
+ * long-running items do not leave the rest of the pool idle. The shared mutex is only
+ * used to submit work, to park idle workers and to signal completion.
+ */
 class DLL_PUBLIC ThreadPool {
  public:
   // Basic unit of work that our threads do
   typedef std::function<void(int)> Work;
 
+  // Work done for a single index of a range: (index, thread_id)
+  typedef std::function<void(int64_t, int)> RangeWork;
+
   DLL_PUBLIC ThreadPool(int num_thread, int device_id, bool set_affinity);
 
   DLL_PUBLIC ~ThreadPool();
 
   DLL_PUBLIC void DoWorkWithID(Work work);
 
+  /**
+   * @brief Runs `work` for every index in [begin, end).
+   *
+   * The range is split into one contiguous block per thread, so no task is allocated
+   * per index. Idle threads steal single indices from the end of the other threads' blocks.
+   */
+  DLL_PUBLIC void DoWorkRange(int64_t begin, int64_t end, RangeWork work);
+
+  /**
+   * @brief Runs `work` for every index in [0, costs.size()), starting with the most
+   * expensive ones.
+   *
+   * The indices are sorted by descending cost and dealt round-robin into the per-thread
+   * blocks, so each thread starts with an expensive item and the cheapest ones,
+   * at the ends of the blocks, are left for stealing.
+   */
+  DLL_PUBLIC void DoWorkLargestFirst(const std::vector<int64_t> &costs, RangeWork work);
+
   // Blocks until all work issued to the thread pool is complete
   DLL_PUBLIC void WaitForWork(bool checkForErrors = true);
 
@@ -47,14 +82,45 @@ class DLL_PUBLIC ThreadPool {
   DISABLE_COPY_MOVE_ASSIGN(ThreadPool);
 
  private:
+  // Either a single work item or a block [begin, end) of a range job. If `range_order`
+  // is set, the block refers to positions in it rather than to the indices themselves
+  struct Task {
+    Work work;
+    const RangeWork *range_work = nullptr;
+    const int64_t *range_order = nullptr;
+    int64_t begin = 0, end = 0;
+  };
+
+  struct WorkerQueue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
   DLL_PUBLIC void ThreadMain(int thread_id, int device_id, bool set_affinity);
 
+  // Takes a single unit of work from `queue`; owners work from the back, thieves from the front
+  void SubmitRange(int64_t begin, int64_t end, RangeWork work, std::vector<int64_t> order);
+
+  bool TryPop(WorkerQueue &queue, bool steal, Task *task, int64_t *index);
+
+  bool TryGetWork(int thread_id, Task *task, int64_t *index);
+
+  void RunWork(int thread_id, const Task &task, int64_t index);
+
   vector<std::thread> threads_;
-  std::queue<Work> work_queue_;
+  vector<std::unique_ptr<WorkerQueue>> queues_;
+  // Range functions stay here until WaitForWork, the tasks only refer to them
+  std::list<RangeWork> range_works_;
+  std::list<std::vector<int64_t>> range_orders_;
 
   bool running_;
   bool work_complete_;
-  int active_threads_;
+  // Units of work (single items or range indices) submitted but not finished yet
+  std::atomic<int64_t> pending_;
+  // Units of work submitted but not taken by any thread yet
+  std::atomic<int64_t> queued_;
+  // Round-robin position for submitted work, guarded by mutex_
+  unsigned next_queue_;
   std::mutex mutex_;
   std::condition_variable condition_;
   std::condition_variable completed_;
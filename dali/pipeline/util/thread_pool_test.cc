@@ -0,0 +1,120 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+
+TEST(ThreadPoolTest, DoWorkWithID) {
+  ThreadPool pool(4, 0, false);
+  std::atomic<int> sum(0);
+  for (int i = 1; i <= 100; ++i) {
+    pool.DoWorkWithID([&sum, i](int tid) {
+      EXPECT_GE(tid, 0);
+      EXPECT_LT(tid, 4);
+      sum += i;
+    });
+  }
+  pool.WaitForWork();
+  EXPECT_EQ(sum, 5050);
+}
+
+TEST(ThreadPoolTest, DoWorkRangeVisitsEachIndexOnce) {
+  ThreadPool pool(3, 0, false);
+  for (int n : {0, 1, 2, 7, 1000}) {
+    std::vector<std::atomic<int>> visits(n);
+    for (auto &v : visits)
+      v = 0;
+    pool.DoWorkRange(0, n, [&visits](int64_t idx, int) { visits[idx]++; });
+    pool.WaitForWork();
+    for (int i = 0; i < n; ++i)
+      EXPECT_EQ(visits[i], 1) << "index " << i << " of " << n;
+  }
+}
+
+TEST(ThreadPoolTest, MixedSubmission) {
+  ThreadPool pool(4, 0, false);
+  std::atomic<int64_t> sum(0);
+  pool.DoWorkRange(10, 20, [&sum](int64_t idx, int) { sum += idx; });
+  pool.DoWorkWithID([&sum](int) { sum += 1000; });
+  pool.DoWorkRange(0, 5, [&sum](int64_t idx, int) { sum += idx; });
+  pool.WaitForWork();
+  EXPECT_EQ(sum, 145 + 1000 + 10);
+}
+
+TEST(ThreadPoolTest, ImbalancedRangeIsShared) {
+  // Index 0 blocks until the rest of its block is done, which requires other threads
+  // to steal it
+  ThreadPool pool(2, 0, false);
+  std::atomic<int> done(0);
+  bool stolen = false;
+  pool.DoWorkRange(0, 8, [&](int64_t idx, int) {
+    if (idx == 0) {
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (done < 3 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      stolen = done == 3;
+    } else if (idx < 4) {
+      done++;
+    }
+  });
+  pool.WaitForWork();
+  EXPECT_TRUE(stolen);
+}
+
+TEST(ThreadPoolTest, LargestFirst) {
+  std::vector<int64_t> costs = {3, 10, 1, 7, 7, 0, 42};
+  {
+    // A single thread runs the indices in descending cost order, ties in index order
+    ThreadPool pool(1, 0, false);
+    std::vector<int64_t> executed;
+    pool.DoWorkLargestFirst(costs, [&executed](int64_t idx, int) { executed.push_back(idx); });
+    pool.WaitForWork();
+    EXPECT_EQ(executed, (std::vector<int64_t>{6, 1, 3, 4, 0, 2, 5}));
+  }
+  {
+    ThreadPool pool(3, 0, false);
+    std::vector<std::atomic<int>> visits(costs.size());
+    for (auto &v : visits)
+      v = 0;
+    pool.DoWorkLargestFirst(costs, [&visits](int64_t idx, int) { visits[idx]++; });
+    pool.WaitForWork();
+    for (auto &v : visits)
+      EXPECT_EQ(v, 1);
+  }
+}
+
+TEST(ThreadPoolTest, ErrorsArePropagated) {
+  ThreadPool pool(2, 0, false);
+  pool.DoWorkRange(0, 10, [](int64_t idx, int) {
+    if (idx == 5)
+      throw std::runtime_error("Failure");
+  });
+  EXPECT_THROW(pool.WaitForWork(), std::runtime_error);
+
+  // The pool is still usable afterwards
+  std::atomic<int> count(0);
+  pool.DoWorkRange(0, 10, [&count](int64_t, int) { count++; });
+  pool.WaitForWork();
+  EXPECT_EQ(count, 10);
+}
+
+}  // namespace dali
@@ -61,13 +61,16 @@ class WorkerThread {
  public:
   typedef std::function<void(void)> Work;
 
-  inline WorkerThread(int device_id, bool set_affinity) :
+  /**
+   * @param name name under which the thread is shown in the tracing timeline
+   */
+  inline WorkerThread(int device_id, bool set_affinity, const std::string &name = "") :
     running_(true), work_complete_(true), barrier_(2) {
 #if NVML_ENABLED
     nvml::Init();
 #endif
     thread_ = std::thread(&WorkerThread::ThreadMain,
-        this, device_id, set_affinity);
+        this, device_id, set_affinity, name);
   }
 
   inline ~WorkerThread() {
@@ -148,8 +151,10 @@ class WorkerThread {
   }
 
  private:
-  void ThreadMain(int device_id, bool set_affinity) {
+  void ThreadMain(int device_id, bool set_affinity, std::string name) {
     DeviceGuard g(device_id);
+    if (!name.empty())
+      tracing::SetThreadName(name);
     try {
       if (set_affinity) {
 #if NVML_ENABLED
@@ -27,6 +27,7 @@
 #include "dali/plugin/plugin_manager.h"
 #include "dali/util/half.hpp"
 #include "dali/core/device_guard.h"
+#include "dali/core/tracing.h"
 
 namespace dali {
 namespace python {
@@ -508,6 +509,11 @@ PYBIND11_MODULE(backend_impl, m) {
 
   m.def("GetCxx11AbiFlag", &GetCxx11AbiFlag);
 
+  // Execution timeline, in the Chrome trace event format
+  m.def("StartTracing", &tracing::Start);
+  m.def("StopTracing", &tracing::Stop);
+  m.def("WriteTrace", &tracing::WriteToFile, "path"_a);
+
   // Types
   py::module types_m = m.def_submodule("types");
   types_m.doc() = "Datatypes and options used by DALI";
@@ -730,7 +736,28 @@ PYBIND11_MODULE(backend_impl, m) {
           DALI_ENFORCE(sizes.find(op_name) != sizes.end(),
               "Operator " + op_name + " does not expose valid epoch size.");
           return sizes[op_name];
-        });
+        })
+    .def("stats",
+        [](Pipeline* p) {
+          ExecutorStats stats = p->GetStats();
+          py::dict operators, stages;
+          for (auto &op : stats.operators) {
+            auto &t = op.second;
+            operators[py::str(op.first)] = py::dict(
+                "run_count"_a = t.run_count, "total_ms"_a = t.total_ms,
+                "max_ms"_a = t.max_ms, "last_ms"_a = t.last_ms,
+                "bytes_produced"_a = t.bytes_produced, "wait_ms"_a = t.wait_ms);
+          }
+          for (auto &stage : stats.stages) {
+            auto &st = stage.second;
+            stages[py::str(stage.first)] = py::dict(
+                "acquire_count"_a = st.acquire_count, "total_wait_ms"_a = st.total_wait_ms,
+                "max_wait_ms"_a = st.max_wait_ms, "mean_ready"_a = st.mean_ready(),
+                "max_ready"_a = st.max_ready);
+          }
+          return py::dict("operators"_a = operators, "stages"_a = stages);
+        })
+    .def("reset_stats", &Pipeline::ResetStats);
 
 #define DALI_OPSPEC_ADDARG(T) \
     .def("AddArg", \
@@ -151,6 +151,31 @@ class Pipeline(object):
             return self._pipe.epoch_size(name)
         return self._pipe.epoch_size()
 
+    def stats(self, reset = False):
+        """Execution statistics of a pipeline.
+
+        Returns a dictionary with two entries:
+
+        * `operators` - for each operator: `run_count`, `total_ms`, `max_ms`
+          and `last_ms` of running it on whole batches, `bytes_produced` and,
+          for readers, `wait_ms` spent waiting for the prefetched data.
+        * `stages` - for each stage (`support`, `cpu`, `mixed`, `gpu`) and
+          for the `outputs` handed to the user: `acquire_count`, `total_wait_ms`
+          and `max_wait_ms` spent waiting for a batch, and `mean_ready` and
+          `max_ready` batches that were ready when the stage asked for one.
+
+        Parameters
+        ----------
+        reset : bool, optional, default = False
+            Clear the statistics after reading them.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        stats = self._pipe.stats()
+        if reset:
+            self._pipe.reset_stats()
+        return stats
+
     @staticmethod
     def current(raise_error_if_none = True):
         pipeline = getattr(pipeline_tls, 'current_pipeline', None)
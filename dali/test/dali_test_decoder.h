@@ -103,6 +103,36 @@ class GenericDecoderTest : public DALISingleOpTest<ImgType> {
     }
   }
 
+  void RunTestDecodeToOutput(const ImgSetDescr &imgs, float eps = 5e-2) {
+    this->SetEps(eps);
+    for (size_t imgIdx = 0; imgIdx < imgs.nImages(); ++imgIdx) {
+      auto decoded_image = ImageFactory::CreateImage(
+          imgs.data_[imgIdx], imgs.sizes_[imgIdx], this->img_type_);
+      VerifyDecodeToOutput(decoded_image.get(), imgs, imgIdx);
+    }
+  }
+
+  /**
+   * Decodes `decoded_image` with an output allocator and checks that the result is placed
+   * in the provided memory and matches OpenCV's decoding of imgs[img_id]
+   */
+  void VerifyDecodeToOutput(Image *decoded_image, const ImgSetDescr &imgs, int img_id) {
+    Tensor<CPUBackend> image;
+    decoded_image->SetOutputAllocator([&image](size_t h, size_t w, size_t c) {
+      image.Resize({static_cast<int>(h), static_cast<int>(w), static_cast<int>(c)});
+      return image.mutable_data<uint8_t>();
+    });
+    decoded_image->Decode();
+    const auto dims = decoded_image->GetImageDims();
+    ASSERT_EQ(image.dim(0), static_cast<int>(std::get<0>(dims)));
+    ASSERT_EQ(image.dim(1), static_cast<int>(std::get<1>(dims)));
+    ASSERT_EQ(image.dim(2), static_cast<int>(std::get<2>(dims)));
+    // the image is decoded in place - no separate buffer is used
+    ASSERT_EQ(decoded_image->GetImage().get(), image.data<uint8_t>());
+
+    this->VerifyDecode(image.data<uint8_t>(), image.dim(0), image.dim(1), imgs, img_id);
+  }
+
   void VerifyDecode(const uint8 *img, int h, int w, const ImgSetDescr &imgs,
                     int img_id) const {
     // Compare w/ opencv result
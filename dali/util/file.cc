@@ -17,15 +17,20 @@
 
 #include "dali/util/file.h"
 #include "dali/util/local_file.h"
+#include "dali/util/pread_file.h"
 
 namespace dali {
 
-std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead) {
+std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead,
+                                             bool use_mmap, bool use_o_direct) {
+  std::string path = uri;
   if (uri.find("file://") == 0) {
-    return std::unique_ptr<FileStream>(
-            new LocalFileStream(uri.substr(std::string("file://").size()), read_ahead));
+    path = uri.substr(std::string("file://").size());
+  }
+  if (use_mmap) {
+    return std::unique_ptr<FileStream>(new LocalFileStream(path, read_ahead));
   } else {
-    return std::unique_ptr<FileStream>(new LocalFileStream(uri, read_ahead));
+    return std::unique_ptr<FileStream>(new PreadFileStream(path, use_o_direct));
   }
 }
 
@@ -70,11 +70,24 @@ class DLL_PUBLIC FileStream {
    private:
      unsigned int reserved;
   };
-  static std::unique_ptr<FileStream> Open(const std::string& uri, bool read_ahead);
+  /**
+   * @brief Opens `uri` for reading.
+   *
+   * By default the file is memory-mapped. With `use_mmap` == false it is read with pread,
+   * optionally with O_DIRECT to bypass the page cache.
+   */
+  static std::unique_ptr<FileStream> Open(const std::string& uri, bool read_ahead,
+                                          bool use_mmap = true, bool use_o_direct = false);
 
   virtual void Close() = 0;
   virtual size_t Read(uint8_t * buffer, size_t n_bytes) = 0;
   virtual shared_ptr<void>  Get(size_t n_bytes) = 0;
+  /**
+   * @brief Read and Get at the given position. The current position is neither used
+   *        nor changed, so concurrent calls from several threads are allowed.
+   */
+  virtual size_t ReadAt(uint8_t * buffer, size_t n_bytes, int64 pos) = 0;
+  virtual shared_ptr<void> GetAt(size_t n_bytes, int64 pos) = 0;
   virtual void Seek(int64 pos) = 0;
   virtual size_t Size() const = 0;
   virtual ~FileStream() {}
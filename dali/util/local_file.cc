@@ -173,11 +173,20 @@ void LocalFileStream::Seek(int64 pos) {
 
 // This method saves a memcpy
 shared_ptr<void> LocalFileStream::Get(size_t n_bytes) {
-  if (pos_ + n_bytes > length_) {
+  auto p = GetAt(n_bytes, pos_);
+  if (p) {
+    pos_ += n_bytes;
+  }
+  return p;
+}
+
+shared_ptr<void> LocalFileStream::GetAt(size_t n_bytes, int64 pos) {
+  if (pos < 0 || pos + n_bytes > length_) {
     return nullptr;
   }
   auto tmp = p_;
-  shared_ptr<void> p(ReadAheadHelper(p_, pos_, n_bytes, !read_ahead_whole_file_),
+  size_t offset = pos;
+  shared_ptr<void> p(ReadAheadHelper(p_, offset, n_bytes, !read_ahead_whole_file_),
     [tmp](void*) {
     // This is an empty lambda, which is a custom deleter for
     // std::shared_ptr.
@@ -188,17 +197,25 @@ shared_ptr<void> LocalFileStream::Get(size_t n_bytes) {
     // mapped creating p_ won't be unmapped
     // It will be freed, when last shared_ptr is deleted.
   });
-  pos_ += n_bytes;
   return p;
 }
 
 size_t LocalFileStream::Read(uint8_t * buffer, size_t n_bytes) {
-  n_bytes = std::min(n_bytes, length_ - pos_);
-  memcpy(buffer, ReadAheadHelper(p_, pos_, n_bytes, !read_ahead_whole_file_), n_bytes);
+  n_bytes = ReadAt(buffer, n_bytes, pos_);
   pos_ += n_bytes;
   return n_bytes;
 }
 
+size_t LocalFileStream::ReadAt(uint8_t * buffer, size_t n_bytes, int64 pos) {
+  if (pos < 0 || static_cast<size_t>(pos) >= length_) {
+    return 0;
+  }
+  size_t offset = pos;
+  n_bytes = std::min(n_bytes, length_ - offset);
+  memcpy(buffer, ReadAheadHelper(p_, offset, n_bytes, !read_ahead_whole_file_), n_bytes);
+  return n_bytes;
+}
+
 size_t LocalFileStream::Size() const {
   return length_;
 }
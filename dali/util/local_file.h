@@ -32,6 +32,8 @@ class LocalFileStream : public FileStream {
   static bool ReserveFileMappings(unsigned int num);
   static void FreeFileMappings(unsigned int num);
   size_t Read(uint8_t * buffer, size_t n_bytes) override;
+  size_t ReadAt(uint8_t * buffer, size_t n_bytes, int64 pos) override;
+  shared_ptr<void> GetAt(size_t n_bytes, int64 pos) override;
   void Seek(int64 pos) override;
   size_t Size() const override;
 
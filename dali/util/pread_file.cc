@@ -0,0 +1,167 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "dali/util/pread_file.h"
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+namespace {
+
+// Offset, size and buffer alignment required by O_DIRECT on common filesystems
+constexpr size_t kDirectAlignment = 4096;
+constexpr size_t kStagingSize = 4 << 20;
+
+inline size_t align_up(size_t x, size_t alignment) {
+  return (x + alignment - 1) & ~(alignment - 1);
+}
+
+// Reads until `n_bytes` are read or the end of file is reached
+size_t pread_all(int fd, uint8_t *buffer, size_t n_bytes, size_t offset, const string &path) {
+  size_t n_read = 0;
+  while (n_read < n_bytes) {
+    ssize_t ret = pread(fd, buffer + n_read, n_bytes - n_read, offset + n_read);
+    if (ret < 0 && errno == EINTR)
+      continue;
+    DALI_ENFORCE(ret >= 0, "Error reading from a file " + path + ": " + std::strerror(errno));
+    if (ret == 0)
+      break;
+    n_read += ret;
+  }
+  return n_read;
+}
+
+struct StagingBuffer {
+  StagingBuffer() {
+    void *p = nullptr;
+    DALI_ENFORCE(posix_memalign(&p, kDirectAlignment, kStagingSize) == 0,
+                 "Could not allocate the O_DIRECT staging buffer");
+    data = static_cast<uint8_t*>(p);
+  }
+  ~StagingBuffer() {
+    free(data);
+  }
+  uint8_t *data;
+};
+
+}  // namespace
+
+PreadFileStream::PreadFileStream(const std::string& path, bool use_o_direct) :
+  FileStream(path), fd_(-1), length_(0), pos_(0), use_o_direct_(use_o_direct) {
+  if (use_o_direct_) {
+    fd_ = open(path.c_str(), O_RDONLY | O_DIRECT);
+    if (fd_ < 0 && errno == EINVAL) {
+      // the filesystem does not support O_DIRECT (e.g. tmpfs), fall back to buffered reads
+      use_o_direct_ = false;
+    }
+  }
+  if (fd_ < 0) {
+    fd_ = open(path.c_str(), O_RDONLY);
+  }
+  DALI_ENFORCE(fd_ >= 0, "Could not open file " + path + ": " + std::strerror(errno));
+
+  struct stat s;
+  DALI_ENFORCE(fstat(fd_, &s) == 0, "Could not stat file " + path + ": " + std::strerror(errno));
+  length_ = static_cast<size_t>(s.st_size);
+}
+
+void PreadFileStream::Close() {
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+  length_ = 0;
+  pos_ = 0;
+}
+
+void PreadFileStream::Seek(int64 pos) {
+  DALI_ENFORCE(pos >= 0 && pos < (int64)length_, "Invalid seek");
+  pos_ = pos;
+}
+
+shared_ptr<void> PreadFileStream::Get(size_t n_bytes) {
+  auto p = GetAt(n_bytes, pos_);
+  if (p) {
+    pos_ += n_bytes;
+  }
+  return p;
+}
+
+shared_ptr<void> PreadFileStream::GetAt(size_t n_bytes, int64 pos) {
+  if (pos < 0 || pos + n_bytes > length_) {
+    return nullptr;
+  }
+  shared_ptr<uint8_t> p(new uint8_t[n_bytes], std::default_delete<uint8_t[]>());
+  size_t n_read = ReadAt(p.get(), n_bytes, pos);
+  DALI_ENFORCE(n_read == n_bytes, "Error reading from a file " + path_);
+  return p;
+}
+
+size_t PreadFileStream::Read(uint8_t * buffer, size_t n_bytes) {
+  size_t n_read = ReadAt(buffer, n_bytes, pos_);
+  pos_ += n_read;
+  return n_read;
+}
+
+size_t PreadFileStream::ReadAt(uint8_t * buffer, size_t n_bytes, int64 pos) {
+  if (pos < 0 || static_cast<size_t>(pos) >= length_) {
+    return 0;
+  }
+  size_t offset = pos;
+  n_bytes = std::min(n_bytes, length_ - offset);
+  return use_o_direct_ ? ReadDirect(buffer, n_bytes, offset)
+                       : pread_all(fd_, buffer, n_bytes, offset, path_);
+}
+
+size_t PreadFileStream::ReadDirect(uint8_t * buffer, size_t n_bytes, size_t pos) {
+  bool aligned = reinterpret_cast<uintptr_t>(buffer) % kDirectAlignment == 0 &&
+                 pos % kDirectAlignment == 0 &&
+                 n_bytes % kDirectAlignment == 0;
+  if (aligned) {
+    return pread_all(fd_, buffer, n_bytes, pos, path_);
+  }
+
+  static thread_local StagingBuffer staging;
+  size_t done = 0;
+  while (done < n_bytes) {
+    size_t offset = pos + done;
+    size_t aligned_offset = offset & ~(kDirectAlignment - 1);
+    size_t skip = offset - aligned_offset;
+    size_t chunk = std::min(n_bytes - done, kStagingSize - skip);
+    size_t n_read = pread_all(fd_, staging.data, align_up(skip + chunk, kDirectAlignment),
+                              aligned_offset, path_);
+    if (n_read <= skip)
+      break;
+    chunk = std::min(chunk, n_read - skip);
+    std::memcpy(buffer + done, staging.data + skip, chunk);
+    done += chunk;
+  }
+  return done;
+}
+
+size_t PreadFileStream::Size() const {
+  return length_;
+}
+
+}  // namespace dali
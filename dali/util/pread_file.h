@@ -0,0 +1,61 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_UTIL_PREAD_FILE_H_
+#define DALI_UTIL_PREAD_FILE_H_
+
+#include <cstdio>
+#include <string>
+#include <memory>
+
+#include "dali/core/common.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief FileStream that reads with positional pread calls instead of mapping the file.
+ *
+ * Reads go straight into the caller's buffer, so no page faults happen on access and
+ * one stream can serve concurrent ReadAt calls from different threads.
+ * With `use_o_direct` the page cache is bypassed; unaligned requests are then served
+ * through a per-thread aligned staging buffer.
+ */
+class PreadFileStream : public FileStream {
+ public:
+  explicit PreadFileStream(const std::string& path, bool use_o_direct);
+  void Close() override;
+  shared_ptr<void> Get(size_t n_bytes) override;
+  size_t Read(uint8_t * buffer, size_t n_bytes) override;
+  size_t ReadAt(uint8_t * buffer, size_t n_bytes, int64 pos) override;
+  shared_ptr<void> GetAt(size_t n_bytes, int64 pos) override;
+  void Seek(int64 pos) override;
+  size_t Size() const override;
+
+  ~PreadFileStream() override {
+    Close();
+  }
+
+ private:
+  size_t ReadDirect(uint8_t * buffer, size_t n_bytes, size_t pos);
+
+  int fd_;
+  size_t length_;
+  size_t pos_;
+  bool use_o_direct_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_PREAD_FILE_H_
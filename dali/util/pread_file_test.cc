@@ -0,0 +1,118 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dali/util/file.h"
+
+namespace dali {
+
+class PreadFileStreamTest : public ::testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override {
+    char name[] = "/tmp/dali_pread_test_XXXXXX";
+    int fd = mkstemp(name);
+    ASSERT_GE(fd, 0);
+    close(fd);
+    path_ = name;
+    data_.resize(3 * 4096 + 123);
+    for (size_t i = 0; i < data_.size(); i++)
+      data_[i] = static_cast<uint8_t>(i * 7 + 3);
+    std::ofstream f(path_, std::ios::binary);
+    f.write(reinterpret_cast<const char*>(data_.data()), data_.size());
+  }
+
+  void TearDown() override {
+    std::remove(path_.c_str());
+  }
+
+  std::string path_;
+  std::vector<uint8_t> data_;
+};
+
+TEST_P(PreadFileStreamTest, ReadMatchesMmap) {
+  bool use_o_direct = GetParam();
+  auto mapped = FileStream::Open(path_, false);
+  auto file = FileStream::Open(path_, false, false, use_o_direct);
+  ASSERT_EQ(file->Size(), data_.size());
+
+  for (size_t offset : {0, 1, 4096, 5000}) {
+    for (size_t size : {1, 100, 4096, 8192 + 17}) {
+      std::vector<uint8_t> expected(size), actual(size);
+      mapped->Seek(offset);
+      file->Seek(offset);
+      size_t n_expected = mapped->Read(expected.data(), size);
+      size_t n_read = file->Read(actual.data(), size);
+      ASSERT_EQ(n_read, n_expected);
+      EXPECT_EQ(expected, actual) << "offset " << offset << " size " << size;
+    }
+  }
+}
+
+TEST_P(PreadFileStreamTest, GetPastEnd) {
+  auto file = FileStream::Open(path_, false, false, GetParam());
+  file->Seek(data_.size() - 10);
+  EXPECT_EQ(file->Get(11), nullptr);
+  auto p = file->Get(10);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(0, std::memcmp(p.get(), data_.data() + data_.size() - 10, 10));
+}
+
+// Positional reads of one stream, shared by several threads, for both backends
+TEST_P(PreadFileStreamTest, ConcurrentReadAt) {
+  for (bool use_mmap : {true, false}) {
+    auto file = FileStream::Open(path_, false, use_mmap, GetParam());
+    file->Seek(100);
+    std::vector<std::thread> threads;
+    std::vector<int> errors(4, 0);
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < 100; i++) {
+          size_t offset = (t * 1237 + i * 311) % data_.size();
+          size_t size = 1 + (i * 97) % 5000;
+          std::vector<uint8_t> buf(size);
+          size_t n_read = file->ReadAt(buf.data(), size, offset);
+          size_t n_expected = std::min(size, data_.size() - offset);
+          if (n_read != n_expected ||
+              std::memcmp(buf.data(), data_.data() + offset, n_read) != 0)
+            errors[t]++;
+          auto p = file->GetAt(size, offset);
+          if ((p != nullptr) != (offset + size <= data_.size()) ||
+              (p && std::memcmp(p.get(), data_.data() + offset, size) != 0))
+            errors[t]++;
+        }
+      });
+    }
+    for (auto &t : threads)
+      t.join();
+    EXPECT_EQ(errors, std::vector<int>(4, 0)) << (use_mmap ? "mmap" : "pread");
+    // the current position is not affected
+    uint8_t byte;
+    ASSERT_EQ(file->Read(&byte, 1), 1u);
+    EXPECT_EQ(byte, data_[100]);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(PreadFileStreamTest, PreadFileStreamTest, ::testing::Values(false, true));
+
+}  // namespace dali
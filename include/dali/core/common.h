@@ -25,9 +25,11 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "dali/core/api_helper.h"
+#include "dali/core/tracing.h"
 
 namespace dali {
 
@@ -145,7 +147,7 @@ inline std::size_t NumberOfChannels(DALIImageType type) {
 #define CONCAT_2(var1, var2) CONCAT_1(var1, var2)
 #define ANONYMIZE_VARIABLE(name) CONCAT_2(name, __LINE__)
 
-// Basic timerange for profiling
+// Basic timerange for profiling, also recorded by dali::tracing when it is enabled
 struct TimeRange {
   static const uint32_t kRed = 0xFF0000;
   static const uint32_t kGreen = 0x00FF00;
@@ -174,6 +176,8 @@ struct TimeRange {
     started = true;
 
 #endif
+    if (tracing::Enabled())
+      trace_.Begin(std::move(name));
   }
 
   ~TimeRange() { stop(); }
@@ -185,13 +189,14 @@ struct TimeRange {
       nvtxRangePop();
     }
 #endif
+    trace_.End();
   }
 
-#ifdef DALI_USE_NVTX
-
  private:
+#ifdef DALI_USE_NVTX
   bool started = false;
 #endif
+  tracing::TraceScope trace_;
 };
 
 using std::to_string;
@@ -0,0 +1,62 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_CPU_FEATURES_H_
+#define DALI_CORE_CPU_FEATURES_H_
+
+// Run-time selection of x86 SIMD code paths. Functions using instruction set extensions
+// are compiled with target attributes, so the rest of the library keeps the baseline ISA,
+// and called only when the CPU supports them.
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define DALI_X86_SIMD 1
+#include <immintrin.h>
+
+#define DALI_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define DALI_TARGET_AVX2 __attribute__((target("avx2")))
+#define DALI_TARGET_AVX512 __attribute__((target("avx512f")))
+
+namespace dali {
+
+inline bool HasSSE42() {
+  static const bool has_sse42 = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+  }();
+  return has_sse42;
+}
+
+inline bool HasAVX2() {
+  static const bool has_avx2 = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return has_avx2;
+}
+
+inline bool HasAVX512F() {
+  static const bool has_avx512f = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") != 0;
+  }();
+  return has_avx512f;
+}
+
+}  // namespace dali
+
+#else
+#define DALI_X86_SIMD 0
+#endif
+
+#endif  // DALI_CORE_CPU_FEATURES_H_
@@ -0,0 +1,123 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_TRACING_H_
+#define DALI_CORE_TRACING_H_
+
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+#include "dali/core/api_helper.h"
+
+namespace dali {
+
+/**
+ * @brief Timeline of the pipeline execution, dumped in the Chrome trace event format
+ *
+ * While tracing is enabled, scopes are recorded as complete events into a buffer
+ * owned by the calling thread; recording takes no locks. The result can be loaded
+ * in chrome://tracing or Perfetto. When tracing is disabled, a scope costs a single branch.
+ */
+namespace tracing {
+
+using clock = std::chrono::steady_clock;
+
+namespace detail {
+
+DLL_PUBLIC extern std::atomic<bool> enabled;
+
+DLL_PUBLIC void RecordEvent(std::string name, clock::time_point begin, clock::time_point end);
+
+}  // namespace detail
+
+inline bool Enabled() {
+  return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Discards previously recorded events and starts recording
+ */
+DLL_PUBLIC void Start();
+
+/**
+ * @brief Stops recording; the events recorded so far are kept until the next Start()
+ */
+DLL_PUBLIC void Stop();
+
+/**
+ * @brief Writes the recorded events as Chrome trace event JSON
+ *
+ * Can be called while tracing is running - events recorded concurrently
+ * may or may not be included.
+ */
+DLL_PUBLIC void Write(std::ostream &os);
+
+DLL_PUBLIC void WriteToFile(const std::string &path);
+
+/**
+ * @brief Sets the name under which the events of the calling thread are shown
+ */
+DLL_PUBLIC void SetThreadName(const std::string &name);
+
+/**
+ * @brief Records the time between Begin() and End() (or destruction) as one event
+ */
+class TraceScope {
+ public:
+  TraceScope() = default;
+  ~TraceScope() { End(); }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+  void Begin(std::string name) {
+    name_ = std::move(name);
+    active_ = true;
+    begin_ = clock::now();
+  }
+
+  void End() {
+    if (active_) {
+      active_ = false;
+      detail::RecordEvent(std::move(name_), begin_, clock::now());
+    }
+  }
+
+ private:
+  std::string name_;
+  clock::time_point begin_;
+  bool active_ = false;
+};
+
+}  // namespace tracing
+
+#define DALI_TRACE_CONCAT_IMPL(a, b) a##b
+#define DALI_TRACE_CONCAT(a, b) DALI_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Traces the rest of the enclosing scope; `name` is only evaluated when tracing
+ *
+ * The empty `if` branch keeps an `else` following the macro from binding to it.
+ */
+#define DALI_TRACE_SCOPE(name)                                                           \
+  ::dali::tracing::TraceScope DALI_TRACE_CONCAT(trace_scope_, __LINE__);                 \
+  if (!::dali::tracing::Enabled()) {} else  /* NOLINT(readability/braces) */             \
+    DALI_TRACE_CONCAT(trace_scope_, __LINE__).Begin(name)
+
+}  // namespace dali
+
+#endif  // DALI_CORE_TRACING_H_